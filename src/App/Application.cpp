@@ -357,6 +357,8 @@ Document* Application::newDocument(const char * Name, const char * UserName)
     // add the document to the internal list
     DocMap[name] = newDoc.release(); // now owned by the Application
     _pActiveDoc = DocMap[name];
+    // expressions of other documents may refer to this document by its name
+    Document::_invalidateDependencies();
 
 
     // connect the signals to the application for the new document
@@ -410,6 +412,8 @@ bool Application::closeDocument(const char* name)
         setActiveDocument((Document*)0);
     std::unique_ptr<Document> delDoc (pos->second);
     DocMap.erase( pos );
+    // drop the cached OutLists that refer to objects of this document
+    Document::_invalidateDependencies();
 
     // Trigger observers after removing the document from the internal map.
     signalDeletedDocument();
@@ -912,6 +916,9 @@ void Application::slotBeforeChangeDocument(const App::Document& doc, const Prope
 
 void Application::slotChangedDocument(const App::Document& doc, const Property& prop)
 {
+    // expressions may refer to a document by its label
+    if (&prop == &doc.Label)
+        Document::_invalidateDependencies();
     this->signalChangedDocument(doc, prop);
 }
 
@@ -39,9 +39,6 @@ recompute path. Also enables more complicated dependencies beyond trees.
 # include <bitset>
 # include <random>
 
-#include <filesystem>
-namespace fs = std::filesystem;
-
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/subgraph.hpp>
 #include <boost/graph/graphviz.hpp>
@@ -53,6 +50,9 @@ namespace fs = std::filesystem;
 
 #include <QCoreApplication>
 #include <QCryptographicHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtConcurrentMap>
 
 #include "Document.h"
 #include "Application.h"
@@ -122,6 +122,9 @@ struct DocumentP
     int iUndoMode;
     unsigned int UndoMemSize;
     unsigned int UndoMaxStackSize;
+    QMutex undoMutex; ///< guards the undo transaction while objects are recomputed in parallel
+    std::vector<DocumentObject*> topoSortedObjects;
+    unsigned long topoSortRevision; ///< dependency revision of topoSortedObjects
 
     DocumentP() {
         activeObject = 0;
@@ -135,6 +138,7 @@ struct DocumentP
         iUndoMode = 0;
         UndoMemSize = 0;
         UndoMaxStackSize = 20;
+        topoSortRevision = 0;
     }
 
     static
@@ -148,6 +152,51 @@ struct DocumentP
 
 } // namespace App
 
+namespace {
+
+// A property change of an object that is recomputed in a worker thread. The
+// signals are emitted by the main thread after the worker has finished.
+struct DeferredChange
+{
+    DeferredChange(const DocumentObject* o, const Property* p, bool b)
+        : object(o), prop(p), before(b) { }
+
+    const DocumentObject* object;
+    const Property* prop;
+    bool before;
+};
+
+// Set while the current thread recomputes an object in parallel to others
+thread_local std::vector<DeferredChange>* deferredChanges = 0;
+
+// Changes whenever a link between objects of any document changes. It is shared
+// by all documents because expressions may refer to objects of other documents.
+unsigned long dependencyRevision = 1;
+
+// Returns true if a change of the property may change the OutList of the object
+bool isDependencyProperty(const TransactionalObject* obj, const Property* prop)
+{
+    if (prop->isDerivedFrom(PropertyLink::getClassTypeId()) ||
+        prop->isDerivedFrom(PropertyLinkSub::getClassTypeId()) ||
+        prop->isDerivedFrom(PropertyLinkList::getClassTypeId()) ||
+        prop->isDerivedFrom(PropertyLinkSubList::getClassTypeId()) ||
+        prop->isDerivedFrom(PropertyExpressionEngine::getClassTypeId()))
+        return true;
+    // expressions refer to objects by their label
+    return obj->isDerivedFrom(DocumentObject::getClassTypeId()) &&
+           prop == &static_cast<const DocumentObject*>(obj)->Label;
+}
+
+struct RecomputeTask
+{
+    DocumentObject* object;
+    bool abort;
+    std::vector<DocumentObjectExecReturn*> log;
+    std::vector<DeferredChange> changes;
+};
+
+}
+
 PROPERTY_SOURCE(App::Document, App::PropertyContainer)
 
 bool Document::testStatus(Status pos) const
@@ -885,6 +934,8 @@ void Document::removePropertyOfObject(TransactionalObject* obj, const char* name
 {
     Property* prop = obj->getDynamicPropertyByName(name);
     if (prop) {
+        if (isDependencyProperty(obj, prop))
+            _invalidateDependencies();
         if (d->activeUndoTransaction)
             d->activeUndoTransaction->removeProperty(obj, prop);
         for (auto it : mUndoTransactions)
@@ -1122,6 +1173,20 @@ void Document::onChanged(const Property* prop)
 
 void Document::onBeforeChangeProperty(const TransactionalObject *Who, const Property *What)
 {
+    if (deferredChanges) {
+        // The old value must be recorded now, only the signal can wait
+        if (Who->isDerivedFrom(App::DocumentObject::getClassTypeId()))
+            deferredChanges->push_back(DeferredChange(static_cast<const App::DocumentObject*>(Who), What, true));
+
+        QMutexLocker lock(&d->undoMutex);
+        if (d->activeUndoTransaction && !d->rollback)
+            d->activeUndoTransaction->addObjectChange(Who,What);
+        return;
+    }
+
+    if (isDependencyProperty(Who, What))
+        _invalidateDependencies();
+
     if(Who->isDerivedFrom(App::DocumentObject::getClassTypeId()))
         signalBeforeChangeObject(*static_cast<const App::DocumentObject*>(Who), *What);
 
@@ -1131,6 +1196,14 @@ void Document::onBeforeChangeProperty(const TransactionalObject *Who, const Prop
 
 void Document::onChangedProperty(const DocumentObject *Who, const Property *What)
 {
+    if (deferredChanges) {
+        deferredChanges->push_back(DeferredChange(Who, What, false));
+        return;
+    }
+
+    if (isDependencyProperty(Who, What))
+        _invalidateDependencies();
+
     signalChangedObject(*Who, *What);
 }
 
@@ -1789,11 +1862,10 @@ void Document::restore (void)
     d->objectArray.clear();
     d->objectMap.clear();
     d->activeObject = 0;
+    _invalidateDependencies();
 
-	fs::path mycurrentpath = fs::current_path();
-    fs::current_path(FileName.getValue());
-
-    Base::FileInfo fi("Document.xml");
+    // the data files are opened by their absolute path, so the working directory stays as it is
+    Base::FileInfo fi(std::string(FileName.getValue()) + "/Document.xml");
     Base::ifstream file(fi, std::ios::in | std::ios::binary);
     //#    std::streambuf* buf = file.rdbuf();
     //#    std::streamoff size = buf->pubseekoff(0, std::ios::end, std::ios::in);
@@ -1823,7 +1895,6 @@ void Document::restore (void)
     // without GUI. But if available then follow after all data files of the App document.
     signalRestoreDocument(reader);
     reader.readFiles();
-	fs::current_path(mycurrentpath);
 
     // reset all touched
     for (std::map<std::string,DocumentObject*>::iterator It= d->objectMap.begin();It!=d->objectMap.end();++It) {
@@ -2011,25 +2082,33 @@ int Document::recompute()
         topoSortedObjects = d->partialTopologicalSort(d->objectArray);
     }
 
-    for (auto objIt = topoSortedObjects.rbegin(); objIt != topoSortedObjects.rend(); ++objIt){
-        // ask the object if it should be recomputed
-        bool doRecompute = false;
-        if ((*objIt)->mustRecompute()) {
-            doRecompute = true;
-            objectCount++;
-            if (_recomputeFeature(*objIt)) {
-                // if something happened break execution of recompute
-                return -1;
-            }
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document");
+    if (hGrp->GetBool("ParallelRecompute", false)) {
+        objectCount = _recomputeInParallel(topoSortedObjects);
+        if (objectCount < 0)
+            return -1;
+    }
+    else {
+        for (auto objIt = topoSortedObjects.rbegin(); objIt != topoSortedObjects.rend(); ++objIt){
+            // ask the object if it should be recomputed
+            bool doRecompute = false;
+            if ((*objIt)->mustRecompute()) {
+                doRecompute = true;
+                objectCount++;
+                if (_recomputeFeature(*objIt)) {
+                    // if something happened break execution of recompute
+                    return -1;
+                }
 
-            signalRecomputedObject(*(*objIt));
-        }
+                signalRecomputedObject(*(*objIt));
+            }
 
-        if ((*objIt)->isTouched() || doRecompute) {
-            (*objIt)->purgeTouched();
-            // force recompute of all dependent objects
-            for (auto inObjIt : (*objIt)->getInList())
-                inObjIt->enforceRecompute();
+            if ((*objIt)->isTouched() || doRecompute) {
+                (*objIt)->purgeTouched();
+                // force recompute of all dependent objects
+                for (auto inObjIt : (*objIt)->getInList())
+                    inObjIt->enforceRecompute();
+            }
         }
     }
 
@@ -2161,8 +2240,11 @@ std::vector<App::DocumentObject*> DocumentP::topologicalSort(const std::vector<A
     // https://de.wikipedia.org/wiki/Topologische_Sortierung#Algorithmus_f.C3.BCr_das_Topologische_Sortieren
     vector < App::DocumentObject* > ret;
     ret.reserve(objects.size());
-    map < App::DocumentObject*,int > countMap;
+    std::unordered_map < App::DocumentObject*,int > countMap;
+    countMap.reserve(objects.size());
 
+    // objects whose input degree has dropped to zero
+    std::vector < App::DocumentObject* > roots;
     for (auto objectIt : objects) {
         //we need inlist with unique entries
         auto in = objectIt->getInList();
@@ -2170,35 +2252,31 @@ std::vector<App::DocumentObject*> DocumentP::topologicalSort(const std::vector<A
         in.erase(std::unique(in.begin(), in.end()), in.end());
 
         countMap[objectIt] = in.size();
+        if (in.empty())
+            roots.push_back(objectIt);
     }
 
-    auto rootObjeIt = find_if(countMap.begin(), countMap.end(), [](pair < App::DocumentObject*, int > count)->bool {
-        return count.second == 0;
-    });
-
-    if (rootObjeIt == countMap.end()){
+    if (roots.empty()){
         cerr << "DocumentP::topologicalSort: cyclic dependency detected (no root object)" << endl;
         return ret;
     }
 
-    while (rootObjeIt != countMap.end()){
-        rootObjeIt->second = rootObjeIt->second - 1;
+    std::vector < App::DocumentObject* > out;
+    while (!roots.empty()){
+        App::DocumentObject* root = roots.back();
+        roots.pop_back();
 
         //we need outlist with unique entries
-        auto out = rootObjeIt->first->getOutList();
+        out = root->_getOutList();
         std::sort(out.begin(), out.end());
         out.erase(std::unique(out.begin(), out.end()), out.end());
 
         for (auto outListIt : out) {
             auto outListMapIt = countMap.find(outListIt);
-            if (outListMapIt != countMap.end())
-                outListMapIt->second = outListMapIt->second - 1;
+            if (outListMapIt != countMap.end() && --outListMapIt->second == 0)
+                roots.push_back(outListIt);
         }
-        ret.push_back(rootObjeIt->first);
-
-        rootObjeIt = find_if(countMap.begin(), countMap.end(), [](pair < App::DocumentObject*, int > count)->bool {
-            return count.second == 0;
-        });
+        ret.push_back(root);
     }
 
     return ret;
@@ -2206,7 +2284,22 @@ std::vector<App::DocumentObject*> DocumentP::topologicalSort(const std::vector<A
 
 std::vector<App::DocumentObject*> Document::topologicalSort() const
 {
-    return d->topologicalSort(d->objectArray);
+    // the order only changes if a link or the set of objects changes
+    if (d->topoSortRevision != dependencyRevision) {
+        d->topoSortedObjects = d->topologicalSort(d->objectArray);
+        d->topoSortRevision = dependencyRevision;
+    }
+    return d->topoSortedObjects;
+}
+
+void Document::_invalidateDependencies(void)
+{
+    dependencyRevision++;
+}
+
+unsigned long Document::_getDependencyRevision(void)
+{
+    return dependencyRevision;
 }
 
 const char * Document::getErrorDescription(const App::DocumentObject*Obj) const
@@ -2219,6 +2312,12 @@ const char * Document::getErrorDescription(const App::DocumentObject*Obj) const
 
 // call the recompute of the Feature and handle the exceptions and errors.
 bool Document::_recomputeFeature(DocumentObject* Feat)
+{
+    return _recomputeFeature(Feat, _RecomputeLog);
+}
+
+// same as above but the errors are added to the given log
+bool Document::_recomputeFeature(DocumentObject* Feat, std::vector<App::DocumentObjectExecReturn*>& log)
 {
 #ifdef FC_LOGFEATUREUPDATE
     std::clog << "Solv: Executing Feature: " << Feat->getNameInDocument() << std::endl;;
@@ -2229,7 +2328,7 @@ bool Document::_recomputeFeature(DocumentObject* Feat)
         returnCode = Feat->ExpressionEngine.execute();
         if (returnCode != DocumentObject::StdReturn) {
             returnCode->Which = Feat;
-            _RecomputeLog.push_back(returnCode);
+            log.push_back(returnCode);
     #ifdef FC_DEBUG
             Base::Console().Error("Error in feature: %s\n%s\n",Feat->getNameInDocument(),returnCode->Why.c_str());
     #endif
@@ -2241,32 +2340,32 @@ bool Document::_recomputeFeature(DocumentObject* Feat)
     }
     catch(Base::AbortException &e){
         e.ReportException();
-        _RecomputeLog.push_back(new DocumentObjectExecReturn("User abort",Feat));
+        log.push_back(new DocumentObjectExecReturn("User abort",Feat));
         Feat->setError();
         return true;
     }
     catch (const Base::MemoryException& e) {
         Base::Console().Error("Memory exception in feature '%s' thrown: %s\n",Feat->getNameInDocument(),e.what());
-        _RecomputeLog.push_back(new DocumentObjectExecReturn("Out of memory exception",Feat));
+        log.push_back(new DocumentObjectExecReturn("Out of memory exception",Feat));
         Feat->setError();
         return true;
     }
     catch (Base::Exception &e) {
         e.ReportException();
-        _RecomputeLog.push_back(new DocumentObjectExecReturn(e.what(),Feat));
+        log.push_back(new DocumentObjectExecReturn(e.what(),Feat));
         Feat->setError();
         return false;
     }
     catch (std::exception &e) {
         Base::Console().Warning("exception in Feature \"%s\" thrown: %s\n",Feat->getNameInDocument(),e.what());
-        _RecomputeLog.push_back(new DocumentObjectExecReturn(e.what(),Feat));
+        log.push_back(new DocumentObjectExecReturn(e.what(),Feat));
         Feat->setError();
         return false;
     }
 #ifndef FC_DEBUG
     catch (...) {
         Base::Console().Error("App::Document::_RecomputeFeature(): Unknown exception in Feature \"%s\" thrown\n",Feat->getNameInDocument());
-        _RecomputeLog.push_back(new DocumentObjectExecReturn("Unknown exception!"));
+        log.push_back(new DocumentObjectExecReturn("Unknown exception!"));
         Feat->setError();
         return true;
     }
@@ -2278,7 +2377,7 @@ bool Document::_recomputeFeature(DocumentObject* Feat)
     }
     else {
         returnCode->Which = Feat;
-        _RecomputeLog.push_back(returnCode);
+        log.push_back(returnCode);
 #ifdef FC_DEBUG
         Base::Console().Error("Error in feature: %s\n%s\n",Feat->getNameInDocument(),returnCode->Why.c_str());
 #endif
@@ -2287,6 +2386,114 @@ bool Document::_recomputeFeature(DocumentObject* Feat)
     return false;
 }
 
+/*!
+  Recomputes the objects like the loop in recompute() does, but objects that
+  don't depend on each other are recomputed at the same time. Each object is
+  assigned to a stage after the stages of all its dependencies. The objects of
+  a stage that can be recomputed in parallel are run on the global thread pool,
+  all others one after the other in the main thread. Afterwards, the property
+  changes of the parallel objects are signaled and the dependent objects are
+  marked in the order of \a topoSortedObjects, so that observers see the same
+  sequence on every run.
+ */
+int Document::_recomputeInParallel(const std::vector<App::DocumentObject*>& topoSortedObjects)
+{
+    std::unordered_map<DocumentObject*, std::size_t> stageOf;
+    std::vector<std::vector<DocumentObject*> > stages;
+    for (auto objIt = topoSortedObjects.rbegin(); objIt != topoSortedObjects.rend(); ++objIt) {
+        std::size_t stage = 0;
+        for (auto outObj : (*objIt)->_getOutList()) {
+            auto it = stageOf.find(outObj);
+            if (it != stageOf.end())
+                stage = std::max(stage, it->second + 1);
+        }
+        stageOf[*objIt] = stage;
+        if (stages.size() <= stage)
+            stages.resize(stage + 1);
+        stages[stage].push_back(*objIt);
+    }
+
+    int objectCount = 0;
+    for (auto& stage : stages) {
+        std::vector<bool> doRecompute(stage.size(), false);
+        std::vector<RecomputeTask> tasks;
+        std::vector<int> taskOf(stage.size(), -1);
+        for (std::size_t i = 0; i < stage.size(); ++i) {
+            // ask the object if it should be recomputed
+            DocumentObject* obj = stage[i];
+            if (!obj->mustRecompute())
+                continue;
+            doRecompute[i] = true;
+            // expressions may have to access properties through Python
+            if (obj->canRecomputeInParallel() && obj->ExpressionEngine.numExpressions() == 0) {
+                RecomputeTask task;
+                task.object = obj;
+                task.abort = false;
+                taskOf[i] = static_cast<int>(tasks.size());
+                tasks.push_back(task);
+            }
+        }
+
+        if (tasks.size() > 1) {
+            // messages of the worker threads are delivered by the main thread
+            Base::Console().SetConnectionMode(Base::ConsoleSingleton::Queued);
+            QtConcurrent::blockingMap(tasks, [this](RecomputeTask& task) {
+                deferredChanges = &task.changes;
+                task.abort = _recomputeFeature(task.object, task.log);
+                deferredChanges = 0;
+            });
+            Base::Console().SetConnectionMode(Base::ConsoleSingleton::Direct);
+        }
+        else {
+            // nothing to run in parallel
+            for (auto& taskIt : taskOf)
+                taskIt = -1;
+        }
+
+        // the changes of the parallel objects are signaled even if the recompute was stopped
+        bool abort = false;
+        for (std::size_t i = 0; i < stage.size(); ++i) {
+            DocumentObject* obj = stage[i];
+            if (doRecompute[i]) {
+                objectCount++;
+                if (taskOf[i] >= 0) {
+                    RecomputeTask& task = tasks[taskOf[i]];
+                    for (auto& change : task.changes) {
+                        if (isDependencyProperty(change.object, change.prop))
+                            _invalidateDependencies();
+                        if (change.before)
+                            signalBeforeChangeObject(*change.object, *change.prop);
+                        else
+                            signalChangedObject(*change.object, *change.prop);
+                    }
+                    _RecomputeLog.insert(_RecomputeLog.end(), task.log.begin(), task.log.end());
+                    if (task.abort)
+                        abort = true;
+                }
+                else if (!abort && _recomputeFeature(obj)) {
+                    abort = true;
+                }
+
+                if (!abort)
+                    signalRecomputedObject(*obj);
+            }
+
+            if (!abort && (obj->isTouched() || doRecompute[i])) {
+                obj->purgeTouched();
+                // force recompute of all dependent objects
+                for (auto inObjIt : obj->getInList())
+                    inObjIt->enforceRecompute();
+            }
+        }
+
+        // if something happened break execution of recompute
+        if (abort)
+            return -1;
+    }
+
+    return objectCount;
+}
+
 void Document::recomputeFeature(DocumentObject* Feat)
 {
      // delete recompute log
@@ -2340,6 +2547,7 @@ DocumentObject * Document::addObject(const char* sType, const char* pObjectName,
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
     // insert in the vector
     d->objectArray.push_back(pcObject);
+    _invalidateDependencies();
     // insert in the adjacence list and reference through the ConectionMap
     //_DepConMap[pcObject] = add_vertex(_DepList);
 
@@ -2429,6 +2637,7 @@ std::vector<DocumentObject *> Document::addObjects(const char* sType, const std:
         pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
         // insert in the vector
         d->objectArray.push_back(pcObject);
+        _invalidateDependencies();
 
         pcObject->Label.setValue(ObjectName);
 
@@ -2485,6 +2694,7 @@ void Document::addObject(DocumentObject* pcObject, const char* pObjectName)
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
     // insert in the vector
     d->objectArray.push_back(pcObject);
+    _invalidateDependencies();
 
     pcObject->Label.setValue( ObjectName );
 
@@ -2505,6 +2715,7 @@ void Document::_addObject(DocumentObject* pcObject, const char* pObjectName)
     std::string ObjectName = getUniqueObjectName(pObjectName);
     d->objectMap[ObjectName] = pcObject;
     d->objectArray.push_back(pcObject);
+    _invalidateDependencies();
     // cache the pointer to the name string in the Object (for performance of DocumentObject::getNameInDocument())
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
 
@@ -2590,6 +2801,7 @@ void Document::removeObject(const char* sName)
             break;
         }
     }
+    _invalidateDependencies();
 
     pos->second->setStatus(ObjectStatus::Remove, false); // Unset the bit to be on the safe side
     d->objectMap.erase(pos);
@@ -2642,6 +2854,7 @@ void Document::_removeObject(DocumentObject* pcObject)
             break;
         }
     }
+    _invalidateDependencies();
 
     // for a rollback delete the object
     if (d->rollback) {
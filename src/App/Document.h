@@ -380,10 +380,21 @@ protected:
     /// helper which Recompute only this feature
     /// @return True if the recompute process of the Document shall be stopped, False if it shall be continued.
     bool _recomputeFeature(DocumentObject* Feat);
+    bool _recomputeFeature(DocumentObject* Feat, std::vector<App::DocumentObjectExecReturn*>& log);
+    /// recompute the objects in dependency order, independent objects in parallel
+    /// @return The number of recomputed objects or -1 if the recompute was stopped
+    int _recomputeInParallel(const std::vector<App::DocumentObject*>& topoSortedObjects);
     void _clearRedos();
 
     /// refresh the internal dependency graph
     void _rebuildDependencyList(void);
+    /// mark the cached OutLists and the topological orders of all documents as outdated
+    static void _invalidateDependencies(void);
+    /** The revision changes whenever a link between objects, the set of objects
+     * or the set of documents changes. It is shared by all documents because an
+     * expression may refer to an object of another document.
+     */
+    static unsigned long _getDependencyRevision(void);
     std::string getTransientDirectoryName(const std::string& uuid, const std::string& filename) const;
 
 
@@ -33,7 +33,7 @@ DocumentObjectExecReturn *DocumentObject::StdReturn = 0;
 //===========================================================================
 
 DocumentObject::DocumentObject(void)
-    : ExpressionEngine(),_pDoc(0),pcNameInDocument(0)
+    : ExpressionEngine(),_pDoc(0),pcNameInDocument(0),_outListRevision(0)
 {
     // define Label of type 'Output' to avoid being marked as touched after relabeling
     ADD_PROPERTY_TYPE(Label,("Unnamed"),"Base",Prop_Output,"User name of the object (UTF8)");
@@ -190,8 +190,18 @@ const char* DocumentObject::detachFromDocument()
 
 std::vector<DocumentObject*> DocumentObject::getOutList(void) const
 {
+    return _getOutList();
+}
+
+const std::vector<DocumentObject*>& DocumentObject::_getOutList(void) const
+{
+    // an object outside of a document isn't notified about changes of its links
+    if (_pDoc && _outListRevision == _pDoc->_getDependencyRevision())
+        return _outList;
+
     std::vector<Property*> List;
-    std::vector<DocumentObject*> ret;
+    std::vector<DocumentObject*>& ret = _outList;
+    ret.clear();
     getPropertyList(List);
     for (std::vector<Property*>::const_iterator It = List.begin();It != List.end(); ++It) {
         if ((*It)->isDerivedFrom(PropertyLinkList::getClassTypeId())) {
@@ -221,6 +231,7 @@ std::vector<DocumentObject*> DocumentObject::getOutList(void) const
     // Get document objects that this document object relies on
     ExpressionEngine.getDocumentObjectDeps(ret);
 
+    _outListRevision = _pDoc ? _pDoc->_getDependencyRevision() : 0;
     return ret;
 }
 
@@ -264,62 +275,48 @@ std::vector<App::DocumentObject*> DocumentObject::getInList(void) const {
   return _inList;
 }
 
-void _getInListRecursive(std::set<DocumentObject*>& objSet,
-                         const DocumentObject* obj,
-                         const DocumentObject* checkObj, int depth)
-{
-    for (const auto objIt : obj->getInList()) {
-        // if the check object is in the recursive inList we have a cycle!
-        if (objIt == checkObj || depth <= 0) {
-            throw Base::BadGraphError("DocumentObject::getInListRecursive(): cyclic dependency detected!");
-        }
-
-        // if the element was already in the set then there is no need to process it again
-        auto pair = objSet.insert(objIt);
-        if (pair.second)
-            _getInListRecursive(objSet, objIt, checkObj, depth-1);
-    }
-}
-
 std::vector<App::DocumentObject*> DocumentObject::getInListRecursive(void) const
 {
-    // number of objects in document is a good estimate in result size
-    int maxDepth = getDocument()->countObjects() + 2;
     std::set<App::DocumentObject*> result;
-
-    // using a rcursie helper to collect all InLists
-    _getInListRecursive(result, this, this, maxDepth);
+    std::vector<const App::DocumentObject*> todo;
+    todo.push_back(this);
+
+    // walk the InLists with an explicit stack, each object is only expanded once
+    while (!todo.empty()) {
+        const App::DocumentObject* obj = todo.back();
+        todo.pop_back();
+        for (const auto objIt : obj->_inList) {
+            // if the check object is in the recursive inList we have a cycle!
+            if (objIt == this)
+                throw Base::BadGraphError("DocumentObject::getInListRecursive(): cyclic dependency detected!");
+            if (result.insert(objIt).second)
+                todo.push_back(objIt);
+        }
+    }
 
     std::vector<App::DocumentObject*> array;
     array.insert(array.begin(), result.begin(), result.end());
     return array;
 }
 
-void _getOutListRecursive(std::set<DocumentObject*>& objSet,
-                          const DocumentObject* obj,
-                          const DocumentObject* checkObj, int depth)
-{
-    for (const auto objIt : obj->getOutList()) {
-        // if the check object is in the recursive inList we have a cycle!
-        if (objIt == checkObj || depth <= 0) {
-            throw Base::BadGraphError("DocumentObject::getOutListRecursive(): cyclic dependency detected!");
-        }
-
-        // if the element was already in the set then there is no need to process it again
-        auto pair = objSet.insert(objIt);
-        if (pair.second)
-            _getOutListRecursive(objSet, objIt, checkObj, depth-1);
-    }
-}
-
 std::vector<App::DocumentObject*> DocumentObject::getOutListRecursive(void) const
 {
-    // number of objects in document is a good estimate in result size
-    int maxDepth = getDocument()->countObjects() + 2;
     std::set<App::DocumentObject*> result;
-
-    // using a recursive helper to collect all OutLists
-    _getOutListRecursive(result, this, this, maxDepth);
+    std::vector<const App::DocumentObject*> todo;
+    todo.push_back(this);
+
+    // walk the OutLists with an explicit stack, each object is only expanded once
+    while (!todo.empty()) {
+        const App::DocumentObject* obj = todo.back();
+        todo.pop_back();
+        for (const auto objIt : obj->_getOutList()) {
+            // if the check object is in the recursive outList we have a cycle!
+            if (objIt == this)
+                throw Base::BadGraphError("DocumentObject::getOutListRecursive(): cyclic dependency detected!");
+            if (result.insert(objIt).second)
+                todo.push_back(objIt);
+        }
+    }
 
     std::vector<App::DocumentObject*> array;
     array.insert(array.begin(), result.begin(), result.end());
@@ -362,7 +359,7 @@ bool DocumentObject::isInInList(DocumentObject *linkTo) const
 bool _isInOutListRecursive(const DocumentObject* act,
                            const DocumentObject* checkObj, int depth)
 {
-    for (auto obj : act->getOutList()) {
+    for (auto obj : act->_getOutList()) {
         if (obj == checkObj)
             return true;
         // if we reach the depth limit we have a cycle!
@@ -440,6 +437,8 @@ App::Document *DocumentObject::getDocument(void) const
 void DocumentObject::setDocument(App::Document* doc)
 {
     _pDoc=doc;
+    // the revisions of different documents are not comparable
+    _outListRevision = 0;
     onSettingDocument();
 }
 
@@ -640,6 +639,8 @@ void App::DocumentObject::_removeBackLink(DocumentObject* rmvObj)
     auto it = std::find(_inList.begin(), _inList.end(), rmvObj);
     if(it != _inList.end())
         _inList.erase(it);
+    if (_pDoc)
+        _pDoc->_invalidateDependencies();
 }
 
 void App::DocumentObject::_addBackLink(DocumentObject* newObj)
@@ -649,4 +650,6 @@ void App::DocumentObject::_addBackLink(DocumentObject* newObj)
     //this removal would clear the object from the inlist, even though there may be other link properties 
     //from this object that link to us.
     _inList.push_back(newObj);
+    if (_pDoc)
+        _pDoc->_invalidateDependencies();
 }
@@ -153,6 +153,8 @@ public:
     void _removeBackLink(DocumentObject*);
     /// internal, used by PropertyLink to maintain DAG back links
     void _addBackLink(DocumentObject*);
+    /// internal, returns the cached OutList which is only valid until the next change of a link
+    const std::vector<App::DocumentObject*>& _getOutList(void) const;
     //@}
 
     /**
@@ -184,6 +186,18 @@ public:
      */
     virtual short mustExecute(void) const;
 
+    /** canRecomputeInParallel
+     *  Returns true if execute() may run in a worker thread while other
+     *  objects of the document are recomputed. This is only allowed if
+     *  execute() doesn't use Python, global state or the GUI, only changes
+     *  properties of this object and only reads objects it links to. The
+     *  linked objects are safe to read because they are always recomputed
+     *  in an earlier stage. The default is false.
+     *
+     * @see Document::recompute()
+     */
+    virtual bool canRecomputeInParallel(void) const { return false; }
+
     /// Recompute only this feature
     bool recomputeFeature();
 
@@ -289,6 +303,9 @@ private:
     // Back pointer to all the fathers in a DAG of the document
     // this is used by the document (via friend) to have a effective DAG handling
     std::vector<App::DocumentObject*> _inList;
+    // The OutList is collected again only if the dependency revision of the document has changed
+    mutable std::vector<App::DocumentObject*> _outList;
+    mutable unsigned long _outListRevision;
 };
 
 } //namespace App
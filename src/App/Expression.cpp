@@ -320,8 +320,6 @@ Expression * OperatorExpression::eval() const
     NumberExpression * v1;
     std::unique_ptr<Expression> e2(right->eval());
     NumberExpression * v2;
-    Expression * output;
-    const double epsilon = std::numeric_limits<double>::epsilon();
 
     v1 = freecad_dynamic_cast<NumberExpression>(e1.get());
     v2 = freecad_dynamic_cast<NumberExpression>(e2.get());
@@ -329,71 +327,82 @@ Expression * OperatorExpression::eval() const
     if (v1 == 0 || v2 == 0)
         throw ExpressionError("Invalid expression");
 
+    Quantity result = evaluate(op, v1->getQuantity(), v2->getQuantity());
+
+    switch (op) {
+    case EQ:
+    case NEQ:
+    case LT:
+    case GT:
+    case LTE:
+    case GTE:
+        return new BooleanExpression(owner, result.getValue() > 0.5);
+    default:
+        return new NumberExpression(owner, result);
+    }
+}
+
+/**
+  * Apply the operator \a op to the values \a v1 and \a v2. Comparisons return
+  * 1 or 0. Throws an ExpressionError exception if the units don't match.
+  *
+  * @returns The result of the operation.
+  */
+
+Quantity OperatorExpression::evaluate(Operator op, const Quantity & v1, const Quantity & v2)
+{
+    const double epsilon = std::numeric_limits<double>::epsilon();
+
     switch (op) {
     case ADD:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for + operator");
-        output = new NumberExpression(owner, v1->getQuantity() + v2->getQuantity());
-        break;
+        return v1 + v2;
     case SUB:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for - operator");
-        output = new NumberExpression(owner, v1->getQuantity()- v2->getQuantity());
-        break;
+        return v1 - v2;
     case MUL:
     case UNIT:
-        output = new NumberExpression(owner, v1->getQuantity() * v2->getQuantity());
-        break;
+        return v1 * v2;
     case DIV:
-        output = new NumberExpression(owner, v1->getQuantity() / v2->getQuantity());
-        break;
+        return v1 / v2;
     case POW:
-        output = new NumberExpression(owner, v1->getQuantity().pow(v2->getQuantity()) );
-        break;
+        return v1.pow(v2);
     case EQ:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the = operator");
-        output = new BooleanExpression(owner, essentiallyEqual(v1->getValue(), v2->getValue(), epsilon) );
-        break;
+        return Quantity(essentiallyEqual(v1.getValue(), v2.getValue(), epsilon) ? 1.0 : 0.0);
     case NEQ:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the != operator");
-        output = new BooleanExpression(owner, !essentiallyEqual(v1->getValue(), v2->getValue(), epsilon) );
-        break;
+        return Quantity(!essentiallyEqual(v1.getValue(), v2.getValue(), epsilon) ? 1.0 : 0.0);
     case LT:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the < operator");
-        output = new BooleanExpression(owner, definitelyLessThan(v1->getValue(), v2->getValue(), epsilon) );
-        break;
+        return Quantity(definitelyLessThan(v1.getValue(), v2.getValue(), epsilon) ? 1.0 : 0.0);
     case GT:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the > operator");
-        output = new BooleanExpression(owner, definitelyGreaterThan(v1->getValue(), v2->getValue(), epsilon) );
-        break;
+        return Quantity(definitelyGreaterThan(v1.getValue(), v2.getValue(), epsilon) ? 1.0 : 0.0);
     case LTE:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the <= operator");
-        output = new BooleanExpression(owner, definitelyLessThan(v1->getValue(), v2->getValue(), epsilon) ||
-                                       essentiallyEqual(v1->getValue(), v2->getValue(), epsilon));
-        break;
+        return Quantity(definitelyLessThan(v1.getValue(), v2.getValue(), epsilon) ||
+                        essentiallyEqual(v1.getValue(), v2.getValue(), epsilon) ? 1.0 : 0.0);
     case GTE:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the >= operator");
-        output = new BooleanExpression(owner, essentiallyEqual(v1->getValue(), v2->getValue(), epsilon) ||
-                                       definitelyGreaterThan(v1->getValue(), v2->getValue(), epsilon));
-        break;
+        return Quantity(essentiallyEqual(v1.getValue(), v2.getValue(), epsilon) ||
+                        definitelyGreaterThan(v1.getValue(), v2.getValue(), epsilon) ? 1.0 : 0.0);
     case NEG:
-        output = new NumberExpression(owner, -v1->getQuantity() );
-        break;
+        return -v1;
     case POS:
-        output = new NumberExpression(owner, v1->getQuantity() );
-        break;
+        return v1;
     default:
-        output = 0;
         assert(0);
+        return Quantity();
     }
-
-    return output;
 }
 
 /**
@@ -904,6 +913,24 @@ Expression * FunctionExpression::eval() const
     NumberExpression * v1 = freecad_dynamic_cast<NumberExpression>(e1.get());
     NumberExpression * v2 = freecad_dynamic_cast<NumberExpression>(e2.get());
     NumberExpression * v3 = freecad_dynamic_cast<NumberExpression>(e3.get());
+
+    return new NumberExpression(owner, evaluate(f, v1 ? &v1->getQuantity() : 0,
+                                                   v2 ? &v2->getQuantity() : 0,
+                                                   v3 ? &v3->getQuantity() : 0, args.size()));
+}
+
+/**
+  * Apply the non-aggregate function \a f to the values \a v1, \a v2 and \a v3.
+  * A null pointer stands for a missing argument or one that is not a number,
+  * \a numArgs is the number of arguments given to the function.
+  * Throws an ExpressionError exception if something fails.
+  *
+  * @returns The result of the function.
+  */
+
+Quantity FunctionExpression::evaluate(Function f, const Quantity * v1, const Quantity * v2,
+                                      const Quantity * v3, std::size_t numArgs)
+{
     double output;
     Unit unit;
     double scaler = 1;
@@ -1013,7 +1040,7 @@ Expression * FunctionExpression::eval() const
         if (v1->getUnit() != v2->getUnit())
             throw ExpressionError("Units must be equal");
 
-        if (args.size() > 2) {
+        if (numArgs > 2) {
             if (v3 == 0)
                 throw ExpressionError("Invalid second argument.");
             if (v2->getUnit() != v3->getUnit())
@@ -1106,7 +1133,7 @@ Expression * FunctionExpression::eval() const
         assert(0);
     }
 
-    return new NumberExpression(owner, Quantity(scaler * output, unit));
+    return Quantity(scaler * output, unit);
 }
 
 /**
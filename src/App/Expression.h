@@ -236,6 +236,8 @@ public:
 
     Expression * getRight() const { return right; }
 
+    static Base::Quantity evaluate(Operator op, const Base::Quantity & v1, const Base::Quantity & v2);
+
 protected:
 
     virtual bool isCommutative() const;
@@ -272,6 +274,12 @@ public:
 
     virtual void visit(ExpressionVisitor & v);
 
+    Expression * getCondition() const { return condition; }
+
+    Expression * getTrueExpression() const { return trueExpr; }
+
+    Expression * getFalseExpression() const { return falseExpr; }
+
 protected:
 
     Expression * condition;  /**< Condition */
@@ -349,6 +357,13 @@ public:
 
     virtual void visit(ExpressionVisitor & v);
 
+    Function getFunction() const { return f; }
+
+    const std::vector<Expression*> & getArgs() const { return args; }
+
+    static Base::Quantity evaluate(Function f, const Base::Quantity * v1, const Base::Quantity * v2,
+                                   const Base::Quantity * v3, std::size_t numArgs);
+
 protected:
     Expression *evalAggregate() const;
 
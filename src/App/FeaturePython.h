@@ -80,6 +80,10 @@ public:
         }
         return DocumentObject::StdReturn;
     }
+    /// Python code needs the interpreter lock, so it's never recomputed in parallel
+    virtual bool canRecomputeInParallel(void) const {
+        return false;
+    }
     /// returns the type name of the ViewProvider
     virtual const char* getViewProviderName(void) const {
         return FeatureT::getViewProviderName();
@@ -18,6 +18,8 @@
 #include <boost/bind/bind.hpp>
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/adjacency_list.hpp>
+#include <cmath>
+#include <memory>
 
 
 using namespace App;
@@ -63,6 +65,8 @@ PropertyExpressionEngine::PropertyExpressionEngine()
     , AtomicPropertyChangeInterface()
     , running(false)
     , validator(0)
+    , compiledExpressionsValid(false)
+    , compiledObjectCount(0)
 {
 }
 
@@ -151,6 +155,7 @@ void PropertyExpressionEngine::Paste(const Property &from)
     }
 
     validator = fromee->validator;
+    invalidateCompiledExpressions();
 }
 
 void PropertyExpressionEngine::Save(Base::Writer &writer) const
@@ -292,6 +297,9 @@ void PropertyExpressionEngine::slotObjectRenamed(const DocumentObject &obj)
     std::clog << "Object " << obj.getOldLabel() << " renamed to " << obj.Label.getValue() << std::endl;
 #endif
 
+    // References by label may resolve to a different object now
+    invalidateCompiledExpressions();
+
     DocumentObject * docObj = freecad_dynamic_cast<DocumentObject>(getContainer());
 
     /* In a document object, and on undo stack? */
@@ -312,6 +320,9 @@ void PropertyExpressionEngine::slotObjectRenamed(const DocumentObject &obj)
 
 void PropertyExpressionEngine::slotObjectDeleted(const DocumentObject &obj)
 {
+    // Don't keep handles to the properties of the deleted object
+    invalidateCompiledExpressions();
+
     DocumentObject * docObj = freecad_dynamic_cast<DocumentObject>(getContainer());
 
     /* In a document object, and on undo stack? */
@@ -424,6 +435,7 @@ void PropertyExpressionEngine::setValue(const ObjectIdentifier & path, boost::sh
                 ++j;
             }
         }
+        invalidateCompiledExpressions();
         expressionChanged(usePath);
     }
     else {
@@ -449,6 +461,7 @@ void PropertyExpressionEngine::setValue(const ObjectIdentifier & path, boost::sh
         }
 
         expressions.erase(usePath);
+        invalidateCompiledExpressions();
         expressionChanged(usePath);
     }
 }
@@ -535,6 +548,353 @@ std::vector<App::ObjectIdentifier> PropertyExpressionEngine::computeEvaluationOr
     return evaluationOrder;
 }
 
+/*
+ * The classes below are a compiled form of an expression tree. Constant
+ * subtrees are folded into a single value, and variables keep a handle to the
+ * property they resolve to, so that they don't have to search the document
+ * for the referenced object on each evaluation. Nodes without a compiled form,
+ * e.g. aggregates, are evaluated by the expression tree itself.
+ */
+
+namespace {
+
+class CompiledNode
+{
+public:
+    virtual ~CompiledNode() { }
+
+    /**
+     * @brief Evaluate the node.
+     * @param value Result of the evaluation
+     * @return False if the result is not a number, e.g. a string.
+     */
+    virtual bool eval(Quantity & value) const = 0;
+
+    virtual bool isConstant() const { return false; }
+};
+
+typedef std::unique_ptr<CompiledNode> CompiledNodePtr;
+
+class ConstantNode : public CompiledNode
+{
+public:
+    ConstantNode(const Quantity & _quantity) : quantity(_quantity) { }
+
+    bool eval(Quantity & value) const {
+        value = quantity;
+        return true;
+    }
+
+    bool isConstant() const { return true; }
+
+private:
+    Quantity quantity;
+};
+
+class FallbackNode : public CompiledNode
+{
+public:
+    FallbackNode(const Expression * _expr) : expr(_expr) { }
+
+    bool eval(Quantity & value) const {
+        std::unique_ptr<Expression> e(expr->eval());
+        NumberExpression * v = freecad_dynamic_cast<NumberExpression>(e.get());
+
+        if (v == 0)
+            return false;
+        value = v->getQuantity();
+        return true;
+    }
+
+private:
+    const Expression * expr;
+};
+
+class VariableNode : public CompiledNode
+{
+public:
+    enum Kind {
+        QuantityValue,
+        FloatValue,
+        IntegerValue,
+        BoolValue
+    };
+
+    VariableNode(const VariableExpression * _expr, const DocumentObject * _object, const Property * _prop, Kind _kind)
+        : expr(_expr), object(_object), prop(_prop), type(_prop->getTypeId()), name(_prop->getName()), kind(_kind) { }
+
+    bool eval(Quantity & value) const {
+        // A dynamic property may have been removed in the meantime
+        if (object->getPropertyByName(name.c_str()) != prop || prop->getTypeId() != type)
+            return FallbackNode(expr).eval(value);
+
+        switch (kind) {
+        case QuantityValue:
+            value = Quantity(static_cast<const PropertyQuantity*>(prop)->getValue(),
+                             static_cast<const PropertyQuantity*>(prop)->getUnit());
+            break;
+        case FloatValue:
+            value = Quantity(static_cast<const PropertyFloat*>(prop)->getValue());
+            break;
+        case IntegerValue:
+            value = Quantity(static_cast<const PropertyInteger*>(prop)->getValue());
+            break;
+        case BoolValue:
+            value = Quantity(static_cast<const PropertyBool*>(prop)->getValue() ? 1.0 : 0.0);
+            break;
+        }
+        return true;
+    }
+
+private:
+    const VariableExpression * expr;
+    const DocumentObject * object;
+    const Property * prop;
+    Base::Type type;
+    std::string name;
+    Kind kind;
+};
+
+class OperatorNode : public CompiledNode
+{
+public:
+    OperatorNode(OperatorExpression::Operator _op, CompiledNodePtr _left, CompiledNodePtr _right)
+        : op(_op), left(std::move(_left)), right(std::move(_right)) { }
+
+    bool eval(Quantity & value) const {
+        Quantity v1, v2;
+        bool isNumber1 = left->eval(v1);
+        bool isNumber2 = right->eval(v2);
+
+        if (!isNumber1 || !isNumber2)
+            throw ExpressionError("Invalid expression");
+        value = OperatorExpression::evaluate(op, v1, v2);
+        return true;
+    }
+
+    bool isConstant() const { return left->isConstant() && right->isConstant(); }
+
+private:
+    OperatorExpression::Operator op;
+    CompiledNodePtr left;
+    CompiledNodePtr right;
+};
+
+class FunctionNode : public CompiledNode
+{
+public:
+    FunctionNode(FunctionExpression::Function _f, std::vector<CompiledNodePtr> & _args, std::size_t _numArgs)
+        : f(_f), args(std::move(_args)), numArgs(_numArgs) { }
+
+    bool eval(Quantity & value) const {
+        Quantity v[3];
+        bool isNumber[3] = { false, false, false };
+
+        for (std::size_t i = 0; i < args.size(); ++i)
+            isNumber[i] = args[i]->eval(v[i]);
+        value = FunctionExpression::evaluate(f, isNumber[0] ? &v[0] : 0, isNumber[1] ? &v[1] : 0,
+                                             isNumber[2] ? &v[2] : 0, numArgs);
+        return true;
+    }
+
+    bool isConstant() const {
+        for (std::vector<CompiledNodePtr>::const_iterator it = args.begin(); it != args.end(); ++it) {
+            if (!(*it)->isConstant())
+                return false;
+        }
+        return true;
+    }
+
+private:
+    FunctionExpression::Function f;
+    std::vector<CompiledNodePtr> args; /**< The arguments that are used, i.e. at most three */
+    std::size_t numArgs;
+};
+
+class ConditionalNode : public CompiledNode
+{
+public:
+    ConditionalNode(CompiledNodePtr _condition, CompiledNodePtr _trueNode, CompiledNodePtr _falseNode)
+        : condition(std::move(_condition)), trueNode(std::move(_trueNode)), falseNode(std::move(_falseNode)) { }
+
+    bool eval(Quantity & value) const {
+        Quantity v;
+
+        if (!condition->eval(v))
+            throw ExpressionError("Invalid expression");
+        if (fabs(v.getValue()) > 0.5)
+            return trueNode->eval(value);
+        else
+            return falseNode->eval(value);
+    }
+
+private:
+    CompiledNodePtr condition;
+    CompiledNodePtr trueNode;
+    CompiledNodePtr falseNode;
+};
+
+/**
+ * @brief Replace \a node by its value if it only depends on constants.
+ */
+
+CompiledNodePtr foldConstant(CompiledNodePtr node)
+{
+    if (node->isConstant()) {
+        try {
+            Quantity value;
+
+            if (node->eval(value))
+                return CompiledNodePtr(new ConstantNode(value));
+        }
+        catch (const Base::Exception &) {
+            // Keep the node; the error is reported when it is evaluated
+        }
+    }
+    return node;
+}
+
+/**
+ * @brief Compile the expression tree \a expr.
+ * @param expr Expression to compile; it must outlive the compiled form
+ * @param doc Document of the expression's owner; only properties of its objects are cached
+ * @return The compiled expression.
+ */
+
+CompiledNodePtr compileExpression(const Expression * expr, const Document * doc)
+{
+    if (const OperatorExpression * e = freecad_dynamic_cast<OperatorExpression>(expr)) {
+        return foldConstant(CompiledNodePtr(new OperatorNode(e->getOperator(),
+                                                             compileExpression(e->getLeft(), doc),
+                                                             compileExpression(e->getRight(), doc))));
+    }
+    else if (const FunctionExpression * e = freecad_dynamic_cast<FunctionExpression>(expr)) {
+        const std::vector<Expression*> & args = e->getArgs();
+
+        if (e->getFunction() > FunctionExpression::AGGREGATES || args.empty())
+            return CompiledNodePtr(new FallbackNode(expr));
+
+        // Only the first three arguments are evaluated
+        std::vector<CompiledNodePtr> compiledArgs;
+        for (std::size_t i = 0; i < args.size() && i < 3; ++i)
+            compiledArgs.push_back(compileExpression(args[i], doc));
+        return foldConstant(CompiledNodePtr(new FunctionNode(e->getFunction(), compiledArgs, args.size())));
+    }
+    else if (const ConditionalExpression * e = freecad_dynamic_cast<ConditionalExpression>(expr)) {
+        CompiledNodePtr condition(compileExpression(e->getCondition(), doc));
+
+        // Constant condition? Then only the selected branch is needed
+        if (condition->isConstant()) {
+            try {
+                Quantity value;
+
+                if (condition->eval(value))
+                    return compileExpression(fabs(value.getValue()) > 0.5 ? e->getTrueExpression() : e->getFalseExpression(), doc);
+            }
+            catch (const Base::Exception &) {
+                // Keep the condition; the error is reported when it is evaluated
+            }
+        }
+        return CompiledNodePtr(new ConditionalNode(std::move(condition),
+                                                   compileExpression(e->getTrueExpression(), doc),
+                                                   compileExpression(e->getFalseExpression(), doc)));
+    }
+    else if (const VariableExpression * e = freecad_dynamic_cast<VariableExpression>(expr)) {
+        ObjectIdentifier path(e->getPath());
+        const Property * prop = path.getProperty();
+        const DocumentObject * obj = prop ? freecad_dynamic_cast<DocumentObject>(prop->getContainer()) : 0;
+
+        // Renaming and deletion are only tracked for objects of the same document.
+        // Paths with sub components, e.g. Placement.Base.x, are read by the property itself.
+        if (doc && obj && obj->getDocument() == doc &&
+                path.numSubComponents() == 1 && path.getPropertyComponent(0).isSimple()) {
+            if (prop->isDerivedFrom(PropertyQuantity::getClassTypeId()))
+                return CompiledNodePtr(new VariableNode(e, obj, prop, VariableNode::QuantityValue));
+            else if (prop->isDerivedFrom(PropertyFloat::getClassTypeId()))
+                return CompiledNodePtr(new VariableNode(e, obj, prop, VariableNode::FloatValue));
+            else if (prop->isDerivedFrom(PropertyInteger::getClassTypeId()))
+                return CompiledNodePtr(new VariableNode(e, obj, prop, VariableNode::IntegerValue));
+            else if (prop->isDerivedFrom(PropertyBool::getClassTypeId()))
+                return CompiledNodePtr(new VariableNode(e, obj, prop, VariableNode::BoolValue));
+        }
+        return CompiledNodePtr(new FallbackNode(expr));
+    }
+    else if (freecad_dynamic_cast<NumberExpression>(expr) || expr->getTypeId() == UnitExpression::getClassTypeId()) {
+        return CompiledNodePtr(new ConstantNode(static_cast<const UnitExpression*>(expr)->getQuantity()));
+    }
+
+    return CompiledNodePtr(new FallbackNode(expr));
+}
+
+}
+
+/**
+ * @brief An expression prepared for evaluation in execute().
+ */
+
+struct PropertyExpressionEngine::CompiledExpression {
+    ObjectIdentifier path; /**< Path to the property that is set */
+    Property * property; /**< The property the path resolved to when compiling, or null */
+    std::string propertyName; /**< Name of the cached property */
+    boost::shared_ptr<Expression> expression; /**< The expression tree, referenced by the compiled form */
+    CompiledNodePtr root; /**< Compiled form of the expression */
+};
+
+/**
+ * @brief Compute the evaluation order and compile all expressions.
+ *
+ * The result is kept until the expressions are changed, or an object is
+ * renamed, added or deleted.
+ */
+
+void PropertyExpressionEngine::compileExpressions()
+{
+    DocumentObject * docObj = freecad_dynamic_cast<DocumentObject>(getContainer());
+    const Document * doc = docObj ? docObj->getDocument() : 0;
+
+    compiledExpressions.clear();
+    compiledExpressionsValid = false;
+
+    std::vector<App::ObjectIdentifier> evaluationOrder = computeEvaluationOrder();
+    bool resolved = true;
+
+    for (std::vector<ObjectIdentifier>::const_iterator it = evaluationOrder.begin(); it != evaluationOrder.end(); ++it) {
+        boost::shared_ptr<CompiledExpression> compiled(new CompiledExpression);
+
+        compiled->path = *it;
+        compiled->property = it->getProperty();
+        if (compiled->property)
+            compiled->propertyName = compiled->property->getName();
+        compiled->expression = expressions[*it].expression;
+        compiled->root = compileExpression(compiled->expression.get(), doc);
+
+        // The evaluation order misses the dependencies that don't resolve yet
+        std::set<ObjectIdentifier> deps;
+        compiled->expression->getDeps(deps);
+        for (std::set<ObjectIdentifier>::const_iterator j = deps.begin(); j != deps.end(); ++j) {
+            if (!j->getProperty())
+                resolved = false;
+        }
+
+        compiledExpressions.push_back(compiled);
+    }
+
+    if (doc && resolved) {
+        compiledExpressionsValid = true;
+        compiledObjectCount = doc->countObjects();
+    }
+}
+
+/**
+ * @brief Discard the evaluation order and the compiled expressions.
+ */
+
+void PropertyExpressionEngine::invalidateCompiledExpressions()
+{
+    compiledExpressionsValid = false;
+    compiledExpressions.clear();
+}
+
 /**
  * @brief Compute and update values of all registered expressions.
  * @return StdReturn on success.
@@ -565,19 +925,27 @@ DocumentObjectExecReturn *App::PropertyExpressionEngine::execute()
 
     resetter r(running);
 
-    // Compute evaluation order
-    std::vector<App::ObjectIdentifier> evaluationOrder = computeEvaluationOrder();
-    std::vector<ObjectIdentifier>::const_iterator it = evaluationOrder.begin();
+    // Compute evaluation order and compile the expressions, unless nothing changed since the last time
+    if (!compiledExpressionsValid || compiledObjectCount != docObj->getDocument()->countObjects())
+        compileExpressions();
+
+    // Keep the compiled expressions alive, even if an expression is changed while evaluating
+    std::vector<boost::shared_ptr<CompiledExpression> > compiled = compiledExpressions;
+    std::vector<boost::shared_ptr<CompiledExpression> >::const_iterator it = compiled.begin();
 
 #ifdef FC_PROPERTYEXPRESSIONENGINE_LOG
     std::clog << "Computing expressions for " << getName() << std::endl;
 #endif
 
     /* Evaluate the expressions, and update properties */
-    while (it != evaluationOrder.end()) {
+    while (it != compiled.end()) {
+        const CompiledExpression & c = **it;
 
-        // Get property to update
-        Property * prop = it->getProperty();
+        // Get property to update; the cached one may have been removed if it was a dynamic property
+        Property * prop = c.property;
+
+        if (!prop || docObj->getPropertyByName(c.propertyName.c_str()) != prop)
+            prop = c.path.getProperty();
 
         if (!prop)
             throw Base::RuntimeError("Path does not resolve to a property.");
@@ -589,13 +957,18 @@ DocumentObjectExecReturn *App::PropertyExpressionEngine::execute()
             throw Base::RuntimeError("Invalid property owner.");
 
         // Evaluate expression
-        std::unique_ptr<Expression> e(expressions[*it].expression->eval());
+        boost::any value;
+        Base::Quantity q;
+
+        if (c.root->eval(q))
+            value = q.getUnit().isEmpty() ? boost::any(q.getValue()) : boost::any(q);
+        else {
+            std::unique_ptr<Expression> e(c.expression->eval());
+            value = e->getValueAsAny();
+        }
 
 #ifdef FC_PROPERTYEXPRESSIONENGINE_LOG
         {
-            Base::Quantity q;
-            boost::any value = e->getValueAsAny();
-
             if (value.type() == typeid(Base::Quantity))
                 q = boost::any_cast<Base::Quantity>(value);
             else if (value.type() == typeid(double))
@@ -605,12 +978,12 @@ DocumentObjectExecReturn *App::PropertyExpressionEngine::execute()
                 q = 0;
             }
 
-            std::clog << "Assigning value " << q.getValue() << " to " << (*it).toString().c_str() << " (" << prop->getName() <<  ")" << std::endl;
+            std::clog << "Assigning value " << q.getValue() << " to " << c.path.toString().c_str() << " (" << prop->getName() <<  ")" << std::endl;
         }
 #endif
 
         /* Set value of property */
-        prop->setPathValue(*it, e->getValueAsAny());
+        prop->setPathValue(c.path, value);
 
         ++it;
     }
@@ -835,6 +1208,7 @@ void PropertyExpressionEngine::renameExpressions(const std::map<ObjectIdentifier
 
     aboutToSetValue();
     expressions = newExpressions;
+    invalidateCompiledExpressions();
     for (ExpressionMap::const_iterator i = expressions.begin(); i != expressions.end(); ++i)
         expressionChanged(i->first);
 
@@ -848,6 +1222,8 @@ void PropertyExpressionEngine::renameExpressions(const std::map<ObjectIdentifier
 
 void PropertyExpressionEngine::renameObjectIdentifiers(const std::map<ObjectIdentifier, ObjectIdentifier> &paths)
 {
+    invalidateCompiledExpressions();
+
     for (ExpressionMap::iterator it = expressions.begin(); it != expressions.end(); ++it) {
         RenameObjectIdentifierExpressionVisitor<PropertyExpressionEngine> v(*this, paths, it->first);
         it->second.expression->visit(v);
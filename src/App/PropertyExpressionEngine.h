@@ -123,8 +123,14 @@ private:
     typedef std::pair<int, int> Edge;
     typedef boost::unordered_map<const App::ObjectIdentifier, ExpressionInfo> ExpressionMap;
 
+    struct CompiledExpression;
+
     std::vector<App::ObjectIdentifier> computeEvaluationOrder();
 
+    void compileExpressions();
+
+    void invalidateCompiledExpressions();
+
     void buildGraphStructures(const App::ObjectIdentifier &path,
                               const boost::shared_ptr<Expression> expression, boost::unordered_map<App::ObjectIdentifier, int> &nodes,
                               boost::unordered_map<int, App::ObjectIdentifier> &revNodes, std::vector<Edge> &edges) const;
@@ -140,6 +146,12 @@ private:
 
     ExpressionMap restoredExpressions; /**< Expressions are read from file to this map first before they are validated and inserted into the actual map */
 
+    std::vector<boost::shared_ptr<CompiledExpression> > compiledExpressions; /**< Expressions in evaluation order, prepared for fast evaluation */
+
+    bool compiledExpressionsValid; /**< False if the expressions must be compiled again before the next evaluation */
+
+    int compiledObjectCount; /**< Number of objects in the document when the expressions were compiled */
+
     friend class AtomicPropertyChange;
 
 };
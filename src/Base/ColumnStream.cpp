@@ -0,0 +1,307 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *   FreeCAD LICENSE IS LGPL3 WITHOUT ANY WARRANTY                         *
+ ***************************************************************************/
+
+
+
+# include <algorithm>
+# include <cmath>
+# include <cstring>
+# include <limits>
+# include <string>
+# include <vector>
+# include <zlib.h>
+#ifdef __GNUC__
+# include <stdint.h>
+#endif
+
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include "ColumnStream.h"
+#include "Exception.h"
+#include "Stream.h"
+
+using namespace Base;
+
+namespace {
+
+// Number of values per chunk, a chunk is the unit that is (de-)compressed at once
+const uint32_t ColumnChunkSize = 65536;
+
+// The kind of data stored in a column
+enum ColumnKind {
+    FloatColumn = 0,        // bit pattern of the floats
+    QuantizedColumn = 1,    // floats rounded to multiples of a step width
+    IndexColumn = 2         // unsigned integers
+};
+
+struct ColumnChunk
+{
+    std::size_t begin;
+    std::size_t count;
+    std::string bytes;
+    bool ok;
+};
+
+// Maps the bit pattern of a float to an integer that has the same order as the floats
+inline uint32_t floatToOrdered(float f)
+{
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(float));
+    return (u & 0x80000000) ? ~u : (u | 0x80000000);
+}
+
+inline float orderedToFloat(uint32_t u)
+{
+    u = (u & 0x80000000) ? (u & 0x7fffffff) : ~u;
+    float f;
+    std::memcpy(&f, &u, sizeof(float));
+    return f;
+}
+
+/*
+ * Each value is replaced by its difference to the previous value in the chunk,
+ * the signed differences are zig-zag encoded so that small differences of
+ * either sign become small numbers. The bytes are then regrouped into four
+ * planes, the high planes then mostly consist of zeros and compress well.
+ */
+template <typename Load>
+void encodeChunk(ColumnChunk& chunk, Load load)
+{
+    std::size_t n = chunk.count;
+    std::vector<unsigned char> planes(4 * n);
+    uint32_t prev = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        uint32_t value = load(chunk.begin + i);
+        int32_t delta = static_cast<int32_t>(value - prev);
+        uint32_t zigzag = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+        prev = value;
+        planes[i] = static_cast<unsigned char>(zigzag);
+        planes[n + i] = static_cast<unsigned char>(zigzag >> 8);
+        planes[2 * n + i] = static_cast<unsigned char>(zigzag >> 16);
+        planes[3 * n + i] = static_cast<unsigned char>(zigzag >> 24);
+    }
+
+    uLongf size = compressBound(static_cast<uLong>(planes.size()));
+    chunk.bytes.resize(size);
+    chunk.ok = (compress2(reinterpret_cast<Bytef*>(&chunk.bytes[0]), &size,
+                          &planes[0], static_cast<uLong>(planes.size()), Z_BEST_SPEED) == Z_OK);
+    chunk.bytes.resize(size);
+}
+
+template <typename Store>
+void decodeChunk(ColumnChunk& chunk, Store store)
+{
+    std::size_t n = chunk.count;
+    std::vector<unsigned char> planes(4 * n);
+    uLongf size = static_cast<uLongf>(planes.size());
+    chunk.ok = (uncompress(&planes[0], &size,
+                           reinterpret_cast<const Bytef*>(chunk.bytes.data()),
+                           static_cast<uLong>(chunk.bytes.size())) == Z_OK) &&
+               (size == planes.size());
+    if (!chunk.ok)
+        return;
+
+    uint32_t prev = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        uint32_t zigzag = static_cast<uint32_t>(planes[i]) |
+                          static_cast<uint32_t>(planes[n + i]) << 8 |
+                          static_cast<uint32_t>(planes[2 * n + i]) << 16 |
+                          static_cast<uint32_t>(planes[3 * n + i]) << 24;
+        uint32_t delta = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+        prev += delta;
+        store(chunk.begin + i, prev);
+    }
+
+    // release the memory as early as possible
+    std::string().swap(chunk.bytes);
+}
+
+// Number of chunks that are held in memory at once
+std::size_t chunksPerBatch()
+{
+    return 4 * static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1));
+}
+
+template <typename Load>
+void writeColumn(std::ostream& out, uint8_t kind, float precision, std::size_t count, Load load)
+{
+    if (count > std::numeric_limits<uint32_t>::max())
+        throw Base::ValueError("Too many values to write");
+
+    OutputStream str(out);
+    str << kind << precision << static_cast<uint32_t>(count) << ColumnChunkSize;
+
+    std::size_t numChunks = (count + ColumnChunkSize - 1) / ColumnChunkSize;
+    std::size_t batchSize = chunksPerBatch();
+    std::vector<ColumnChunk> chunks;
+    for (std::size_t first = 0; first < numChunks; first += batchSize) {
+        std::size_t last = std::min(first + batchSize, numChunks);
+        chunks.resize(last - first);
+        for (std::size_t i = first; i < last; i++) {
+            ColumnChunk& chunk = chunks[i - first];
+            chunk.begin = i * ColumnChunkSize;
+            chunk.count = std::min<std::size_t>(ColumnChunkSize, count - chunk.begin);
+            chunk.ok = false;
+        }
+
+        QtConcurrent::blockingMap(chunks, [load](ColumnChunk& chunk) {
+            encodeChunk(chunk, load);
+        });
+
+        for (std::vector<ColumnChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+            if (!it->ok)
+                throw Base::RuntimeError("Failed to compress data");
+            str << static_cast<uint32_t>(it->bytes.size());
+            out.write(it->bytes.data(), it->bytes.size());
+        }
+    }
+}
+
+template <typename Store>
+void readColumn(std::istream& in, std::size_t count, uint32_t chunkSize, Store store)
+{
+    if ((chunkSize == 0 && count > 0) || chunkSize > 16 * ColumnChunkSize)
+        throw Base::BadFormatError("Invalid chunk size");
+
+    InputStream str(in);
+    std::size_t numChunks = chunkSize > 0 ? (count + chunkSize - 1) / chunkSize : 0;
+    std::size_t batchSize = chunksPerBatch();
+    uLong maxSize = compressBound(4 * static_cast<uLong>(chunkSize));
+    std::vector<ColumnChunk> chunks;
+    for (std::size_t first = 0; first < numChunks; first += batchSize) {
+        std::size_t last = std::min(first + batchSize, numChunks);
+        chunks.resize(last - first);
+        for (std::size_t i = first; i < last; i++) {
+            ColumnChunk& chunk = chunks[i - first];
+            chunk.begin = i * chunkSize;
+            chunk.count = std::min<std::size_t>(chunkSize, count - chunk.begin);
+            chunk.ok = false;
+
+            uint32_t size = 0;
+            str >> size;
+            if (!in || size > maxSize)
+                throw Base::BadFormatError("Reading from stream failed");
+            chunk.bytes.resize(size);
+            in.read(&chunk.bytes[0], size);
+            if (!in)
+                throw Base::BadFormatError("Reading from stream failed");
+        }
+
+        QtConcurrent::blockingMap(chunks, [store](ColumnChunk& chunk) {
+            decodeChunk(chunk, store);
+        });
+
+        for (std::vector<ColumnChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+            if (!it->ok)
+                throw Base::BadFormatError("Failed to decompress data");
+        }
+    }
+}
+
+void readColumnHeader(std::istream& in, std::size_t count, uint8_t& kind,
+                      float& precision, uint32_t& chunkSize)
+{
+    InputStream str(in);
+    uint32_t stored = 0;
+    str >> kind >> precision >> stored >> chunkSize;
+    if (!in)
+        throw Base::BadFormatError("Reading from stream failed");
+    if (stored != count)
+        throw Base::BadFormatError("Unexpected number of values");
+}
+
+}
+
+// ----------------------------------------------------------------------
+
+ColumnWriter::ColumnWriter(std::ostream &rout) : _out(rout)
+{
+}
+
+ColumnWriter::~ColumnWriter()
+{
+}
+
+void ColumnWriter::writeFloats (const float* data, std::size_t count, std::size_t stride, float precision)
+{
+    // fall back to the lossless encoding if a value cannot be rounded to a 32-bit integer
+    bool quantize = precision > 0.0f;
+    if (quantize) {
+        const double limit = static_cast<double>(std::numeric_limits<int32_t>::max());
+        for (std::size_t i = 0; i < count; i++) {
+            double q = static_cast<double>(data[i * stride]) / precision;
+            if (!(std::fabs(q) < limit)) {
+                quantize = false;
+                break;
+            }
+        }
+    }
+
+    if (quantize) {
+        writeColumn(_out, QuantizedColumn, precision, count, [data, stride, precision](std::size_t i) {
+            double q = static_cast<double>(data[i * stride]) / precision;
+            return static_cast<uint32_t>(static_cast<int32_t>(std::floor(q + 0.5)));
+        });
+    }
+    else {
+        writeColumn(_out, FloatColumn, 0.0f, count, [data, stride](std::size_t i) {
+            return floatToOrdered(data[i * stride]);
+        });
+    }
+}
+
+void ColumnWriter::writeIndices (const uint32_t* data, std::size_t count, std::size_t stride)
+{
+    writeColumn(_out, IndexColumn, 0.0f, count, [data, stride](std::size_t i) {
+        return data[i * stride];
+    });
+}
+
+// ----------------------------------------------------------------------
+
+ColumnReader::ColumnReader(std::istream &rin) : _in(rin)
+{
+}
+
+ColumnReader::~ColumnReader()
+{
+}
+
+void ColumnReader::readFloats (float* data, std::size_t count, std::size_t stride)
+{
+    uint8_t kind;
+    float precision;
+    uint32_t chunkSize;
+    readColumnHeader(_in, count, kind, precision, chunkSize);
+
+    if (kind == FloatColumn) {
+        readColumn(_in, count, chunkSize, [data, stride](std::size_t i, uint32_t value) {
+            data[i * stride] = orderedToFloat(value);
+        });
+    }
+    else if (kind == QuantizedColumn && precision > 0.0f) {
+        readColumn(_in, count, chunkSize, [data, stride, precision](std::size_t i, uint32_t value) {
+            data[i * stride] = static_cast<float>(static_cast<int32_t>(value) * static_cast<double>(precision));
+        });
+    }
+    else {
+        throw Base::BadFormatError("Unexpected column type");
+    }
+}
+
+void ColumnReader::readIndices (uint32_t* data, std::size_t count, std::size_t stride)
+{
+    uint8_t kind;
+    float precision;
+    uint32_t chunkSize;
+    readColumnHeader(_in, count, kind, precision, chunkSize);
+
+    if (kind != IndexColumn)
+        throw Base::BadFormatError("Unexpected column type");
+    readColumn(_in, count, chunkSize, [data, stride](std::size_t i, uint32_t value) {
+        data[i * stride] = value;
+    });
+}
@@ -0,0 +1,77 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *   FreeCAD LICENSE IS LGPL3 WITHOUT ANY WARRANTY                         *
+ ***************************************************************************/
+
+
+#ifndef BASE_COLUMNSTREAM_H
+#define BASE_COLUMNSTREAM_H
+
+
+#include "stdexport.h"
+
+#ifdef __GNUC__
+# include <stdint.h>
+#endif
+
+#include <cstddef>
+#include <iostream>
+
+namespace Base {
+
+/**
+ * The ColumnWriter class writes arrays of numbers in a compact column-wise
+ * encoding. A column is split into chunks of a fixed number of values. The
+ * values of a chunk are delta-coded, their bytes are regrouped into planes
+ * and the planes are compressed with zlib. The chunks don't depend on each
+ * other so that they are encoded and decoded in parallel.
+ * @author agent
+ */
+class BaseExport ColumnWriter
+{
+public:
+    ColumnWriter(std::ostream &rout);
+    ~ColumnWriter();
+
+    /** Writes \a count floats starting at \a data whereas two consecutive
+     * values are \a stride floats apart. If \a precision is greater than 0 the
+     * values are rounded to multiples of \a precision, otherwise they are
+     * stored without any loss.
+     */
+    void writeFloats (const float* data, std::size_t count, std::size_t stride = 1,
+                      float precision = 0.0f);
+    /** Writes \a count indices starting at \a data whereas two consecutive
+     * values are \a stride values apart.
+     */
+    void writeIndices (const uint32_t* data, std::size_t count, std::size_t stride = 1);
+
+private:
+    std::ostream& _out;
+};
+
+/**
+ * The ColumnReader class reads the columns written by ColumnWriter.
+ * @author agent
+ */
+class BaseExport ColumnReader
+{
+public:
+    ColumnReader(std::istream &rin);
+    ~ColumnReader();
+
+    /** Reads a column of \a count floats. A BadFormatError is thrown if the
+     * stored column doesn't have \a count values or is corrupted.
+     */
+    void readFloats (float* data, std::size_t count, std::size_t stride = 1);
+    /** Reads a column of \a count indices. A BadFormatError is thrown if the
+     * stored column doesn't have \a count values or is corrupted.
+     */
+    void readIndices (uint32_t* data, std::size_t count, std::size_t stride = 1);
+
+private:
+    std::istream& _in;
+};
+
+} // namespace Base
+
+#endif // BASE_COLUMNSTREAM_H
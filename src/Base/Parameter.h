@@ -19,9 +19,11 @@
 
 // Include files
 #include "FCConfig.h"
+#include <atomic>
 #include <sstream>
 
 #include <map>
+#include <string>
 #include <vector>
 #include <xercesc/util/XercesDefs.hpp>
 
@@ -226,6 +228,109 @@ protected:
 
 };
 
+/** The cached parameter class
+ *  This class keeps a copy of a single value of a parameter group, so that
+ *  code that runs very often can read the value without searching the DOM
+ *  tree. The copy is refreshed by the observer notification of the group
+ *  whenever the value is set or removed or the group is cleared. Reading the
+ *  value is a single atomic load and may also be done from other threads.
+ *  Setting a value still goes through the group.
+ *  Supported types are bool, long, unsigned long and double.
+ *  \code
+ *  static CachedParameter<double> deviation(App::GetApplication().GetParameterGroupByPath
+ *      ("User parameter:BaseApp/Preferences/Mod/Part"), "MeshDeviation", 0.2);
+ *  double value = deviation.getValue();
+ *  \endcode
+ *  @see ParameterGrp
+ */
+template <typename T>
+class CachedParameter : public ParameterGrp::ObserverType
+{
+public:
+    CachedParameter(const ParameterGrp::handle& hGrp, const char* Name, T Preset)
+      : _hGrp(hGrp), _cName(Name), _preset(Preset), _value(Preset)
+    {
+        _value.store(read(), std::memory_order_relaxed);
+        _hGrp->Attach(this);
+    }
+    ~CachedParameter()
+    {
+        _hGrp->Detach(this);
+    }
+
+    /// returns the cached value
+    T getValue(void) const {
+        return _value.load(std::memory_order_relaxed);
+    }
+    /// writes the value into the group, the cached value is updated by the notification
+    void setValue(T Value) {
+        write(Value);
+    }
+    /// returns the group the value belongs to
+    const ParameterGrp::handle& getGroup(void) const {
+        return _hGrp;
+    }
+
+    void OnChange(ParameterGrp::SubjectType& /*rCaller*/, ParameterGrp::MessageType Reason)
+    {
+        // a null pointer is sent if the whole group was cleared
+        if (!Reason || _cName == Reason)
+            _value.store(read(), std::memory_order_relaxed);
+    }
+
+private:
+    T read(void) const;
+    void write(T Value);
+
+    CachedParameter(const CachedParameter&);
+    CachedParameter& operator=(const CachedParameter&);
+
+    ParameterGrp::handle _hGrp;
+    std::string _cName;
+    T _preset;
+    std::atomic<T> _value;
+};
+
+template <> inline bool CachedParameter<bool>::read(void) const
+{
+    return _hGrp->GetBool(_cName.c_str(), _preset);
+}
+
+template <> inline void CachedParameter<bool>::write(bool Value)
+{
+    _hGrp->SetBool(_cName.c_str(), Value);
+}
+
+template <> inline long CachedParameter<long>::read(void) const
+{
+    return _hGrp->GetInt(_cName.c_str(), _preset);
+}
+
+template <> inline void CachedParameter<long>::write(long Value)
+{
+    _hGrp->SetInt(_cName.c_str(), Value);
+}
+
+template <> inline unsigned long CachedParameter<unsigned long>::read(void) const
+{
+    return _hGrp->GetUnsigned(_cName.c_str(), _preset);
+}
+
+template <> inline void CachedParameter<unsigned long>::write(unsigned long Value)
+{
+    _hGrp->SetUnsigned(_cName.c_str(), Value);
+}
+
+template <> inline double CachedParameter<double>::read(void) const
+{
+    return _hGrp->GetFloat(_cName.c_str(), _preset);
+}
+
+template <> inline void CachedParameter<double>::write(double Value)
+{
+    _hGrp->SetFloat(_cName.c_str(), Value);
+}
+
 /** The parameter serializer class
  *  This is a helper class to serialize a parameter XML document.
  *  Does loading and saving the DOM document from and to files.
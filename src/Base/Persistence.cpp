@@ -50,6 +50,19 @@ void Persistence::RestoreDocFile(Reader &/*reader*/)
 {
 }
 
+bool Persistence::readDocFile(Reader &/*reader*/)
+{
+    return false;
+}
+
+void Persistence::applyDocFile()
+{
+}
+
+void Persistence::discardDocFile()
+{
+}
+
 std::string Persistence::encodeAttribute(const std::string& str)
 {
     std::string tmp;
@@ -127,6 +127,26 @@ public:
      * @see Base::Reader,Base::XMLReader
      */
     virtual void RestoreDocFile(Reader &/*reader*/);
+    /** This method is used to decode the data of a file in a worker thread
+     * XMLReader::readFiles() reads several files at the same time and calls this method
+     * from a worker thread with the content of the file. An implementation may decode the
+     * data and keep the result until applyDocFile() is called, but must neither change the
+     * visible state of the object nor access any other object.
+     * If it returns true applyDocFile() is called from the main thread instead of
+     * RestoreDocFile(). The default implementation returns false, in this case
+     * RestoreDocFile() is called from the main thread with the content of the file.
+     * @see XMLReader::readFiles()
+     */
+    virtual bool readDocFile(Reader &/*reader*/);
+    /** This method is called from the main thread to take over the data that
+     * readDocFile() has decoded. The default implementation does nothing.
+     */
+    virtual void applyDocFile();
+    /** This method is called from the main thread instead of applyDocFile() if
+     * readDocFile() or applyDocFile() has thrown an exception. It releases the data
+     * decoded so far. The default implementation does nothing.
+     */
+    virtual void discardDocFile();
     /// Encodes an attribute upon saving.
     static std::string encodeAttribute(const std::string&);
 
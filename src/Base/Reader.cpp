@@ -10,10 +10,17 @@
 # include <xercesc/sax2/XMLReaderFactory.hpp>
 # include <xercesc/sax2/SAX2XMLReader.hpp>
 
+#include <algorithm>
+#include <fstream>
 #include <locale>
+#include <set>
+#include <sstream>
 #include <filesystem>
 namespace fs = std::filesystem;
 
+#include <QThread>
+#include <QtConcurrentMap>
+
 #include "Reader.h"
 #include "Exception.h"
 #include "Persistence.h"
@@ -234,175 +241,131 @@ void Base::XMLReader::readCharacters(void)
 {
 }
 
-void Base::XMLReader::readFiles() const{
-	fs::path mycurrentpath = fs::current_path();
-	fs::current_path(
-//  fs::absolute(
-//      ((fs::path)this->_File.currentPath()).parent_path()
-//    )
-      this->_File.dirPath()
-  );
-  std::cout << "Base::XMLReader::readFiles() fs::current_path(): " << fs::current_path() << endl;
-  for(auto& FileName: fs::directory_iterator(".")){ // need entry
-    std::cout << FileName.path() << endl;
-
-    FileInfo fi1(FileName.path());
-    FileEntry fe1;
-    fe1.FileName = FileName.path();
-    if(fi1.isFile ()){
-      std::ifstream file(fe1.FileName, std::ios::in | std::ios::binary);
-      try {
-        Base::Reader reader(file, FileName.path(), FileVersion);
-        //fe1.Object->RestoreDocFile(reader);
-      }
-      catch(...) {
-        // For any exception we just continue with the next file.
-        // It doesn't matter if the last reader has read more or
-        // less data than the file size would allow.
-        // All what we need to do is to notify the user about the
-        // failure.
-        Base::Console().Error("Reading failed from embedded file: %s\n", FileName.path().c_str());
-      }
+namespace {
+
+// A registered file that is read and, if the object supports it, decoded by a worker thread
+struct FileTask
+{
+    const char* fileName;
+    Base::Persistence* object;
+    std::string path;
+    std::string data;
+    bool exists;
+    bool prepared;
+    bool failed;
+};
+
+void readFileTask(FileTask& task, int fileVersion)
+{
+    std::ifstream file(fs::path(task.path), std::ios::in | std::ios::binary);
+    task.exists = file.is_open();
+    if (!task.exists)
+        return;
+
+    try {
+        file.seekg(0, std::ios::end);
+        std::streamoff size = file.tellg();
+        file.seekg(0, std::ios::beg);
+        task.data.resize(size > 0 ? static_cast<std::size_t>(size) : 0);
+        if (size > 0)
+            file.read(&task.data[0], size);
+        if (!file)
+            throw Base::FileException("Failed to read file", task.path.c_str());
+
+        // the stream takes over the data and gives it back if the object wants to restore it itself
+        std::istringstream str(std::move(task.data));
+        Base::Reader reader(str, task.path, fileVersion);
+        task.prepared = task.object->readDocFile(reader);
+        if (!task.prepared)
+            task.data = std::move(str).str();
     }
-  }
-	fs::current_path(mycurrentpath);
-}
-
-/**/
-/*
-void Base::XMLReader::readFiles() const //zipios::ZipInputStream &zipstream
-{
-//#1  0x7fa54fc1d27c in Base::XMLReader::readFiles() const from lib/libFreeCADBase.so+0x70c
-//#2  0x7fa54fe22327 in App::Document::restore() from           lib/libFreeCADApp.so+0x377
-//#3  0x7fa54ff3a45e in App::Application::openDocument(char const*) from lib/libFreeCADApp.so+0x20e
-//#4  0x7fa54ff51ea5 in App::Application::sOpenDocument(_object*, _object*) from lib/libFreeCADApp.so+0xa5
-
-    // It's possible that not all objects inside the document could be created, e.g. if a module
-    // is missing that would know these object types. So, there may be data files inside the zip
-    // file that cannot be read. We simply ignore these files.
-    // On the other hand, however, it could happen that a file should be read that is not part of
-    // the zip file. This happens e.g. if a document is written without GUI up but is read with GUI
-    // up. In this case the associated GUI document asks for its file which is not part of the ZIP
-    // file, then.
-    // In either case it's guaranteed that the order of the files is kept.
-
-	fs::path mycurrentpath = fs::current_path();
-    fs::current_path(
-        this->_File.filePath()
-    );
-    std::cout << "Base::XMLReader::readFiles() fs::current_path(): " << fs::current_path() << endl;
-    size_t FileList_size = 0;
-    std::vector<FileEntry> _FileList;
-    std::vector<std::string> _FileNames;
-    std::vector<std::string> fl = {
-    		"./GuiDocument.xml",
-    		"./PartShape.brp",
-    		"./PartShape1..brp",
-    		"./Job.nc",
-    		"./pickle",
-    		"./Operations.nc",
-    		"./pickle1",
-    		"./pickle2",
-    		"./pickle3",
-    		"./pickle4",
-    		"./PartShape1..brp",
-    		"./Default_Tool.nc",
-    		"./pickle5",
-    		"./pickle6",
-    		"./PartShape1..brp",
-    		"./Contour.nc",
-    		"./pickle7",
-    		"./PartShape1..brp",
-    		"./DiffuseColor",
-    		"./LineColorArray",
-    		"./PointColorArray",
-    		"./pickle8",
-    		"./pickle9",
-    		"./pickle10",
-    		"./DiffuseColor1",
-    		"./LineColorArray1",
-    		"./PointColorArray1",
-    		"./pickle11",
-    		"./DiffuseColor2",
-    		"./LineColorArray2",
-    		"./PointColorArray2",
-    		"./pickle12",
-    		"./pickle13",
-    		"./DiffuseColor3",
-    		"./LineColorArray3",
-    		"./PointColorArray3",
-    		"./pickle14",
-    		"./pickle15"
-    };
-    for(auto& FileName: fs::directory_iterator(".")){
-    	//for(auto const& FileName: fl) {
-    	FileList_size++;
-//
-//    	const char* epta = FileName.path().c_str();
-//    	Base::Persistence *Object;
-
-//    	this->addFile(epta, Object); //(const char* Name, Base::Persistence *Object)
-//
-        FileEntry temp;
-        temp.FileName = FileName.path().c_str();
-        temp.Object = nullptr;//Object;
-
-        _FileList.push_back(temp);
-        _FileNames.push_back( temp.FileName );
-    	//this->FileList = {};//.push_back({FileName.path(),0});
-    	//FileNames.push_back((std::string)FileName.path());
-    	//break;
+    catch (...) {
+        task.failed = true;
     }
-    if (FileList_size == 0) return;
-    //FileList = _FileList;
-    //FileNames = _FileNames;
-
-    std::vector<FileEntry>::const_iterator it = _FileList.begin();
-    Base::SequencerLauncher seq("Importing project files...", FileList_size);
-
-    ///for(auto& FileName: fs::directory_iterator(".")){
-    while (it != _FileList.end()) {
-        std::vector<FileEntry>::const_iterator jt = it;
-        // Check if the current entry is registered, otherwise check the next registered files as soon as
-        // both file names match
-        while (jt != _FileList.end() && it->FileName != jt->FileName)
-            ++jt;
-        // If this condition is true both file names match and we can read-in the data, otherwise
-        // no file name for the current entry in the zip was registered.
-        if (jt != _FileList.end()) {
-            //try {
-            //    Base::Reader reader(zipstream, jt->FileName, FileVersion);
-            //   jt->Object->RestoreDocFile(reader);
-            //    if (reader.getLocalReader())
-            //        reader.getLocalReader()->readFiles(zipstream);
-            //}
-            ////FileInfo fi1(FileName.path());
-            ////if(fi1.isFile ()){
-                std::cout << jt->FileName << std::endl;
-              std::ifstream file(jt->FileName, std::ios::in | std::ios::binary);
-              try {
-                Base::Reader reader(file, jt->FileName, FileVersion);
-                //jt->Object->RestoreDocFile(reader);
-              }
-            catch(...) {
-                // For any exception we just continue with the next file.
-                // It doesn't matter if the last reader has read more or
-                // less data than the file size would allow.
-                // All what we need to do is to notify the user about the
-                // failure.
-                Base::Console().Error("Reading failed from embedded file: %s\n", jt->FileName);
+}
+
+}
+
+void Base::XMLReader::readFiles() const
+{
+    // The files are stored next to the XML file of the document. A registered file that doesn't
+    // exist is ignored, e.g. the file of the Gui document if the document was written without GUI.
+    // The files are opened with their absolute path so that the working directory isn't touched.
+    if (FileList.empty())
+        return;
+
+    fs::path dir = fs::absolute(fs::path(_File.filePath()));
+    if (!fs::is_directory(dir))
+        dir = dir.parent_path();
+
+    // The files of a batch are read and decoded in parallel, afterwards the objects are
+    // restored one after the other in the order the files were registered. So, only the
+    // data of one batch has to be kept in memory.
+    std::size_t batchSize = 4 * static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1));
+    Base::SequencerLauncher seq("Importing project files...", FileList.size());
+    std::vector<FileTask> tasks;
+    std::size_t first = 0;
+    while (first < FileList.size()) {
+        // an object that registered several files must not read two of them at the same time
+        std::set<Base::Persistence*> objects;
+        std::size_t last = first;
+        while (last < FileList.size() && last - first < batchSize && objects.insert(FileList[last].Object).second)
+            last++;
+        tasks.resize(last - first);
+        for (std::size_t i = first; i < last; i++) {
+            FileTask& task = tasks[i - first];
+            task.fileName = FileList[i].FileName.c_str();
+            task.object = FileList[i].Object;
+            task.path = (dir / FileList[i].FileName).string();
+            task.data.clear();
+            task.exists = false;
+            task.prepared = false;
+            task.failed = false;
+        }
+
+        // messages of the worker threads are delivered by the main thread
+        int fileVersion = FileVersion;
+        Base::Console().SetConnectionMode(Base::ConsoleSingleton::Queued);
+        QtConcurrent::blockingMap(tasks, [fileVersion](FileTask& task) {
+            readFileTask(task, fileVersion);
+        });
+        Base::Console().SetConnectionMode(Base::ConsoleSingleton::Direct);
+
+        for (std::vector<FileTask>::iterator it = tasks.begin(); it != tasks.end(); ++it) {
+            if (it->failed) {
+                it->object->discardDocFile();
+                Base::Console().Error("Reading failed from embedded file: %s\n", it->fileName);
             }
-            ////}
-            // Go to the next registered file name
-            it = jt + 1;
+            else if (it->exists) {
+                try {
+                    if (it->prepared) {
+                        it->object->applyDocFile();
+                    }
+                    else {
+                        std::istringstream str(std::move(it->data));
+                        Base::Reader reader(str, it->path, FileVersion);
+                        it->object->RestoreDocFile(reader);
+                    }
+                }
+                catch(...) {
+                    // For any exception we just continue with the next file.
+                    // It doesn't matter if the last reader has read more or
+                    // less data than the file size would allow.
+                    // All what we need to do is to notify the user about the
+                    // failure.
+                    if (it->prepared)
+                        it->object->discardDocFile();
+                    Base::Console().Error("Reading failed from embedded file: %s\n", it->fileName);
+                }
+            }
+            std::string().swap(it->data);
+            seq.next();
         }
 
-        seq.next();
-    //}
+        first = last;
     }
-	fs::current_path(mycurrentpath);
 }
-*/
+
 const char *Base::XMLReader::addFile(const char* Name, Base::Persistence *Object)
 {
     FileEntry temp;
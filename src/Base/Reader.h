@@ -141,7 +141,11 @@ public:
     //@{
     /// add a read request of a persistent object
     const char *addFile(const char* Name, Base::Persistence *Object);
-    /// process the requested file writes
+    /** Restores the objects from the registered files. The files are looked up next to
+     * the XML file and read in parallel, the objects are restored in the order the files
+     * were registered.
+     * @see Persistence::readDocFile()
+     */
     void readFiles() const;
     /// get all registered file names
     const std::vector<std::string>& getFilenames() const;
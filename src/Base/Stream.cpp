@@ -5,6 +5,7 @@
 
 
 
+# include <algorithm>
 # include <QBuffer>
 # include <QByteArray>
 # include <QDataStream>
@@ -41,6 +42,44 @@ void Stream::setByteOrder(ByteOrder bo)
     _swap = (bo == BigEndian);
 }
 
+namespace {
+
+// Number of values that are byte-swapped and written at once
+const std::size_t BulkChunkSize = 4096;
+
+template <typename T>
+void writeBulk(std::ostream& out, const T* data, std::size_t count, bool swap)
+{
+    if (!swap) {
+        out.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+        return;
+    }
+
+    T buffer[BulkChunkSize];
+    while (count > 0) {
+        std::size_t num = std::min(count, BulkChunkSize);
+        for (std::size_t i = 0; i < num; i++) {
+            buffer[i] = data[i];
+            Base::SwapEndian<T>(buffer[i]);
+        }
+        out.write(reinterpret_cast<const char*>(buffer), num * sizeof(T));
+        data += num;
+        count -= num;
+    }
+}
+
+template <typename T>
+void readBulk(std::istream& in, T* data, std::size_t count, bool swap)
+{
+    in.read(reinterpret_cast<char*>(data), count * sizeof(T));
+    if (swap) {
+        for (std::size_t i = 0; i < count; i++)
+            Base::SwapEndian<T>(data[i]);
+    }
+}
+
+}
+
 OutputStream::OutputStream(std::ostream &rout) : _out(rout)
 {
 }
@@ -123,6 +162,54 @@ OutputStream& OutputStream::operator << (double d)
     return *this;
 }
 
+OutputStream& OutputStream::write (const int16_t* data, std::size_t count)
+{
+    writeBulk(_out, data, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write (const uint16_t* data, std::size_t count)
+{
+    writeBulk(_out, data, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write (const int32_t* data, std::size_t count)
+{
+    writeBulk(_out, data, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write (const uint32_t* data, std::size_t count)
+{
+    writeBulk(_out, data, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write (const int64_t* data, std::size_t count)
+{
+    writeBulk(_out, data, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write (const uint64_t* data, std::size_t count)
+{
+    writeBulk(_out, data, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write (const float* data, std::size_t count)
+{
+    writeBulk(_out, data, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write (const double* data, std::size_t count)
+{
+    writeBulk(_out, data, count, _swap);
+    return *this;
+}
+
 InputStream::InputStream(std::istream &rin) : _in(rin)
 {
 }
@@ -205,6 +292,54 @@ InputStream& InputStream::operator >> (double& d)
     return *this;
 }
 
+InputStream& InputStream::read (int16_t* data, std::size_t count)
+{
+    readBulk(_in, data, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read (uint16_t* data, std::size_t count)
+{
+    readBulk(_in, data, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read (int32_t* data, std::size_t count)
+{
+    readBulk(_in, data, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read (uint32_t* data, std::size_t count)
+{
+    readBulk(_in, data, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read (int64_t* data, std::size_t count)
+{
+    readBulk(_in, data, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read (uint64_t* data, std::size_t count)
+{
+    readBulk(_in, data, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read (float* data, std::size_t count)
+{
+    readBulk(_in, data, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read (double* data, std::size_t count)
+{
+    readBulk(_in, data, count, _swap);
+    return *this;
+}
+
 // ----------------------------------------------------------------------
 
 ByteArrayOStreambuf::ByteArrayOStreambuf(QByteArray& ba) : _buffer(new QBuffer(&ba))
@@ -14,6 +14,7 @@
 # include <stdint.h>
 #endif
 
+#include <cstddef>
 #include <fstream>
 #include <ios>
 #include <iostream>
@@ -66,6 +67,21 @@ public:
     OutputStream& operator << (float f);
     OutputStream& operator << (double d);
 
+    /** @name Bulk write
+     * Writes \a count values in one go. The values are only copied and
+     * byte-swapped if the stream doesn't use the native byte order.
+     */
+    //@{
+    OutputStream& write (const int16_t* data, std::size_t count);
+    OutputStream& write (const uint16_t* data, std::size_t count);
+    OutputStream& write (const int32_t* data, std::size_t count);
+    OutputStream& write (const uint32_t* data, std::size_t count);
+    OutputStream& write (const int64_t* data, std::size_t count);
+    OutputStream& write (const uint64_t* data, std::size_t count);
+    OutputStream& write (const float* data, std::size_t count);
+    OutputStream& write (const double* data, std::size_t count);
+    //@}
+
 private:
     OutputStream (const OutputStream&);
     void operator = (const OutputStream&);
@@ -96,6 +112,22 @@ public:
     InputStream& operator >> (float& f);
     InputStream& operator >> (double& d);
 
+    /** @name Bulk read
+     * Reads \a count values in one go into \a data that must have enough
+     * space. The values are only byte-swapped if the stream doesn't use the
+     * native byte order.
+     */
+    //@{
+    InputStream& read (int16_t* data, std::size_t count);
+    InputStream& read (uint16_t* data, std::size_t count);
+    InputStream& read (int32_t* data, std::size_t count);
+    InputStream& read (uint32_t* data, std::size_t count);
+    InputStream& read (int64_t* data, std::size_t count);
+    InputStream& read (uint64_t* data, std::size_t count);
+    InputStream& read (float* data, std::size_t count);
+    InputStream& read (double* data, std::size_t count);
+    //@}
+
     operator bool() const
     {
         // test if _Ipfx succeeded
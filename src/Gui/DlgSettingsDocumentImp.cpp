@@ -55,6 +55,7 @@ void DlgSettingsDocumentImp::saveSettings()
     prefSaveBackupFiles->onSave();
     prefCountBackupFiles->onSave();
     prefDuplicateLabel->onSave();
+    prefCompressMeshData->onSave();
     prefLicenseType->onSave();
     prefLicenseUrl->onSave();
     prefAuthor->onSave();
@@ -84,6 +85,7 @@ void DlgSettingsDocumentImp::loadSettings()
     prefSaveBackupFiles->onRestore();
     prefCountBackupFiles->onRestore();
     prefDuplicateLabel->onRestore();
+    prefCompressMeshData->onRestore();
     prefLicenseType->onRestore();
     prefLicenseUrl->onRestore();
     prefAuthor->onRestore();
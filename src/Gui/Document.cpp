@@ -777,8 +777,9 @@ void Document::Restore(Base::XMLReader &reader)
  */
 void Document::RestoreDocFile(Base::Reader &reader)
 {
-    // We must create an XML parser to read from the input stream
-    Base::XMLReader xmlReader("GuiDocument.xml", reader);
+    // We must create an XML parser to read from the input stream, the files
+    // of the view providers are looked up next to the file
+    Base::XMLReader xmlReader(reader.getFileName().c_str(), reader);
     xmlReader.FileVersion = reader.getFileVersion();
 
     xmlReader.readElement("Document");
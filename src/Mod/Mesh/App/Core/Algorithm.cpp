@@ -297,7 +297,7 @@ void MeshAlgorithm::GetFacetBorders (const std::vector<unsigned long> &raulInd,
     for (int i = 0; i < 3; i++)
     {
       unsigned long ulNB = rclFacet._aulNeighbours[i];
-      if (ulNB != ULONG_MAX)
+      if (ulNB != FACET_INDEX_MAX)
       {
         if (rclFAry[ulNB].IsFlag(MeshFacet::VISIT) == true)
           continue;
@@ -391,7 +391,7 @@ void MeshAlgorithm::GetFacetBorders (const std::vector<unsigned long> &raulInd,
         const MeshFacet  &rclFacet = rclFAry[*it];
         for (int i = 0; i < 3; i++) {
             unsigned long ulNB = rclFacet._aulNeighbours[i];
-            if (ulNB != ULONG_MAX) {
+            if (ulNB != FACET_INDEX_MAX) {
                 if (rclFAry[ulNB].IsFlag(MeshFacet::VISIT) == true)
                     continue;
             }
@@ -479,7 +479,7 @@ void MeshAlgorithm::GetMeshBorder(unsigned long uFacet, std::list<unsigned long>
     MeshFacetArray::_TConstIterator face = rFAry.begin() + uFacet;
     for (int i = 0; i < 3; i++)
     {
-        if (face->_aulNeighbours[i] == ULONG_MAX)
+        if (face->_aulNeighbours[i] == FACET_INDEX_MAX)
             openEdges.push_back(face->GetEdge(i));
     }
 
@@ -492,7 +492,7 @@ void MeshAlgorithm::GetMeshBorder(unsigned long uFacet, std::list<unsigned long>
             continue;
         for (int i = 0; i < 3; i++)
         {
-            if (it->_aulNeighbours[i] == ULONG_MAX)
+            if (it->_aulNeighbours[i] == FACET_INDEX_MAX)
                 openEdges.push_back(it->GetEdge(i));
         }
     }
@@ -542,7 +542,7 @@ void MeshAlgorithm::SplitBoundaryLoops( std::list<std::vector<unsigned long> >&
     for (MeshFacetArray::_TConstIterator jt = _rclMesh._aclFacetArray.begin();
         jt != _rclMesh._aclFacetArray.end(); ++jt) {
         for (int i=0; i<3; i++) {
-            if (jt->_aulNeighbours[i] == ULONG_MAX) {
+            if (jt->_aulNeighbours[i] == FACET_INDEX_MAX) {
                 openPointDegree[jt->_aulPoints[i]]++;
                 openPointDegree[jt->_aulPoints[(i+1)%3]]++;
             }
@@ -1258,7 +1258,7 @@ unsigned long MeshAlgorithm::CountBorderEdges() const
     MeshFacetArray::_TConstIterator end = rclFAry.end();
     for (MeshFacetArray::_TConstIterator it = rclFAry.begin(); it != end; ++it) {
         for (int i=0; i<3; i++) {
-            if (it->_aulNeighbours[i] == ULONG_MAX)
+            if (it->_aulNeighbours[i] == FACET_INDEX_MAX)
                 cnt++;
         }
     }
@@ -1280,7 +1280,7 @@ void MeshAlgorithm::CheckBorderFacets (const std::vector<unsigned long> &raclFac
       for (int i = 0; i < 3; i++)
       {
         unsigned long ulNB = rclFAry[*pF]._aulNeighbours[i];
-        if (ulNB == ULONG_MAX)
+        if (ulNB == FACET_INDEX_MAX)
         {
           raclResultIndices.push_back(*pF);
           rclFAry[*pF].ResetFlag(MeshFacet::TMP0);
@@ -1310,7 +1310,7 @@ void MeshAlgorithm::GetBorderPoints (const std::vector<unsigned long> &raclFacet
     {
       const MeshFacet &rclFacet = rclFAry[*pF];
       unsigned long      ulNB     = rclFacet._aulNeighbours[i];
-      if (ulNB == ULONG_MAX)
+      if (ulNB == FACET_INDEX_MAX)
       {
         raclResultPointsIndices.insert(rclFacet._aulPoints[i]);
         raclResultPointsIndices.insert(rclFacet._aulPoints[(i+1)%3]);
@@ -1333,7 +1333,7 @@ bool MeshAlgorithm::NearestPointFromPoint (const Base::Vector3f &rclPt, unsigned
 
   // calc each facet
   float fMinDist = FLOAT_MAX;
-  unsigned long ulInd   = ULONG_MAX;
+  unsigned long ulInd   = FACET_INDEX_MAX;
   MeshFacetIterator pF(_rclMesh);
   for (pF.Init(); pF.More(); pF.Next())
   {
@@ -1356,7 +1356,7 @@ bool MeshAlgorithm::NearestPointFromPoint (const Base::Vector3f &rclPt, const Me
 {
   unsigned long ulInd = rclGrid.SearchNearestFromPoint(rclPt);
 
-  if (ulInd == ULONG_MAX)
+  if (ulInd == FACET_INDEX_MAX)
   {
     return false;
   }
@@ -1373,7 +1373,7 @@ bool MeshAlgorithm::NearestPointFromPoint (const Base::Vector3f &rclPt, const Me
 {
   unsigned long ulInd = rclGrid.SearchNearestFromPoint(rclPt, fMaxSearchArea);
 
-  if (ulInd == ULONG_MAX)
+  if (ulInd == FACET_INDEX_MAX)
     return false;  // no facets inside BoundingBox
 
   MeshGeomFacet rclSFacet = _rclMesh.GetFacet(ulInd);
@@ -1640,7 +1640,7 @@ bool MeshAlgorithm::Distance (const Base::Vector3f &rclPt, unsigned long ulFacet
 {
   const MeshFacetArray &rclFAry = _rclMesh._aclFacetArray;
   const MeshPointArray &rclPAry = _rclMesh._aclPointArray;
-  const unsigned long *pulIdx = rclFAry[ulFacetIdx]._aulPoints;
+  const PointIndex *pulIdx = rclFAry[ulFacetIdx]._aulPoints;
 
   BoundBox3f clBB;
   clBB.Add(rclPAry[*(pulIdx++)]);
@@ -1902,7 +1902,7 @@ void MeshRefEdgeToFacets::Rebuild (void)
                 _map.find(e);
             if (jt == _map.end()) {
                 _map[e].first = index;
-                _map[e].second = ULONG_MAX;
+                _map[e].second = FACET_INDEX_MAX;
             }
             else {
                 _map[e].second = index;
@@ -0,0 +1,276 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *   FreeCAD LICENSE IS LGPL3 WITHOUT ANY WARRANTY                         *
+ ***************************************************************************/
+
+
+
+# include <algorithm>
+
+#include <QFuture>
+#include <QtConcurrentMap>
+
+#include "BVH.h"
+#include "MeshKernel.h"
+
+using namespace MeshCore;
+
+namespace MeshCore {
+
+class MeshBVHOverlap
+{
+public:
+    typedef std::vector<std::pair<FacetIndex, FacetIndex> > result_type;
+
+    MeshBVHOverlap(const MeshFacetBVH& tree1, const MeshFacetBVH& tree2)
+      : tree1(tree1), tree2(tree2)
+    {
+    }
+    result_type operator()(const std::pair<unsigned long, unsigned long>& nodes) const
+    {
+        result_type pairs;
+        tree1.Overlaps(tree2, nodes, pairs);
+        return pairs;
+    }
+
+private:
+    const MeshFacetBVH& tree1;
+    const MeshFacetBVH& tree2;
+};
+
+}
+
+MeshFacetBVH::MeshFacetBVH (const MeshKernel &rclM, unsigned long ulLeafSize)
+  : _rclMesh(rclM), _ulLeafSize(std::max<unsigned long>(ulLeafSize, 1))
+{
+    Rebuild();
+}
+
+MeshFacetBVH::~MeshFacetBVH (void)
+{
+}
+
+void MeshFacetBVH::Rebuild (void)
+{
+    _aclNodes.clear();
+    _aulFacets.clear();
+    _aclBoxes.clear();
+
+    unsigned long ctFacets = _rclMesh.CountFacets();
+    if (ctFacets == 0)
+        return;
+
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    _aclBoxes.resize(ctFacets);
+    std::vector<Base::Vector3f> centers(ctFacets);
+    for (unsigned long i = 0; i < ctFacets; i++) {
+        const MeshFacet& rFace = rFacets[i];
+        Base::BoundBox3f& box = _aclBoxes[i];
+        box.Add(rPoints[rFace._aulPoints[0]]);
+        box.Add(rPoints[rFace._aulPoints[1]]);
+        box.Add(rPoints[rFace._aulPoints[2]]);
+        centers[i] = box.GetCenter();
+    }
+
+    _aulFacets.resize(ctFacets);
+    for (unsigned long i = 0; i < ctFacets; i++)
+        _aulFacets[i] = i;
+
+    // a binary tree with leaves of at least half the leaf size has less than 4n/s nodes
+    _aclNodes.reserve(4 * ctFacets / _ulLeafSize + 1);
+
+    Node root;
+    root.first = 0;
+    root.count = ctFacets;
+    root.right = 0;
+    _aclNodes.push_back(root);
+
+    std::vector<unsigned long> todo;
+    todo.push_back(0);
+    while (!todo.empty()) {
+        unsigned long index = todo.back();
+        todo.pop_back();
+
+        unsigned long first = _aclNodes[index].first;
+        unsigned long count = _aclNodes[index].count;
+
+        Base::BoundBox3f box, centerBox;
+        for (unsigned long i = first; i < first + count; i++) {
+            box.Add(_aclBoxes[_aulFacets[i]]);
+            centerBox.Add(centers[_aulFacets[i]]);
+        }
+        _aclNodes[index].box = box;
+
+        if (count <= _ulLeafSize)
+            continue;
+
+        // split at the median of the facet centers along the longest axis
+        int axis = 0;
+        float len = centerBox.LengthX();
+        if (centerBox.LengthY() > len) {
+            axis = 1;
+            len = centerBox.LengthY();
+        }
+        if (centerBox.LengthZ() > len) {
+            axis = 2;
+        }
+
+        std::vector<FacetIndex>::iterator begin = _aulFacets.begin() + first;
+        std::vector<FacetIndex>::iterator end = begin + count;
+        std::vector<FacetIndex>::iterator mid = begin + count / 2;
+        std::nth_element(begin, mid, end, [&centers, axis](FacetIndex a, FacetIndex b) {
+            return centers[a][axis] < centers[b][axis];
+        });
+
+        Node left, right;
+        left.first = first;
+        left.count = count / 2;
+        left.right = 0;
+        right.first = first + count / 2;
+        right.count = count - count / 2;
+        right.right = 0;
+
+        unsigned long leftIndex = _aclNodes.size();
+        _aclNodes.push_back(left);
+        _aclNodes.push_back(right);
+
+        _aclNodes[index].first = leftIndex;
+        _aclNodes[index].right = leftIndex + 1;
+        _aclNodes[index].count = 0;
+
+        todo.push_back(leftIndex + 1);
+        todo.push_back(leftIndex);
+    }
+}
+
+Base::BoundBox3f MeshFacetBVH::GetBoundBox (void) const
+{
+    if (_aclNodes.empty())
+        return Base::BoundBox3f();
+    return _aclNodes.front().box;
+}
+
+void MeshFacetBVH::Inside (const Base::BoundBox3f &rclBB, std::vector<FacetIndex> &raulElements) const
+{
+    if (_aclNodes.empty())
+        return;
+
+    std::vector<unsigned long> todo;
+    todo.push_back(0);
+    while (!todo.empty()) {
+        const Node& node = _aclNodes[todo.back()];
+        todo.pop_back();
+
+        if (!(node.box && rclBB))
+            continue;
+
+        if (node.IsLeaf()) {
+            for (unsigned long i = node.first; i < node.first + node.count; i++) {
+                FacetIndex index = _aulFacets[i];
+                if (_aclBoxes[index] && rclBB)
+                    raulElements.push_back(index);
+            }
+        }
+        else {
+            todo.push_back(node.right);
+            todo.push_back(node.first);
+        }
+    }
+}
+
+void MeshFacetBVH::Overlaps (const MeshFacetBVH &rclOther, const NodePair &nodes,
+                             std::vector<std::pair<FacetIndex, FacetIndex> > &raulPairs) const
+{
+    std::vector<NodePair> todo;
+    todo.push_back(nodes);
+    while (!todo.empty()) {
+        NodePair pair = todo.back();
+        todo.pop_back();
+
+        const Node& node1 = this->_aclNodes[pair.first];
+        const Node& node2 = rclOther._aclNodes[pair.second];
+        if (!(node1.box && node2.box))
+            continue;
+
+        if (node1.IsLeaf() && node2.IsLeaf()) {
+            for (unsigned long i = node1.first; i < node1.first + node1.count; i++) {
+                FacetIndex index1 = this->_aulFacets[i];
+                const Base::BoundBox3f& box1 = this->_aclBoxes[index1];
+                if (!(box1 && node2.box))
+                    continue;
+                for (unsigned long j = node2.first; j < node2.first + node2.count; j++) {
+                    FacetIndex index2 = rclOther._aulFacets[j];
+                    if (box1 && rclOther._aclBoxes[index2])
+                        raulPairs.push_back(std::make_pair(index1, index2));
+                }
+            }
+        }
+        else if (node2.IsLeaf() || (!node1.IsLeaf() &&
+                 node1.box.CalcDiagonalLength() >= node2.box.CalcDiagonalLength())) {
+            // descend into the larger of both nodes
+            todo.push_back(NodePair(node1.right, pair.second));
+            todo.push_back(NodePair(node1.first, pair.second));
+        }
+        else {
+            todo.push_back(NodePair(pair.first, node2.right));
+            todo.push_back(NodePair(pair.first, node2.first));
+        }
+    }
+}
+
+void MeshFacetBVH::Overlaps (const MeshFacetBVH &rclOther,
+                             std::vector<std::pair<FacetIndex, FacetIndex> > &raulPairs) const
+{
+    if (this->_aclNodes.empty() || rclOther._aclNodes.empty())
+        return;
+
+    // Expand the upper levels of both trees breadth-first until there are enough
+    // independent node pairs to keep all threads busy. The task target is fixed
+    // and not derived from the number of cores so that the expansion, and thus the
+    // order of the concatenated result, only depends on the trees.
+    const std::size_t numTasks = 1024;
+    std::vector<NodePair> tasks, next;
+    tasks.push_back(NodePair(0, 0));
+    bool expanded = true;
+    while (expanded && tasks.size() < numTasks) {
+        expanded = false;
+        next.clear();
+        for (std::vector<NodePair>::iterator it = tasks.begin(); it != tasks.end(); ++it) {
+            const Node& node1 = this->_aclNodes[it->first];
+            const Node& node2 = rclOther._aclNodes[it->second];
+            if (!(node1.box && node2.box))
+                continue;
+
+            if (!node1.IsLeaf() && !node2.IsLeaf()) {
+                next.push_back(NodePair(node1.first, node2.first));
+                next.push_back(NodePair(node1.first, node2.right));
+                next.push_back(NodePair(node1.right, node2.first));
+                next.push_back(NodePair(node1.right, node2.right));
+                expanded = true;
+            }
+            else if (!node1.IsLeaf()) {
+                next.push_back(NodePair(node1.first, it->second));
+                next.push_back(NodePair(node1.right, it->second));
+                expanded = true;
+            }
+            else if (!node2.IsLeaf()) {
+                next.push_back(NodePair(it->first, node2.first));
+                next.push_back(NodePair(it->first, node2.right));
+                expanded = true;
+            }
+            else {
+                next.push_back(*it);
+            }
+        }
+        tasks.swap(next);
+    }
+
+    QFuture<MeshBVHOverlap::result_type> future = QtConcurrent::mapped
+        (tasks, MeshBVHOverlap(*this, rclOther));
+    future.waitForFinished();
+
+    for (QFuture<MeshBVHOverlap::result_type>::const_iterator it = future.begin(); it != future.end(); ++it) {
+        raulPairs.insert(raulPairs.end(), it->begin(), it->end());
+    }
+}
@@ -0,0 +1,78 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *   FreeCAD LICENSE IS LGPL3 WITHOUT ANY WARRANTY                         *
+ ***************************************************************************/
+
+
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include "stdexport.h"
+#include <utility>
+#include <vector>
+
+#include "Definitions.h"
+#include "Base/BoundBox.h"
+
+namespace MeshCore {
+
+class MeshKernel;
+
+/**
+ * The MeshFacetBVH class is a bounding volume hierarchy over the bounding
+ * boxes of the facets of a mesh. Unlike the MeshFacetGrid whose cells have
+ * all the same size the tree adapts to the distribution of the facets, so
+ * that dense and sparse regions of a mesh can be searched equally fast.
+ * Each facet is referenced by exactly one leaf.
+ */
+class Standard_EXPORT MeshFacetBVH
+{
+public:
+    /// Construction
+    MeshFacetBVH (const MeshKernel &rclM, unsigned long ulLeafSize = 8);
+    /// Destruction
+    ~MeshFacetBVH (void);
+
+    /** Rebuilds the tree from the current facets of the mesh. */
+    void Rebuild (void);
+    /** Returns the indices of all facets whose bounding box intersects with \a rclBB. */
+    void Inside (const Base::BoundBox3f &rclBB, std::vector<FacetIndex> &raulElements) const;
+    /** Returns all pairs of facets of this and the mesh of \a rclOther whose bounding
+     * boxes intersect. Each pair is reported exactly once, the first index refers to
+     * this mesh. The subtrees are traversed in parallel but the order of the result
+     * doesn't depend on the number of threads.
+     */
+    void Overlaps (const MeshFacetBVH &rclOther,
+                   std::vector<std::pair<FacetIndex, FacetIndex> > &raulPairs) const;
+    /** Returns the bounding box of the whole tree. */
+    Base::BoundBox3f GetBoundBox (void) const;
+
+protected:
+    struct Node
+    {
+        Base::BoundBox3f box;
+        unsigned long    first;   // leaf: first entry in _aulFacets, inner node: left child
+        unsigned long    count;   // leaf: number of facets, inner node: 0
+        unsigned long    right;   // inner node: right child
+
+        bool IsLeaf () const
+        { return count > 0; }
+    };
+
+    typedef std::pair<unsigned long, unsigned long> NodePair;
+
+    void Overlaps (const MeshFacetBVH &rclOther, const NodePair &nodes,
+                   std::vector<std::pair<FacetIndex, FacetIndex> > &raulPairs) const;
+
+    const MeshKernel             &_rclMesh;
+    unsigned long                 _ulLeafSize;
+    std::vector<Node>             _aclNodes;
+    std::vector<FacetIndex>       _aulFacets;
+    std::vector<Base::BoundBox3f> _aclBoxes;
+
+    friend class MeshBVHOverlap;
+};
+
+} // namespace MeshCore
+
+#endif // MESH_BVH_H
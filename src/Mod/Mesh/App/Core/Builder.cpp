@@ -6,6 +6,7 @@
 
 
 # include <algorithm>
+# include <cstring>
 
 #include "Base/Sequencer.h"
 #include "Base/Exception.h"
@@ -14,6 +15,7 @@
 #include "MeshKernel.h"
 #include "Functional.h"
 #include <QVector>
+#include <QtConcurrentMap>
 
 using namespace MeshCore;
 
@@ -296,6 +298,33 @@ void MeshFastBuilder::AddFacet (const MeshGeomFacet& facetPoints)
     }
 }
 
+void MeshFastBuilder::AddFacets (const char* data, unsigned long ctFacets, std::size_t stride)
+{
+    QVector<Private::Vertex>& verts = p->verts;
+    std::size_t offset = static_cast<std::size_t>(verts.size());
+    verts.resize(offset + 3 * static_cast<std::size_t>(ctFacets));
+    Private::Vertex* out = verts.data() + offset;
+
+    // split the block into chunks of a fixed size so that the result doesn't
+    // depend on the number of threads
+    const unsigned long chunkSize = 65536;
+    std::vector<unsigned long> chunks;
+    for (unsigned long i = 0; i < ctFacets; i += chunkSize)
+        chunks.push_back(i);
+
+    QtConcurrent::blockingMap(chunks, [=](unsigned long start) {
+        unsigned long end = std::min(start + chunkSize, ctFacets);
+        float xyz[9];
+        for (unsigned long i = start; i < end; i++) {
+            // the data may be unaligned
+            std::memcpy(xyz, data + i * stride, sizeof(xyz));
+            out[3*i    ] = Private::Vertex(xyz[0], xyz[1], xyz[2]);
+            out[3*i + 1] = Private::Vertex(xyz[3], xyz[4], xyz[5]);
+            out[3*i + 2] = Private::Vertex(xyz[6], xyz[7], xyz[8]);
+        }
+    });
+}
+
 void MeshFastBuilder::Finish ()
 {
     QVector<Private::Vertex>& verts = p->verts;
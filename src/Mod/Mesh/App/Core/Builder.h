@@ -184,6 +184,12 @@ public:
     /** Add new facet
      */
     void AddFacet (const MeshGeomFacet& facetPoints);
+    /** Adds \a ctFacets facets from a raw memory block, e.g. a memory-mapped file.
+     * Each facet consists of nine consecutive native-endian floats starting at
+     * \a data, two facets are \a stride bytes apart. The block is decoded in
+     * parallel chunks directly into the vertex array.
+     */
+    void AddFacets (const char* data, unsigned long ctFacets, std::size_t stride);
 
     /** Finishes building up the mesh structure. Must be done after adding facets.
      */
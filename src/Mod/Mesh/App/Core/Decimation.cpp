@@ -10,9 +10,14 @@
 #include "Algorithm.h"
 #include "Iterator.h"
 #include "TopoAlgorithm.h"
+#include "Builder.h"
 #include "Base/Tools.h"
 #include "Simplify.h"
 
+#include <algorithm>
+#include <climits>
+#include <QtConcurrentMap>
+
 
 using namespace MeshCore;
 
@@ -75,3 +80,232 @@ void MeshSimplify::simplify(float tolerance, float reduction)
 
     myKernel.Adopt(new_points, new_facets, true);
 }
+
+namespace MeshCore {
+
+struct MeshSimplifyPartition
+{
+    std::vector<unsigned long> facets;
+    std::vector<MeshGeomFacet> result;
+};
+
+struct MeshSimplifyPointLess
+{
+    bool operator()(const Base::Vector3f& p, const Base::Vector3f& q) const
+    {
+        if (p.x != q.x)
+            return p.x < q.x;
+        if (p.y != q.y)
+            return p.y < q.y;
+        return p.z < q.z;
+    }
+};
+
+}
+
+void MeshSimplify::simplifyParallel(float tolerance, float reduction)
+{
+    const MeshPointArray& points = myKernel.GetPoints();
+    const MeshFacetArray& facets = myKernel.GetFacets();
+
+    // the number of partitions must not depend on the number of threads
+    const std::size_t minPartitionSize = 50000;
+    const std::size_t maxPartitions = 16;
+    std::size_t numParts = std::min(maxPartitions, facets.size() / minPartitionSize);
+    if (numParts < 2) {
+        simplify(tolerance, reduction);
+        return;
+    }
+
+    // sort the facets along the longest side of the bounding box
+    const Base::BoundBox3f& bbox = myKernel.GetBoundBox();
+    int axis = 0;
+    if (bbox.LengthY() > bbox.LengthX() && bbox.LengthY() >= bbox.LengthZ())
+        axis = 1;
+    else if (bbox.LengthZ() > bbox.LengthX() && bbox.LengthZ() > bbox.LengthY())
+        axis = 2;
+
+    std::vector<std::pair<float, unsigned long> > order(facets.size());
+    for (std::size_t i = 0; i < facets.size(); i++) {
+        const MeshFacet& f = facets[i];
+        float c = points[f._aulPoints[0]][axis] +
+                  points[f._aulPoints[1]][axis] +
+                  points[f._aulPoints[2]][axis];
+        order[i] = std::make_pair(c, i);
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<MeshSimplifyPartition> parts(numParts);
+    std::vector<std::size_t> partOfFacet(facets.size());
+    for (std::size_t i = 0; i < order.size(); i++) {
+        std::size_t part = i * numParts / order.size();
+        partOfFacet[order[i].second] = part;
+        parts[part].facets.push_back(order[i].second);
+    }
+
+    // points used by facets of different partitions must not be moved
+    const std::size_t noPart = numParts;
+    std::vector<std::size_t> partOfPoint(points.size(), noPart);
+    std::vector<char> locked(points.size(), 0);
+    for (std::size_t i = 0; i < facets.size(); i++) {
+        for (int j = 0; j < 3; j++) {
+            unsigned long pos = facets[i]._aulPoints[j];
+            if (partOfPoint[pos] == noPart)
+                partOfPoint[pos] = partOfFacet[i];
+            else if (partOfPoint[pos] != partOfFacet[i])
+                locked[pos] = 1;
+        }
+    }
+
+    QtConcurrent::blockingMap(parts, [&](MeshSimplifyPartition& part) {
+        // map the global point indices to local indices
+        std::vector<unsigned long> globalIndex;
+        globalIndex.reserve(3 * part.facets.size());
+        for (std::vector<unsigned long>::iterator it = part.facets.begin(); it != part.facets.end(); ++it) {
+            for (int j = 0; j < 3; j++)
+                globalIndex.push_back(facets[*it]._aulPoints[j]);
+        }
+        std::sort(globalIndex.begin(), globalIndex.end());
+        globalIndex.erase(std::unique(globalIndex.begin(), globalIndex.end()), globalIndex.end());
+
+        Simplify alg;
+        alg.vertices.resize(globalIndex.size());
+        alg.locked.resize(globalIndex.size());
+        for (std::size_t i = 0; i < globalIndex.size(); i++) {
+            alg.vertices[i].p = points[globalIndex[i]];
+            alg.locked[i] = locked[globalIndex[i]];
+        }
+
+        alg.triangles.resize(part.facets.size());
+        for (std::size_t i = 0; i < part.facets.size(); i++) {
+            const MeshFacet& f = facets[part.facets[i]];
+            for (int j = 0; j < 3; j++) {
+                alg.triangles[i].v[j] = std::lower_bound(globalIndex.begin(), globalIndex.end(),
+                                                         f._aulPoints[j]) - globalIndex.begin();
+            }
+        }
+
+        int target_count = static_cast<int>(static_cast<float>(part.facets.size()) * (1.0f-reduction));
+        alg.simplify_mesh(target_count, tolerance);
+
+        part.result.reserve(alg.triangles.size());
+        for (std::size_t i = 0; i < alg.triangles.size(); i++) {
+            const Simplify::Triangle& t = alg.triangles[i];
+            if (!t.deleted) {
+                part.result.push_back(MeshGeomFacet(alg.vertices[t.v[0]].p,
+                                                    alg.vertices[t.v[1]].p,
+                                                    alg.vertices[t.v[2]].p));
+            }
+        }
+    });
+
+    // the locked points keep their position, so they can be found again after merging
+    std::vector<Base::Vector3f> seamPoints;
+    for (std::size_t i = 0; i < points.size(); i++) {
+        if (locked[i])
+            seamPoints.push_back(points[i]);
+    }
+    std::sort(seamPoints.begin(), seamPoints.end(), MeshSimplifyPointLess());
+
+    // merge the partitions, the locked points are welded again
+    std::size_t numFacets = facets.size();
+    std::size_t numResult = 0;
+    for (std::vector<MeshSimplifyPartition>::iterator it = parts.begin(); it != parts.end(); ++it)
+        numResult += it->result.size();
+
+    MeshFastBuilder builder(myKernel);
+    builder.Initialize(numResult);
+    for (std::vector<MeshSimplifyPartition>::iterator it = parts.begin(); it != parts.end(); ++it) {
+        for (std::vector<MeshGeomFacet>::iterator jt = it->result.begin(); jt != it->result.end(); ++jt)
+            builder.AddFacet(*jt);
+        std::vector<MeshGeomFacet>().swap(it->result);
+    }
+    builder.Finish();
+
+    float target = static_cast<float>(numFacets) * (1.0f-reduction);
+    numResult = myKernel.CountFacets();
+    if (numResult > 0 && static_cast<float>(numResult) > target)
+        simplifySeams(seamPoints, tolerance, numResult - static_cast<std::size_t>(target));
+}
+
+void MeshSimplify::simplifySeams(const std::vector<Base::Vector3f>& seamPoints, float tolerance,
+                                 std::size_t excess)
+{
+    const MeshPointArray& points = myKernel.GetPoints();
+    const MeshFacetArray& facets = myKernel.GetFacets();
+
+    // the region consists of two rings of facets around the seam points
+    std::vector<char> regionPoint(points.size(), 0);
+    for (std::size_t i = 0; i < points.size(); i++) {
+        if (std::binary_search(seamPoints.begin(), seamPoints.end(), points[i], MeshSimplifyPointLess()))
+            regionPoint[i] = 1;
+    }
+    std::vector<char> regionFacet(facets.size(), 0);
+    for (int ring = 0; ring < 2; ring++) {
+        std::vector<char> next(regionPoint);
+        for (std::size_t i = 0; i < facets.size(); i++) {
+            const MeshFacet& f = facets[i];
+            if (regionPoint[f._aulPoints[0]] || regionPoint[f._aulPoints[1]] || regionPoint[f._aulPoints[2]]) {
+                regionFacet[i] = 1;
+                for (int j = 0; j < 3; j++)
+                    next[f._aulPoints[j]] = 1;
+            }
+        }
+        regionPoint.swap(next);
+    }
+
+    // points that are also used outside of the region must not be moved
+    std::vector<char> locked(points.size(), 0);
+    for (std::size_t i = 0; i < facets.size(); i++) {
+        if (!regionFacet[i]) {
+            for (int j = 0; j < 3; j++)
+                locked[facets[i]._aulPoints[j]] = 1;
+        }
+    }
+
+    Simplify alg;
+    std::vector<unsigned long> localIndex(points.size(), ULONG_MAX);
+    std::vector<MeshGeomFacet> result;
+    for (std::size_t i = 0; i < facets.size(); i++) {
+        const MeshFacet& f = facets[i];
+        if (!regionFacet[i]) {
+            result.push_back(myKernel.GetFacet(f));
+            continue;
+        }
+
+        Simplify::Triangle t;
+        for (int j = 0; j < 3; j++) {
+            unsigned long pos = f._aulPoints[j];
+            if (localIndex[pos] == ULONG_MAX) {
+                localIndex[pos] = alg.vertices.size();
+                Simplify::Vertex v;
+                v.p = points[pos];
+                alg.vertices.push_back(v);
+                alg.locked.push_back(locked[pos]);
+            }
+            t.v[j] = localIndex[pos];
+        }
+        alg.triangles.push_back(t);
+    }
+
+    std::size_t numRegion = alg.triangles.size();
+    if (numRegion == 0)
+        return;
+    int target_count = static_cast<int>(numRegion > excess ? numRegion - excess : 0);
+    alg.simplify_mesh(target_count, tolerance);
+
+    for (std::size_t i = 0; i < alg.triangles.size(); i++) {
+        const Simplify::Triangle& t = alg.triangles[i];
+        if (!t.deleted) {
+            result.push_back(MeshGeomFacet(alg.vertices[t.v[0]].p,
+                                           alg.vertices[t.v[1]].p,
+                                           alg.vertices[t.v[2]].p));
+        }
+    }
+
+    MeshFastBuilder builder(myKernel);
+    builder.Initialize(result.size());
+    for (std::vector<MeshGeomFacet>::iterator it = result.begin(); it != result.end(); ++it)
+        builder.AddFacet(*it);
+    builder.Finish();
+}
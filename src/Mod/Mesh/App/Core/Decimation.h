@@ -8,6 +8,8 @@
 #define MESH_DECIMATION_H
 
 #include "stdexport.h"
+#include <vector>
+#include "Base/Vector3D.h"
 
 namespace MeshCore
 {
@@ -19,6 +21,17 @@ public:
     MeshSimplify(MeshKernel&);
     ~MeshSimplify();
     void simplify(float tolerance, float reduction);
+    /** Splits the mesh into slabs of facets that are decimated in parallel. Points
+     * shared by several slabs are kept fixed. Afterwards the slabs are merged and the
+     * facets around their seams are decimated again to reach the requested reduction.
+     * The number of slabs only depends on the size of the mesh, so the result is the
+     * same for any number of threads.
+     */
+    void simplifyParallel(float tolerance, float reduction);
+
+private:
+    void simplifySeams(const std::vector<Base::Vector3f>& seamPoints, float tolerance,
+                       std::size_t excess);
 
 private:
     MeshKernel& myKernel;
@@ -8,6 +8,9 @@
 #ifndef MESH_DEFINITIONS_H
 #define MESH_DEFINITIONS_H
 
+#include <cstdint>
+#include <limits>
+
 // default values
 #define MESH_MIN_PT_DIST           1.0e-6f
 #define MESH_MIN_EDGE_LEN          1.0e-3f
@@ -34,6 +37,25 @@
 
 namespace MeshCore {
 
+/**
+ * Storage type of the point and neighbour indices of a facet and of the
+ * property fields of facets and points.
+ * With MESH_32BIT_INDEX defined a facet occupies 32 instead of 64 bytes on
+ * LP64 platforms which limits a mesh to 2^32-1 points and facets.
+ */
+#if defined(MESH_32BIT_INDEX)
+typedef std::uint32_t ElementIndex;
+#else
+typedef unsigned long ElementIndex;
+#endif
+typedef ElementIndex FacetIndex;
+typedef ElementIndex PointIndex;
+
+/** Marks an invalid index, e.g. an open edge of a facet. */
+const ElementIndex ELEMENT_INDEX_MAX = std::numeric_limits<ElementIndex>::max();
+const FacetIndex FACET_INDEX_MAX = ELEMENT_INDEX_MAX;
+const PointIndex POINT_INDEX_MAX = ELEMENT_INDEX_MAX;
+
 template <class Prec>
 class Math
 {
@@ -6,6 +6,7 @@
 
 
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <queue>
 
@@ -22,8 +23,67 @@
 #include <boost/math/special_functions/fpclassify.hpp>
 #include "Base/Sequencer.h"
 
+#include <QtConcurrentMap>
+
 using namespace MeshCore;
 
+namespace MeshCore {
+
+struct MeshFacetRange
+{
+    unsigned long begin;
+    unsigned long end;
+    std::vector<unsigned long> indices;
+};
+
+/*
+ * Returns the indices of the facets that pass the test in ascending order. The facets
+ * are tested in parallel in ranges of fixed size. If stopAtFirst is true the search
+ * ends as soon as a facet is found, the result then contains at least one index.
+ */
+template <typename Test>
+std::vector<unsigned long> FindFacetsParallel(const MeshKernel& mesh, Test test, bool stopAtFirst)
+{
+    const MeshFacetArray& rFaces = mesh.GetFacets();
+    const MeshPointArray& rPoints = mesh.GetPoints();
+
+    const unsigned long rangeSize = 4096;
+    const unsigned long numFacets = rFaces.size();
+    std::vector<MeshFacetRange> ranges;
+    for (unsigned long i = 0; i < numFacets; i += rangeSize) {
+        MeshFacetRange range;
+        range.begin = i;
+        range.end = std::min(i + rangeSize, numFacets);
+        ranges.push_back(range);
+    }
+
+    std::atomic<bool> found(false);
+    QtConcurrent::blockingMap(ranges, [&](MeshFacetRange& range) {
+        if (stopAtFirst && found.load(std::memory_order_relaxed))
+            return;
+        for (unsigned long i = range.begin; i < range.end; i++) {
+            const MeshFacet& face = rFaces[i];
+            MeshGeomFacet facet(rPoints[face._aulPoints[0]],
+                                rPoints[face._aulPoints[1]],
+                                rPoints[face._aulPoints[2]]);
+            if (test(facet)) {
+                range.indices.push_back(i);
+                if (stopAtFirst) {
+                    found.store(true, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        }
+    });
+
+    std::vector<unsigned long> indices;
+    for (std::vector<MeshFacetRange>::iterator it = ranges.begin(); it != ranges.end(); ++it)
+        indices.insert(indices.end(), it->indices.begin(), it->indices.end());
+    return indices;
+}
+
+}
+
 bool MeshEvalInvalids::Evaluate()
 {
   const MeshFacetArray& rFaces = _rclMesh.GetFacets();
@@ -429,13 +489,10 @@ bool MeshEvalInternalFacets::Evaluate()
 
 bool MeshEvalDegeneratedFacets::Evaluate()
 {
-    MeshFacetIterator it(_rclMesh);
-    for (it.Init(); it.More(); it.Next()) {
-        if (it->IsDegenerated(fEpsilon))
-            return false;
-    }
-
-    return true;
+    float fEps = fEpsilon;
+    return FindFacetsParallel(_rclMesh, [fEps](const MeshGeomFacet& facet) {
+        return facet.IsDegenerated(fEps);
+    }, true).empty();
 }
 
 unsigned long MeshEvalDegeneratedFacets::CountEdgeTooSmall (float fMinEdgeLength) const
@@ -456,14 +513,10 @@ unsigned long MeshEvalDegeneratedFacets::CountEdgeTooSmall (float fMinEdgeLength
 
 std::vector<unsigned long> MeshEvalDegeneratedFacets::GetIndices() const
 {
-    std::vector<unsigned long> aInds;
-    MeshFacetIterator it(_rclMesh);
-    for (it.Init(); it.More(); it.Next()) {
-        if (it->IsDegenerated(fEpsilon))
-            aInds.push_back(it.Position());
-    }
-
-    return aInds;
+    float fEps = fEpsilon;
+    return FindFacetsParallel(_rclMesh, [fEps](const MeshGeomFacet& facet) {
+        return facet.IsDegenerated(fEps);
+    }, false);
 }
 
 bool MeshFixDegeneratedFacets::Fixup()
@@ -541,12 +594,12 @@ bool MeshRemoveSmallEdges::Fixup()
 
         ce._removeFacets.push_back(faceedge.first);
         unsigned long neighbour = rclFAry[faceedge.first]._aulNeighbours[faceedge.second];
-        if (neighbour != ULONG_MAX)
+        if (neighbour != FACET_INDEX_MAX)
             ce._removeFacets.push_back(neighbour);
 
         std::set<unsigned long> vf = vf_it[ce._fromPoint];
         vf.erase(faceedge.first);
-        if (neighbour != ULONG_MAX)
+        if (neighbour != FACET_INDEX_MAX)
             vf.erase(neighbour);
         ce._changeFacets.insert(ce._changeFacets.begin(), vf.begin(), vf.end());
 
@@ -670,13 +723,9 @@ bool MeshEvalDeformedFacets::Evaluate()
     float fCosMinAngle = cos(fMinAngle);
     float fCosMaxAngle = cos(fMaxAngle);
 
-    MeshFacetIterator it(_rclMesh);
-    for (it.Init(); it.More(); it.Next()) {
-        if (it->IsDeformed(fCosMinAngle, fCosMaxAngle))
-            return false;
-    }
-
-    return true;
+    return FindFacetsParallel(_rclMesh, [fCosMinAngle, fCosMaxAngle](const MeshGeomFacet& facet) {
+        return facet.IsDeformed(fCosMinAngle, fCosMaxAngle);
+    }, true).empty();
 }
 
 std::vector<unsigned long> MeshEvalDeformedFacets::GetIndices() const
@@ -684,14 +733,9 @@ std::vector<unsigned long> MeshEvalDeformedFacets::GetIndices() const
     float fCosMinAngle = cos(fMinAngle);
     float fCosMaxAngle = cos(fMaxAngle);
 
-    std::vector<unsigned long> aInds;
-    MeshFacetIterator it(_rclMesh);
-    for (it.Init(); it.More(); it.Next()) {
-        if (it->IsDeformed(fCosMinAngle, fCosMaxAngle))
-            aInds.push_back(it.Position());
-    }
-
-    return aInds;
+    return FindFacetsParallel(_rclMesh, [fCosMinAngle, fCosMaxAngle](const MeshGeomFacet& facet) {
+        return facet.IsDeformed(fCosMinAngle, fCosMaxAngle);
+    }, false);
 }
 
 bool MeshFixDeformedFacets::Fixup()
@@ -726,7 +770,7 @@ bool MeshFixDeformedFacets::Fixup()
                 if (fCosAngle < fCosMaxAngle) {
                     const MeshFacet& face = it.GetReference();
                     unsigned long uNeighbour = face._aulNeighbours[(i+1)%3];
-                    if (uNeighbour!=ULONG_MAX && cTopAlg.ShouldSwapEdge(it.Position(), uNeighbour, fMaxSwapAngle)) {
+                    if (uNeighbour!=FACET_INDEX_MAX && cTopAlg.ShouldSwapEdge(it.Position(), uNeighbour, fMaxSwapAngle)) {
                         cTopAlg.SwapEdge(it.Position(), uNeighbour);
                         done = true;
                     }
@@ -745,13 +789,13 @@ bool MeshFixDeformedFacets::Fixup()
                     const MeshFacet& face = it.GetReference();
 
                     unsigned long uNeighbour = face._aulNeighbours[j];
-                    if (uNeighbour!=ULONG_MAX && cTopAlg.ShouldSwapEdge(it.Position(), uNeighbour, fMaxSwapAngle)) {
+                    if (uNeighbour!=FACET_INDEX_MAX && cTopAlg.ShouldSwapEdge(it.Position(), uNeighbour, fMaxSwapAngle)) {
                         cTopAlg.SwapEdge(it.Position(), uNeighbour);
                         break;
                     }
 
                     uNeighbour = face._aulNeighbours[(j+2)%3];
-                    if (uNeighbour!=ULONG_MAX && cTopAlg.ShouldSwapEdge(it.Position(), uNeighbour, fMaxSwapAngle)) {
+                    if (uNeighbour!=FACET_INDEX_MAX && cTopAlg.ShouldSwapEdge(it.Position(), uNeighbour, fMaxSwapAngle)) {
                         cTopAlg.SwapEdge(it.Position(), uNeighbour);
                         break;
                     }
@@ -880,7 +924,7 @@ bool MeshEvalFoldsOnSurface::Evaluate()
             unsigned long n1 = it->_aulNeighbours[i];
             unsigned long n2 = it->_aulNeighbours[(i+1)%3];
             Base::Vector3f v1 =_rclMesh.GetFacet(*it).GetNormal();
-            if (n1 != ULONG_MAX && n2 != ULONG_MAX) {
+            if (n1 != FACET_INDEX_MAX && n2 != FACET_INDEX_MAX) {
                 Base::Vector3f v2 = _rclMesh.GetFacet(n1).GetNormal();
                 Base::Vector3f v3 = _rclMesh.GetFacet(n2).GetNormal();
                 if (v2 * v3 > 0.0f) {
@@ -917,7 +961,7 @@ bool MeshEvalFoldsOnBoundary::Evaluate()
     for (MeshFacetArray::_TConstIterator it = rFacAry.begin(); it != rFacAry.end(); ++it) {
         if (it->CountOpenEdges() == 2) {
             for (int i=0; i<3; i++) {
-                if (it->_aulNeighbours[i] != ULONG_MAX) {
+                if (it->_aulNeighbours[i] != FACET_INDEX_MAX) {
                     MeshGeomFacet f1 = _rclMesh.GetFacet(*it);
                     MeshGeomFacet f2 = _rclMesh.GetFacet(it->_aulNeighbours[i]);
                     float cos_angle = f1.GetNormal() * f2.GetNormal();
@@ -961,7 +1005,7 @@ bool MeshEvalFoldOversOnSurface::Evaluate()
         for (int i=0; i<3; i++) {
             unsigned long index1 = f_it->_aulNeighbours[i];
             unsigned long index2 = f_it->_aulNeighbours[(i+1)%3];
-            if (index1 != ULONG_MAX && index2 != ULONG_MAX) {
+            if (index1 != FACET_INDEX_MAX && index2 != FACET_INDEX_MAX) {
                 // if the topology is correct but the normals flip from
                 // two neighbours we have a fold
                 if (f_it->HasSameOrientation(f_beg[index1]) &&
@@ -1016,7 +1060,7 @@ bool MeshEvalRangeFacet::Evaluate()
 
     for (MeshFacetArray::_TConstIterator it = rFaces.begin(); it != rFaces.end(); ++it) {
         for (int i = 0; i < 3; i++) {
-            if ((it->_aulNeighbours[i] >= ulCtFacets) && (it->_aulNeighbours[i] < ULONG_MAX)) {
+            if ((it->_aulNeighbours[i] >= ulCtFacets) && (it->_aulNeighbours[i] < FACET_INDEX_MAX)) {
                 return false;
             }
         }
@@ -1034,7 +1078,7 @@ std::vector<unsigned long> MeshEvalRangeFacet::GetIndices() const
     unsigned long ind=0;
     for (MeshFacetArray::_TConstIterator it = rFaces.begin(); it != rFaces.end(); ++it, ind++) {
         for (int i = 0; i < 3; i++) {
-            if ((it->_aulNeighbours[i] >= ulCtFacets) && (it->_aulNeighbours[i] < ULONG_MAX)) {
+            if ((it->_aulNeighbours[i] >= ulCtFacets) && (it->_aulNeighbours[i] < FACET_INDEX_MAX)) {
                 aInds.push_back(ind);
                 break;
             }
@@ -253,6 +253,7 @@ private:
  * The MeshEvalDegeneratedFacets class searches for degenerated facets. A facet is degenerated either if its points
  * are collinear, i.e. they lie on a line or two points are coincident. In the latter case these points are duplicated.
  * If a facet refers to at least two equal point indices then the facet is also regarded is 'corrupt'.
+ * The facets are checked in parallel.
  * @see MeshEvalCorruptedFacets
  * @see MeshEvalDuplicatePoints
  * @see MeshFixDegeneratedFacets
@@ -343,6 +344,7 @@ private:
 /**
  * The MeshEvalDeformedFacets class searches for deformed facets. A facet is regarded as deformed
  * if an angle is < 30 deg or > 120 deg.
+ * The facets are checked in parallel.
  * @see MeshFixDegeneratedFacets
  * @author Werner Mayer
  */
@@ -26,14 +26,14 @@ unsigned long MeshPointArray::Get (const MeshPoint &rclPoint)
   if (clIter != end())
     return clIter - begin();
   else
-    return ULONG_MAX;  
+    return POINT_INDEX_MAX;  
 }
 
 unsigned long MeshPointArray::GetOrAddIndex (const MeshPoint &rclPoint)
 {
   unsigned long ulIndex;
 
-  if ((ulIndex = Get(rclPoint)) == ULONG_MAX)
+  if ((ulIndex = Get(rclPoint)) == POINT_INDEX_MAX)
   {
     push_back(rclPoint);
     return (unsigned long)(size() - 1);
@@ -78,7 +78,8 @@ void MeshPointArray::Transform(const Base::Matrix4D& mat)
 
 void MeshFacetArray::Erase (_TIterator pIter)
 {
-  unsigned long i, *pulN;
+  unsigned long i;
+  FacetIndex *pulN;
   _TIterator  pPass, pEnd;
   unsigned long ulInd = pIter - begin();
   erase(pIter);
@@ -89,7 +90,7 @@ void MeshFacetArray::Erase (_TIterator pIter)
     for (i = 0; i < 3; i++)
     {
       pulN = &pPass->_aulNeighbours[i];
-      if ((*pulN > ulInd) && (*pulN != ULONG_MAX))
+      if ((*pulN > ulInd) && (*pulN != FACET_INDEX_MAX))
         (*pulN)--;
     }
     pPass++;
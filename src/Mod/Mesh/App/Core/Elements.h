@@ -123,7 +123,7 @@ public:
 
 public:
   unsigned char _ucFlag; /**< Flag member */
-  unsigned long _ulProp; /**< Free usable property */
+  ElementIndex  _ulProp; /**< Free usable property */
 };
 
 /**
@@ -156,7 +156,7 @@ public:
  * \li neighbour or edge number of 0 is defined by corner 0 and 1
  * \li neighbour or edge number of 1 is defined by corner 1 and 2
  * \li neighbour or edge number of 2 is defined by corner 2 and 0
- * \li neighbour index is set to ULONG_MAX if there is no neighbour facet
+ * \li neighbour index is set to FACET_INDEX_MAX if there is no neighbour facet
  *
  * Note: The status flag SEGMENT mark a facet to be part of certain subset, a segment.
  * This flag must not be set by any algorithm unless it adds or removes facets to a segment.
@@ -174,7 +174,7 @@ public:
   //@{
   inline MeshFacet (void);
   inline MeshFacet(const MeshFacet &rclF);
-  inline MeshFacet(unsigned long p1,unsigned long p2,unsigned long p3,unsigned long n1=ULONG_MAX,unsigned long n2=ULONG_MAX,unsigned long n3=ULONG_MAX);
+  inline MeshFacet(unsigned long p1,unsigned long p2,unsigned long p3,unsigned long n1=FACET_INDEX_MAX,unsigned long n2=FACET_INDEX_MAX,unsigned long n3=FACET_INDEX_MAX);
   ~MeshFacet (void) { }
   //@}
 
@@ -260,7 +260,7 @@ public:
    * Checks if the neighbour exists at the given edge-number.
    */
   bool HasNeighbour (unsigned short usSide) const
-  { return (_aulNeighbours[usSide] != ULONG_MAX); }
+  { return (_aulNeighbours[usSide] != FACET_INDEX_MAX); }
   /** Counts the number of edges without neighbour. */
   inline unsigned short CountOpenEdges() const;
   /** Returns true if there is an edge without neighbour, otherwise false. */
@@ -280,9 +280,9 @@ public:
 
 public:
   unsigned char _ucFlag; /**< Flag member. */
-  unsigned long _ulProp; /**< Free usable property. */
-  unsigned long _aulPoints[3];     /**< Indices of corner points. */
-  unsigned long _aulNeighbours[3]; /**< Indices of neighbour facets. */
+  ElementIndex  _ulProp; /**< Free usable property. */
+  PointIndex    _aulPoints[3];     /**< Indices of corner points. */
+  FacetIndex    _aulNeighbours[3]; /**< Indices of neighbour facets. */
 };
 
 /**
@@ -517,7 +517,7 @@ public:
   void Transform(const Base::Matrix4D&);
   /**
    * Searches for the first point index  Two points are equal if the distance is less
-   * than EPSILON. If no such points is found ULONG_MAX is returned. 
+   * than EPSILON. If no such points is found POINT_INDEX_MAX is returned. 
    */
   unsigned long Get (const MeshPoint &rclPoint);
   /**
@@ -787,8 +787,8 @@ inline MeshFacet::MeshFacet (void)
 : _ucFlag(0),
   _ulProp(0)
 {
-    memset(_aulNeighbours, 0xff, sizeof(unsigned long) * 3);
-    memset(_aulPoints, 0xff, sizeof(unsigned long) * 3);
+    memset(_aulNeighbours, 0xff, sizeof(FacetIndex) * 3);
+    memset(_aulPoints, 0xff, sizeof(PointIndex) * 3);
 }
 
 inline MeshFacet::MeshFacet(const MeshFacet &rclF)
@@ -22,6 +22,9 @@
 #include "Functional.h"
 #include "Base/Matrix.h"
 
+#include <QFuture>
+#include <QtConcurrentMap>
+
 #include "Base/Sequencer.h"
 
 using namespace MeshCore;
@@ -119,7 +122,7 @@ bool MeshEvalOrientation::Evaluate ()
     MeshFacetArray::_TConstIterator iEnd = rFAry.end();
     for (MeshFacetArray::_TConstIterator it = iBeg; it != iEnd; ++it) {
         for (int i = 0; i < 3; i++) {
-            if (it->_aulNeighbours[i] != ULONG_MAX) {
+            if (it->_aulNeighbours[i] != FACET_INDEX_MAX) {
                 const MeshFacet& rclFacet = iBeg[it->_aulNeighbours[i]];
                 for (int j = 0; j < 3; j++) {
                     if (it->_aulPoints[i] == rclFacet._aulPoints[j]) {
@@ -149,7 +152,7 @@ unsigned long MeshEvalOrientation::HasFalsePositives(const std::vector<unsigned
     for (std::vector<unsigned long>::const_iterator it = inds.begin(); it != inds.end(); ++it) {
         const MeshFacet& f = iBeg[*it];
         for (int i = 0; i < 3; i++) {
-            if (f._aulNeighbours[i] != ULONG_MAX) {
+            if (f._aulNeighbours[i] != FACET_INDEX_MAX) {
                 const MeshFacet& n = iBeg[f._aulNeighbours[i]];
                 if (f.IsFlag(MeshFacet::TMP0) && !n.IsFlag(MeshFacet::TMP0)) {
                     for (int j = 0; j < 3; j++) {
@@ -163,7 +166,7 @@ unsigned long MeshEvalOrientation::HasFalsePositives(const std::vector<unsigned
         }
     }
 
-    return ULONG_MAX;
+    return FACET_INDEX_MAX;
 }
 
 std::vector<unsigned long> MeshEvalOrientation::GetIndices() const
@@ -188,7 +191,7 @@ std::vector<unsigned long> MeshEvalOrientation::GetIndices() const
     std::vector<unsigned long> uIndices, uComplement;
     MeshOrientationCollector clHarmonizer(uIndices, uComplement);
 
-    while (ulStartFacet !=  ULONG_MAX) {
+    while (ulStartFacet !=  FACET_INDEX_MAX) {
         unsigned long wrongFacets = uIndices.size();
 
         uComplement.clear();
@@ -211,7 +214,7 @@ std::vector<unsigned long> MeshEvalOrientation::GetIndices() const
         if (iTri < iEnd)
             ulStartFacet = iTri - iBeg;
         else
-            ulStartFacet = ULONG_MAX;
+            ulStartFacet = FACET_INDEX_MAX;
     }
 
     // in some very rare cases where we have some strange artifacts in the mesh structure
@@ -219,7 +222,7 @@ std::vector<unsigned long> MeshEvalOrientation::GetIndices() const
     cAlg.ResetFacetFlag(MeshFacet::TMP0);
     cAlg.SetFacetsFlag(uIndices, MeshFacet::TMP0);
     ulStartFacet = HasFalsePositives(uIndices);
-    while (ulStartFacet != ULONG_MAX) {
+    while (ulStartFacet != FACET_INDEX_MAX) {
         cAlg.ResetFacetsFlag(uIndices, MeshFacet::VISIT);
         std::vector<unsigned long> falsePos;
         MeshSameOrientationCollector coll(falsePos);
@@ -338,7 +341,7 @@ bool MeshEvalTopology::Evaluate ()
     std::sort(edges.begin(), edges.end(), Edge_Less());
 
     // search for non-manifold edges
-    unsigned long p0 = ULONG_MAX, p1 = ULONG_MAX;
+    unsigned long p0 = POINT_INDEX_MAX, p1 = POINT_INDEX_MAX;
     nonManifoldList.clear();
     nonManifoldFacets.clear();
 
@@ -571,43 +574,39 @@ bool MeshFixSingleFacet::Fixup ()
 
 // ----------------------------------------------------------------
 
-bool MeshEvalSelfIntersection::Evaluate ()
-{
-    // Contains bounding boxes for every facet 
-    std::vector<Base::BoundBox3f> boxes;
+namespace MeshCore {
 
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(_rclMesh);
-    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
-    MeshGridIterator clGridIter(cMeshFacetGrid);
-    unsigned long ulGridX, ulGridY, ulGridZ;
-    cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
+/**
+ * Checks all facet pairs of a single grid cell for intersections.
+ * The class only reads the mesh and can therefore be used by several
+ * threads at the same time.
+ */
+class MeshCellIntersection
+{
+public:
+    typedef std::vector<std::pair<unsigned long, unsigned long> > result_type;
 
-    MeshFacetIterator cMFI(_rclMesh);
-    for (cMFI.Begin(); cMFI.More(); cMFI.Next()) {
-        boxes.push_back((*cMFI).GetBoundBox());
+    MeshCellIntersection(const MeshKernel& mesh, const std::vector<Base::BoundBox3f>& boxes, bool first)
+        : _rclMesh(mesh), _boxes(boxes), _stopAtFirst(first)
+    {
     }
 
-    // Calculates the intersections
-    Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX*ulGridY*ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        //Get the facet indices, belonging to the current grid unit
-        std::vector<unsigned long> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
-
-        seq.next();
-        if (aulGridElements.size()==0)
-            continue;
+    result_type operator()(const std::vector<unsigned long>& elements) const
+    {
+        result_type intersection;
+        const MeshFacetArray& rFaces = _rclMesh.GetFacets();
+        const MeshPointArray& rPoints = _rclMesh.GetPoints();
 
         MeshGeomFacet facet1, facet2;
         Base::Vector3f pt1, pt2;
-        for (std::vector<unsigned long>::iterator it = aulGridElements.begin(); it != aulGridElements.end(); ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
+        for (std::vector<unsigned long>::const_iterator it = elements.begin(); it != elements.end(); ++it) {
+            const Base::BoundBox3f& box1 = _boxes[*it];
             const MeshFacet& rface1 = rFaces[*it];
-            for (std::vector<unsigned long>::iterator jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) // the identical facet
+            bool geometry1 = false;
+            for (std::vector<unsigned long>::const_iterator jt = it + 1; jt != elements.end(); ++jt) {
+                // cheapest test first
+                const Base::BoundBox3f& box2 = _boxes[*jt];
+                if (!(box1 && box2))
                     continue;
                 // If the facets share a common vertex we do not check for self-intersections because they 
                 // could but usually do not intersect each other and the algorithm below would detect false-positives,
@@ -626,21 +625,42 @@ bool MeshEvalSelfIntersection::Evaluate ()
                     rface1._aulPoints[2] == rface2._aulPoints[2])
                     continue; // ignore facets sharing a common vertex
 
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
-                        // abort after the first detected self-intersection
-                        return false;
-                    }
+                // build the geometry only for candidates that passed the box test
+                if (!geometry1) {
+                    facet1 = MeshGeomFacet(rPoints[rface1._aulPoints[0]],
+                                           rPoints[rface1._aulPoints[1]],
+                                           rPoints[rface1._aulPoints[2]]);
+                    geometry1 = true;
+                }
+                facet2 = MeshGeomFacet(rPoints[rface2._aulPoints[0]],
+                                       rPoints[rface2._aulPoints[1]],
+                                       rPoints[rface2._aulPoints[2]]);
+                int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
+                if (ret == 2) {
+                    intersection.push_back(std::make_pair(*it, *jt));
+                    if (_stopAtFirst)
+                        return intersection;
                 }
             }
         }
+
+        return intersection;
     }
 
-    return true;
+private:
+    const MeshKernel& _rclMesh;
+    const std::vector<Base::BoundBox3f>& _boxes;
+    bool _stopAtFirst;
+};
+
+}
+
+bool MeshEvalSelfIntersection::Evaluate ()
+{
+    std::vector<std::pair<unsigned long, unsigned long> > intersection;
+    CollectIntersections(intersection, true, false);
+    // abort after the first detected self-intersection
+    return intersection.empty();
 }
 
 void MeshEvalSelfIntersection::GetIntersections(const std::vector<std::pair<unsigned long, unsigned long> >& indices,
@@ -669,71 +689,64 @@ void MeshEvalSelfIntersection::GetIntersections(const std::vector<std::pair<unsi
 
 void MeshEvalSelfIntersection::GetIntersections(std::vector<std::pair<unsigned long, unsigned long> >& intersection) const
 {
-    // Contains bounding boxes for every facet 
-    std::vector<Base::BoundBox3f> boxes;
-    //intersection.clear();
+    CollectIntersections(intersection, false, true);
+}
 
+void MeshEvalSelfIntersection::CollectIntersections(std::vector<std::pair<unsigned long, unsigned long> >& intersection,
+                                                    bool stopAtFirst, bool canAbort) const
+{
     // Splits the mesh using grid for speeding up the calculation
     MeshFacetGrid cMeshFacetGrid(_rclMesh);
-    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
     MeshGridIterator clGridIter(cMeshFacetGrid);
     unsigned long ulGridX, ulGridY, ulGridZ;
     cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
 
-    MeshFacetIterator cMFI(_rclMesh);
-    for(cMFI.Begin(); cMFI.More(); cMFI.Next()) {
-        boxes.push_back((*cMFI).GetBoundBox());
-    }
+    // Contains bounding boxes for every facet 
+    std::vector<Base::BoundBox3f> boxes(_rclMesh.CountFacets());
+    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    QtConcurrent::blockingMap(boxes, [&](Base::BoundBox3f& box) {
+        const MeshFacet& face = rFaces[&box - &boxes[0]];
+        box.Add(rPoints[face._aulPoints[0]]);
+        box.Add(rPoints[face._aulPoints[1]]);
+        box.Add(rPoints[face._aulPoints[2]]);
+    });
+
+    // The grid cells are collected in batches which are checked in parallel.
+    // QtConcurrent::mapped keeps the order of the input so that the result is
+    // the same as for a sequential run, independent of the number of threads.
+    MeshCellIntersection cellIntersection(_rclMesh, boxes, stopAtFirst);
+    const std::size_t batchSize = 1024;
+    std::vector<std::vector<unsigned long> > batch;
+    batch.reserve(batchSize);
+    std::size_t cells = 0;
 
-    // Calculates the intersections
     Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX*ulGridY*ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        //Get the facet indices, belonging to the current grid unit
-        std::vector<unsigned long> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
-
-        seq.next(true);
-        if (aulGridElements.size()==0)
-            continue;
-
-        MeshGeomFacet facet1, facet2;
-        Base::Vector3f pt1, pt2;
-        for (std::vector<unsigned long>::iterator it = aulGridElements.begin(); it != aulGridElements.end(); ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
-            const MeshFacet& rface1 = rFaces[*it];
-            for (std::vector<unsigned long>::iterator jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) // the identical facet
-                    continue;
-                // If the facets share a common vertex we do not check for self-intersections because they 
-                // could but usually do not intersect each other and the algorithm below would detect false-positives,
-                // otherwise
-                const MeshFacet& rface2 = rFaces[*jt];
-                if (rface1._aulPoints[0] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[0] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[0] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[1] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[1] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[1] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[2] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[2] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[2] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
+    clGridIter.Init();
+    while (clGridIter.More() || !batch.empty()) {
+        if (clGridIter.More()) {
+            //Get the facet indices, belonging to the current grid unit
+            std::vector<unsigned long> aulGridElements;
+            clGridIter.GetElements(aulGridElements);
+            clGridIter.Next();
+            cells++;
+            if (aulGridElements.size() > 1)
+                batch.push_back(aulGridElements);
+            if (batch.size() < batchSize && clGridIter.More())
+                continue;
+        }
 
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
-                        intersection.push_back(std::make_pair (*it,*jt));
-                    }
-                }
-            }
+        QFuture<MeshCellIntersection::result_type> future = QtConcurrent::mapped(batch, cellIntersection);
+        future.waitForFinished();
+        for (QFuture<MeshCellIntersection::result_type>::const_iterator it = future.begin(); it != future.end(); ++it) {
+            intersection.insert(intersection.end(), it->begin(), it->end());
         }
+        batch.clear();
+
+        for (; cells > 0; cells--)
+            seq.next(canAbort);
+        if (stopAtFirst && !intersection.empty())
+            break;
     }
 }
 
@@ -809,8 +822,8 @@ bool MeshEvalNeighbourhood::Evaluate ()
     // sort the edges
     std::sort(edges.begin(), edges.end(), Edge_Less());
 
-    unsigned long p0 = ULONG_MAX, p1 = ULONG_MAX;
-    unsigned long f0 = ULONG_MAX, f1 = ULONG_MAX;
+    unsigned long p0 = POINT_INDEX_MAX, p1 = POINT_INDEX_MAX;
+    unsigned long f0 = FACET_INDEX_MAX, f1 = FACET_INDEX_MAX;
     int count = 0;
     std::vector<Edge_Index>::iterator pE;
     for (pE = edges.begin(); pE != edges.end(); ++pE) {
@@ -836,7 +849,7 @@ bool MeshEvalNeighbourhood::Evaluate ()
                 const MeshFacet& rFace = rclFAry[f0];
                 unsigned short side = rFace.Side(p0,p1);
                 // should be "open edge" but isn't marked as such
-                if (rFace._aulNeighbours[side] != ULONG_MAX)
+                if (rFace._aulNeighbours[side] != FACET_INDEX_MAX)
                     return false;
             }
 
@@ -875,8 +888,8 @@ std::vector<unsigned long> MeshEvalNeighbourhood::GetIndices() const
     // sort the edges
     std::sort(edges.begin(), edges.end(), Edge_Less());
 
-    unsigned long p0 = ULONG_MAX, p1 = ULONG_MAX;
-    unsigned long f0 = ULONG_MAX, f1 = ULONG_MAX;
+    unsigned long p0 = POINT_INDEX_MAX, p1 = POINT_INDEX_MAX;
+    unsigned long f0 = FACET_INDEX_MAX, f1 = FACET_INDEX_MAX;
     int count = 0;
     std::vector<Edge_Index>::iterator pE;
     for (pE = edges.begin(); pE != edges.end(); ++pE) {
@@ -904,7 +917,7 @@ std::vector<unsigned long> MeshEvalNeighbourhood::GetIndices() const
                 const MeshFacet& rFace = rclFAry[f0];
                 unsigned short side = rFace.Side(p0,p1);
                 // should be "open edge" but isn't marked as such
-                if (rFace._aulNeighbours[side] != ULONG_MAX)
+                if (rFace._aulNeighbours[side] != FACET_INDEX_MAX)
                     inds.push_back(f0);
             }
 
@@ -951,8 +964,8 @@ void MeshKernel::RebuildNeighbours (unsigned long index)
     int threads = std::max(1, QThread::idealThreadCount());
     MeshCore::parallel_sort(edges.begin(), edges.end(), Edge_Less(), threads);
 
-    unsigned long p0 = ULONG_MAX, p1 = ULONG_MAX;
-    unsigned long f0 = ULONG_MAX, f1 = ULONG_MAX;
+    unsigned long p0 = POINT_INDEX_MAX, p1 = POINT_INDEX_MAX;
+    unsigned long f0 = FACET_INDEX_MAX, f1 = FACET_INDEX_MAX;
     int count = 0;
     std::vector<Edge_Index>::iterator pE;
     for (pE = edges.begin(); pE != edges.end(); ++pE) {
@@ -974,7 +987,7 @@ void MeshKernel::RebuildNeighbours (unsigned long index)
             else if (count == 1) {
                 MeshFacet& rFace = this->_aclFacetArray[f0];
                 unsigned short side = rFace.Side(p0,p1);
-                rFace._aulNeighbours[side] = ULONG_MAX;
+                rFace._aulNeighbours[side] = FACET_INDEX_MAX;
             }
 
             p0 = pE->p0;
@@ -997,7 +1010,7 @@ void MeshKernel::RebuildNeighbours (unsigned long index)
     else if (count == 1) {
         MeshFacet& rFace = this->_aclFacetArray[f0];
         unsigned short side = rFace.Side(p0,p1);
-        rFace._aulNeighbours[side] = ULONG_MAX;
+        rFace._aulNeighbours[side] = FACET_INDEX_MAX;
     }
 }
 
@@ -24,6 +24,9 @@ namespace MeshCore {
  * @see MeshEvalGeometry
  * The class itself is abstract, hence the method Evaluate() must be implemented 
  * by subclasses.
+ * Only the checks that test facets independently of each other run in parallel, i.e.
+ * MeshEvalSelfIntersection, MeshEvalDegeneratedFacets and MeshEvalDeformedFacets. The
+ * checks that walk along the neighbourhood of the facets are done sequentially.
  */
 class Standard_EXPORT MeshEvaluation
 {
@@ -267,6 +270,7 @@ protected:
 
 /**
  * The MeshEvalSelfIntersection class checks the mesh for self intersection.
+ * The cells of a facet grid are checked in parallel.
  * @author Werner Mayer
  */
 class Standard_EXPORT MeshEvalSelfIntersection : public MeshEvaluation
@@ -281,6 +285,13 @@ public:
         std::vector<std::pair<Base::Vector3f, Base::Vector3f> >&) const;
     /// collect the index of all facets with self intersections
     void GetIntersections(std::vector<std::pair<unsigned long, unsigned long> >&) const;
+
+private:
+    /** Checks the facets of the grid cells in parallel. The pairs are returned in
+     * the same order as a sequential run over the cells would find them.
+     */
+    void CollectIntersections(std::vector<std::pair<unsigned long, unsigned long> >&,
+                              bool stopAtFirst, bool canAbort) const;
 };
 
 /**
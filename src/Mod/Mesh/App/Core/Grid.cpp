@@ -7,6 +7,8 @@
 
 # include <algorithm>
 
+#include <QtConcurrentMap>
+
 #include "Grid.h"
 #include "Iterator.h"
 
@@ -42,7 +44,8 @@ void MeshGrid::Attach (const MeshKernel &rclM)
 
 void MeshGrid::Clear (void)
 {
-  _aulGrid.clear();
+  _aulOffsets.clear();
+  _aulElements.clear();
   _pclMesh = NULL;  
 }
 
@@ -73,8 +76,6 @@ void MeshGrid::InitGrid (void)
 {
   assert(_pclMesh != NULL);
 
-  unsigned long i, j;
-
   // Grid Laengen berechnen wenn nicht initialisiert
   //
   if ((_ulCtGridsX == 0) || (_ulCtGridsY == 0) || (_ulCtGridsZ == 0))
@@ -108,14 +109,67 @@ void MeshGrid::InitGrid (void)
   }
 
   // Daten-Struktur anlegen
-  _aulGrid.clear();
-  _aulGrid.resize(_ulCtGridsX);
-  for (i = 0; i < _ulCtGridsX; i++)
+  _aulOffsets.assign(_ulCtGridsX * _ulCtGridsY * _ulCtGridsZ + 1, 0);
+  _aulElements.clear();
+}
+
+void MeshGrid::FillGrid (unsigned long ulCtElements,
+                         const std::function<void(unsigned long, std::vector<unsigned long>&)>& getGrids)
+{
+  // The elements are classified chunk-wise in parallel and the (grid, element) pairs of each
+  // chunk are sorted by grid. The chunks have a fixed size so that the result doesn't depend
+  // on the number of threads.
+  struct Chunk
   {
-    _aulGrid[i].resize(_ulCtGridsY);
-    for (j = 0; j < _ulCtGridsY; j++)
-      _aulGrid[i][j].resize(_ulCtGridsZ);
+    unsigned long begin, end;
+    std::vector<std::pair<unsigned long, unsigned long> > pairs;
+    std::vector<unsigned long> starts;
+  };
+
+  const unsigned long ulChunkSize = 4096;
+  std::vector<Chunk> chunks((ulCtElements + ulChunkSize - 1) / ulChunkSize);
+  for (std::size_t i = 0; i < chunks.size(); i++) {
+    chunks[i].begin = i * ulChunkSize;
+    chunks[i].end = std::min<unsigned long>(chunks[i].begin + ulChunkSize, ulCtElements);
   }
+
+  QtConcurrent::blockingMap(chunks, [&getGrids](Chunk& chunk) {
+    std::vector<unsigned long> grids;
+    for (unsigned long i = chunk.begin; i < chunk.end; i++) {
+      grids.clear();
+      getGrids(i, grids);
+      for (std::vector<unsigned long>::iterator it = grids.begin(); it != grids.end(); ++it)
+        chunk.pairs.push_back(std::make_pair(*it, i));
+    }
+    std::sort(chunk.pairs.begin(), chunk.pairs.end());
+  });
+
+  // Counting sort: count the elements of each grid. For each run of equal grids in
+  // a chunk the number of elements of this grid in the preceding chunks is kept.
+  for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+    const std::vector<std::pair<unsigned long, unsigned long> >& pairs = it->pairs;
+    for (std::size_t i = 0; i < pairs.size(); i++) {
+      if (i == 0 || pairs[i].first != pairs[i-1].first)
+        it->starts.push_back(_aulOffsets[pairs[i].first + 1]);
+      _aulOffsets[pairs[i].first + 1]++;
+    }
+  }
+
+  for (std::size_t i = 1; i < _aulOffsets.size(); i++)
+    _aulOffsets[i] += _aulOffsets[i-1];
+  _aulElements.resize(_aulOffsets.back());
+
+  QtConcurrent::blockingMap(chunks, [this](Chunk& chunk) {
+    const std::vector<std::pair<unsigned long, unsigned long> >& pairs = chunk.pairs;
+    std::size_t run = 0;
+    unsigned long pos = 0;
+    for (std::size_t i = 0; i < pairs.size(); i++) {
+      if (i == 0 || pairs[i].first != pairs[i-1].first)
+        pos = _aulOffsets[pairs[i].first] + chunk.starts[run++];
+      _aulElements[pos++] = pairs[i].second;
+    }
+    std::vector<std::pair<unsigned long, unsigned long> >().swap(chunk.pairs);
+  });
 }
 
 unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::vector<unsigned long> &raulElements,
@@ -135,7 +189,7 @@ unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::vector<unsig
     {
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
-        raulElements.insert(raulElements.end(), _aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+        raulElements.insert(raulElements.end(), BeginElements(i, j, k), EndElements(i, j, k));
       }
     }
   }  
@@ -170,7 +224,7 @@ unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::vector<unsig
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
         if (Base::DistanceP2(GetBoundBox(i, j, k).GetCenter(), rclOrg) < fMinDistP2)
-          raulElements.insert(raulElements.end(), _aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+          raulElements.insert(raulElements.end(), BeginElements(i, j, k), EndElements(i, j, k));
       }
     }
   }  
@@ -201,7 +255,7 @@ unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::set<unsigned
     {
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
-        raulElements.insert(_aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+        raulElements.insert(BeginElements(i, j, k), EndElements(i, j, k));
       }
     }
   }  
@@ -458,7 +512,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsY; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+              raclInd.insert(BeginElements(nX, i, j), EndElements(nX, i, j));
           }
           nX++;
         }
@@ -472,9 +526,9 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsY; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+              raclInd.insert(BeginElements(nX, i, j), EndElements(nX, i, j));
           }
-          nX++;
+          nX--;
         }
         break;
       }
@@ -486,7 +540,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+              raclInd.insert(BeginElements(i, nY, j), EndElements(i, nY, j));
           }
           nY++;
         }
@@ -500,7 +554,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+              raclInd.insert(BeginElements(i, nY, j), EndElements(i, nY, j));
           }
           nY--;
         }
@@ -514,7 +568,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsY; j++)
-              raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+              raclInd.insert(BeginElements(i, j, nZ), EndElements(i, j, nZ));
           }
           nZ++;
         }
@@ -528,7 +582,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsY; j++)
-              raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+              raclInd.insert(BeginElements(i, j, nZ), EndElements(i, j, nZ));
           }
           nZ--;
         }
@@ -594,14 +648,11 @@ void MeshGrid::GetHull (unsigned long ulX, unsigned long ulY, unsigned long ulZ,
 unsigned long MeshGrid::GetElements (unsigned long ulX, unsigned long ulY, unsigned long ulZ,  
                                      std::set<unsigned long> &raclInd) const
 {
-  const std::set<unsigned long> &rclSet = _aulGrid[ulX][ulY][ulZ];
-  if (rclSet.size() > 0)
-  {
-    raclInd.insert(rclSet.begin(), rclSet.end());
-    return rclSet.size();
-  }
+  unsigned long ulCount = GetCtElements(ulX, ulY, ulZ);
+  if (ulCount > 0)
+    raclInd.insert(BeginElements(ulX, ulY, ulZ), EndElements(ulX, ulY, ulZ));
 
-  return 0;
+  return ulCount;
 }
 
 unsigned long MeshGrid::GetElements(const Base::Vector3f &rclPoint, std::vector<unsigned long>& aulFacets) const
@@ -610,9 +661,7 @@ unsigned long MeshGrid::GetElements(const Base::Vector3f &rclPoint, std::vector<
   if (!CheckPosition(rclPoint, ulX, ulY, ulZ))
     return 0;
 
-  aulFacets.resize(_aulGrid[ulX][ulY][ulZ].size());
-
-  std::copy(_aulGrid[ulX][ulY][ulZ].begin(), _aulGrid[ulX][ulY][ulZ].end(), aulFacets.begin());
+  aulFacets.assign(BeginElements(ulX, ulY, ulZ), EndElements(ulX, ulY, ulZ));
   return aulFacets.size();
 }
 
@@ -717,20 +766,15 @@ void MeshFacetGrid::RebuildGrid (void)
   InitGrid();
  
   // Daten-Struktur fuellen
-  MeshFacetIterator clFIter(*_pclMesh);
-
-  unsigned long i = 0;
-  for (clFIter.Init(); clFIter.More(); clFIter.Next())
-  {
-//    AddFacet(*clFIter, i++, 2.0f);
-    AddFacet(*clFIter, i++);
-  }
-
+  const MeshKernel& rclMesh = *_pclMesh;
+  FillGrid(_ulCtElements, [this, &rclMesh](unsigned long ulIndex, std::vector<unsigned long>& raulGrids) {
+    GetGrids(rclMesh.GetFacet(ulIndex), raulGrids);
+  });
 }
 
 unsigned long MeshFacetGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt) const
 {
-  unsigned long ulFacetInd = ULONG_MAX;
+  unsigned long ulFacetInd = FACET_INDEX_MAX;
   float fMinDist    = FLOAT_MAX;
   Base::BoundBox3f  clBB = GetBoundBox();
 
@@ -847,7 +891,7 @@ unsigned long MeshFacetGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt
 unsigned long MeshFacetGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, float fMaxSearchArea) const
 {
   std::vector<unsigned long> aulFacets;
-  unsigned long ulFacetInd = ULONG_MAX;
+  unsigned long ulFacetInd = FACET_INDEX_MAX;
   float fMinDist   = fMaxSearchArea;
 
   MeshAlgorithm clFTool(*_pclMesh);
@@ -926,8 +970,8 @@ void MeshFacetGrid::SearchNearestFacetInGrid(unsigned long ulX, unsigned long ul
                                              const Base::Vector3f &rclPt, float &rfMinDist,
                                              unsigned long &rulFacetInd) const
 {
-  const std::set<unsigned long> &rclSet = _aulGrid[ulX][ulY][ulZ];
-  for (std::set<unsigned long>::const_iterator pI = rclSet.begin(); pI != rclSet.end(); ++pI)
+  std::vector<unsigned long>::const_iterator pEnd = EndElements(ulX, ulY, ulZ);
+  for (std::vector<unsigned long>::const_iterator pI = BeginElements(ulX, ulY, ulZ); pI != pEnd; ++pI)
   {
     float fDist = _pclMesh->GetFacet(*pI).DistanceToPoint(rclPt);
     if (fDist < rfMinDist)
@@ -972,13 +1016,12 @@ MeshPointGrid::MeshPointGrid (const MeshKernel &rclM, float fGridLen)
           std::max<unsigned long>((unsigned long)(clBBMesh.LengthZ() / fGridLen), 1));
 }
 
-void MeshPointGrid::AddPoint (const MeshPoint &rclPt, unsigned long ulPtIndex, float fEpsilon)
+void MeshPointGrid::GetGrids (const MeshPoint &rclPt, std::vector<unsigned long> &raulGrids) const
 {
-  (void)fEpsilon;
   unsigned long ulX, ulY, ulZ;
   Pos(Base::Vector3f(rclPt.x, rclPt.y, rclPt.z), ulX, ulY, ulZ);
   if ( (ulX < _ulCtGridsX) && (ulY < _ulCtGridsY) && (ulZ < _ulCtGridsZ) )
-    _aulGrid[ulX][ulY][ulZ].insert(ulPtIndex);
+    raulGrids.push_back(GridIndex(ulX, ulY, ulZ));
 }
 
 void MeshPointGrid::Validate (const MeshKernel &rclMesh)
@@ -1029,14 +1072,10 @@ void MeshPointGrid::RebuildGrid (void)
   InitGrid();
  
   // Daten-Struktur fuellen
-
-  MeshPointIterator cPIter(*_pclMesh);
-
-  unsigned long i = 0;
-  for (cPIter.Init(); cPIter.More(); cPIter.Next())
-  {
-    AddPoint(*cPIter, i++);
-  }
+  const MeshPointArray& rclPoints = _pclMesh->GetPoints();
+  FillGrid(_ulCtElements, [this, &rclPoints](unsigned long ulIndex, std::vector<unsigned long>& raulGrids) {
+    GetGrids(rclPoints[ulIndex], raulGrids);
+  });
 }
 
 void MeshPointGrid::Pos (const Base::Vector3f &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const
@@ -1098,7 +1137,7 @@ bool MeshGridIterator::InitOnRay (const Base::Vector3f &rclPt, const Base::Vecto
   if ((_rclGrid.GetBoundBox().IsInBox(rclPt)) == true)
   {  // Voxel bestimmen, indem der Startpunkt liegt
     _rclGrid.Position(rclPt, _ulX, _ulY, _ulZ);
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+    raulElements.insert(raulElements.end(), _rclGrid.BeginElements(_ulX, _ulY, _ulZ), _rclGrid.EndElements(_ulX, _ulY, _ulZ));
     _bValidRay = true;
   }
   else
@@ -1111,7 +1150,7 @@ bool MeshGridIterator::InitOnRay (const Base::Vector3f &rclPt, const Base::Vecto
       else
         _rclGrid.Position(cP1, _ulX, _ulY, _ulZ);
 
-      raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+      raulElements.insert(raulElements.end(), _rclGrid.BeginElements(_ulX, _ulY, _ulZ), _rclGrid.EndElements(_ulX, _ulY, _ulZ));
       _bValidRay = true;
     }
   }
@@ -1162,7 +1201,7 @@ bool MeshGridIterator::NextOnRay (std::vector<unsigned long> &raulElements)
   if ((_bValidRay == true) && (_rclGrid.CheckPos(_ulX, _ulY, _ulZ) == true))
   {
     GridElement pos(_ulX, _ulY, _ulZ); _cSearchPositions.insert(pos);
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end()); 
+    raulElements.insert(raulElements.end(), _rclGrid.BeginElements(_ulX, _ulY, _ulZ), _rclGrid.EndElements(_ulX, _ulY, _ulZ)); 
   }
   else
     _bValidRay = false;  // Strahl ausgetreten
@@ -8,7 +8,9 @@
 #define MESH_GRID_H
 
 #include "stdexport.h"
+#include <functional>
 #include <set>
+#include <vector>
 
 #include "MeshKernel.h"
 #include "Base/Vector3D.h"
@@ -109,7 +111,7 @@ public:
   bool GetPositionToIndex(unsigned long id, unsigned long& ulX, unsigned long& ulY, unsigned long& ulZ) const;
   /** Returns the number of elements in a given grid. */
   unsigned long GetCtElements(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
-  { return _aulGrid[ulX][ulY][ulZ].size(); }
+  { unsigned long ulGrid = GridIndex(ulX, ulY, ulZ); return _aulOffsets[ulGrid+1] - _aulOffsets[ulGrid]; }
   /** Validates the grid structure and rebuilds it if needed. Must be implemented in sub-classes. */
   virtual void Validate (const MeshKernel &rclM) = 0;
   /** Verifies the grid structure and returns false if inconsistencies are found. */
@@ -139,9 +141,27 @@ protected:
   virtual void RebuildGrid (void) = 0;
   /** Returns the number of stored elements. Must be implemented in sub-classes. */
   virtual unsigned long HasElements (void) const = 0;
+  /** Fills the grid structure with \a ulCtElements elements. \a getGrids is called for each element
+   * and must append the indices of the grids the element lies in. It is called from several threads
+   * at the same time. Afterwards the elements of each grid are in ascending order.
+   */
+  void FillGrid (unsigned long ulCtElements,
+                 const std::function<void(unsigned long, std::vector<unsigned long>&)>& getGrids);
+  /** Returns the index of a valid grid position, the x index varies fastest. */
+  unsigned long GridIndex (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+  { return (ulZ * _ulCtGridsY + ulY) * _ulCtGridsX + ulX; }
+  /** Returns the first element of the given grid. */
+  std::vector<unsigned long>::const_iterator BeginElements (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+  { return _aulElements.begin() + _aulOffsets[GridIndex(ulX, ulY, ulZ)]; }
+  /** Returns the end of the elements of the given grid. */
+  std::vector<unsigned long>::const_iterator EndElements (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+  { return _aulElements.begin() + _aulOffsets[GridIndex(ulX, ulY, ulZ)+1]; }
 
 protected:
-  std::vector<std::vector<std::vector<std::set<unsigned long> > > >  _aulGrid;   /**< Grid data structure. */
+  /** Grid data structure: the elements of all grids are stored one grid after the other in _aulElements,
+   * the elements of grid i are in the range [_aulOffsets[i], _aulOffsets[i+1]). */
+  std::vector<unsigned long> _aulOffsets;
+  std::vector<unsigned long> _aulElements;
   const MeshKernel* _pclMesh;     /**< The mesh kernel. */
   unsigned long     _ulCtElements;/**< Number of grid elements for validation issues. */
   unsigned long     _ulCtGridsX;  /**< Number of grid elements in z. */
@@ -208,10 +228,8 @@ protected:
   inline void Pos (const Base::Vector3f &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const;
   /** Returns the grid numbers to the given point \a rclPoint. */
   inline void PosWithCheck (const Base::Vector3f &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const;
-  /** Adds a new facet element to the grid structure. \a rclFacet is the geometric facet and \a ulFacetIndex 
-   * the corresponding index in the mesh kernel. The facet is added to each grid element that intersects 
-   * the facet. */
-  inline void AddFacet (const MeshGeomFacet &rclFacet, unsigned long ulFacetIndex, float fEpsilon = 0.0f);
+  /** Appends the indices of all grid elements that intersect the facet \a rclFacet to \a raulGrids. */
+  inline void GetGrids (const MeshGeomFacet &rclFacet, std::vector<unsigned long> &raulGrids) const;
   /** Returns the number of stored elements. */
   unsigned long HasElements (void) const
   { return _pclMesh->CountFacets(); }
@@ -252,9 +270,8 @@ public:
   virtual bool Verify() const;
 
 protected:
-  /** Adds a new point element to the grid structure. \a rclPt is the geometric point and \a ulPtIndex 
-   * the corresponding index in the mesh kernel. */
-  void AddPoint (const MeshPoint &rclPt, unsigned long ulPtIndex, float fEpsilon = 0.0f);
+  /** Appends the index of the grid element the point \a rclPt lies in to \a raulGrids, if there is one. */
+  void GetGrids (const MeshPoint &rclPt, std::vector<unsigned long> &raulGrids) const;
   /** Returns the grid numbers to the given point \a rclPoint. */
   void Pos(const Base::Vector3f &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const;
   /** Returns the number of stored elements. */
@@ -279,7 +296,7 @@ public:
   /** Returns indices of the elements in the current grid. */
   void GetElements (std::vector<unsigned long> &raulElements) const
   {
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+    raulElements.insert(raulElements.end(), _rclGrid.BeginElements(_ulX, _ulY, _ulZ), _rclGrid.EndElements(_ulX, _ulY, _ulZ));
   }
   /** Returns the number of elements in the current grid. */
   unsigned long GetCtElements() const
@@ -418,38 +435,8 @@ inline void MeshFacetGrid::PosWithCheck (const Base::Vector3f &rclPoint, unsigne
   assert((rulX < _ulCtGridsX) && (rulY < _ulCtGridsY) && (rulZ < _ulCtGridsZ));
 }
 
-inline void MeshFacetGrid::AddFacet (const MeshGeomFacet &rclFacet, unsigned long ulFacetIndex, float /*fEpsilon*/)
+inline void MeshFacetGrid::GetGrids (const MeshGeomFacet &rclFacet, std::vector<unsigned long> &raulGrids) const
 {
-#if 0
-  unsigned long  i, ulX, ulY, ulZ, ulX1, ulY1, ulZ1, ulX2, ulY2, ulZ2;
-  
-  ulX1 = ulY1 = ulZ1 = ULONG_MAX;
-  ulX2 = ulY2 = ulZ2 = 0;
-
-  for (i = 0; i < 3; i++)
-  {
-    Pos(rclFacet._aclPoints[i], ulX, ulY, ulZ);
-    _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
-    ulX1 = RSmin<unsigned long>(ulX1, ulX); ulY1 = RSmin<unsigned long>(ulY1, ulY); ulZ1 = RSmin<unsigned long>(ulZ1, ulZ);
-    ulX2 = RSmax<unsigned long>(ulX2, ulX); ulY2 = RSmax<unsigned long>(ulY2, ulY); ulZ2 = RSmax<unsigned long>(ulZ2, ulZ);
-  }
-  
-  // falls Facet ueber mehrere BB reicht
-  if ((ulX1 < ulX2) || (ulY1 < ulY2) || (ulZ1 < ulZ2))
-  {
-    for (ulX = ulX1; ulX <= ulX2; ulX++)
-    {
-      for (ulY = ulY1; ulY <= ulY2; ulY++)
-      {
-        for (ulZ = ulZ1; ulZ <= ulZ2; ulZ++)
-        {
-          if (CMeshFacetFunc::BBoxContainFacet(GetBoundBox(ulX, ulY, ulZ), rclFacet) == true)
-            _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
-        }
-      }
-    }
-  }
-#else
   unsigned long ulX, ulY, ulZ;
 
   unsigned long ulX1, ulY1, ulZ1, ulX2, ulY2, ulZ2;
@@ -460,22 +447,8 @@ inline void MeshFacetGrid::AddFacet (const MeshGeomFacet &rclFacet, unsigned lon
   clBB.Add(rclFacet._aclPoints[1]);
   clBB.Add(rclFacet._aclPoints[2]);
 
-  //float fDiagonalLength = clBB.CalcDiagonalLength();
-
-  //clBB.Enlarge(fEpsilon*fDiagonalLength);
-
   Pos(Base::Vector3f(clBB.MinX,clBB.MinY,clBB.MinZ), ulX1, ulY1, ulZ1);
   Pos(Base::Vector3f(clBB.MaxX,clBB.MaxY,clBB.MaxZ), ulX2, ulY2, ulZ2);
-  
-  /*
-  if (ulX1 > 0) ulX1--;
-  if (ulY1 > 0) ulY1--;
-  if (ulZ1 > 0) ulZ1--;
-  
-  if (ulX2 < (_ulCtGridsX-1)) ulX2++;
-  if (ulY2 < (_ulCtGridsY-1)) ulY2++;
-  if (ulZ2 < (_ulCtGridsZ-1)) ulZ2++;
-  */
 
   // falls Facet ueber mehrere BB reicht
   if ((ulX1 < ulX2) || (ulY1 < ulY2) || (ulZ1 < ulZ2))
@@ -487,15 +460,13 @@ inline void MeshFacetGrid::AddFacet (const MeshGeomFacet &rclFacet, unsigned lon
         for (ulZ = ulZ1; ulZ <= ulZ2; ulZ++)
         {
           if ( rclFacet.IntersectBoundingBox( GetBoundBox(ulX, ulY, ulZ) ) )
-            _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
+            raulGrids.push_back(GridIndex(ulX, ulY, ulZ));
         }
       }
     }
   }
   else
-    _aulGrid[ulX1][ulY1][ulZ1].insert(ulFacetIndex);
-
-#endif
+    raulGrids.push_back(GridIndex(ulX1, ulY1, ulZ1));
 }
 
 } // namespace MeshCore
@@ -283,7 +283,7 @@ inline MeshFastFacetIterator::MeshFastFacetIterator (const MeshKernel &rclM)
 
 inline void MeshFastFacetIterator::Next (void)
 {
-  const unsigned long *paulPt = _clIter->_aulPoints;
+  const PointIndex *paulPt = _clIter->_aulPoints;
   Base::Vector3f *pfPt = _afPoints;
   *(pfPt++)      = _rclPAry[*(paulPt++)];
   *(pfPt++)      = _rclPAry[*(paulPt++)];
@@ -329,7 +329,7 @@ inline void MeshFacetIterator::Transform( const Base::Matrix4D& rclTrf )
 inline const MeshGeomFacet& MeshFacetIterator::Dereference (void)
 {
   MeshFacet rclF             = *_clIter;
-  const unsigned long *paulPt        = &(_clIter->_aulPoints[0]);
+  const PointIndex *paulPt           = &(_clIter->_aulPoints[0]);
   Base::Vector3f  *pclPt = _clFacet._aclPoints;
   *(pclPt++)       = _rclPAry[*(paulPt++)];
   *(pclPt++)       = _rclPAry[*(paulPt++)];
@@ -375,17 +375,17 @@ inline unsigned long MeshFacetIterator::GetProperty (void) const
 
 inline void MeshFacetIterator::GetNeighbours (MeshFacetIterator &rclN0, MeshFacetIterator &rclN1, MeshFacetIterator &rclN2) const
 {
-  if (_clIter->_aulNeighbours[0] != ULONG_MAX)
+  if (_clIter->_aulNeighbours[0] != FACET_INDEX_MAX)
     rclN0.Set(_clIter->_aulNeighbours[0]);
   else
     rclN0.End();
 
-  if (_clIter->_aulNeighbours[1] != ULONG_MAX)
+  if (_clIter->_aulNeighbours[1] != FACET_INDEX_MAX)
     rclN1.Set(_clIter->_aulNeighbours[1]);
   else
     rclN1.End();
 
-  if (_clIter->_aulNeighbours[2] != ULONG_MAX)
+  if (_clIter->_aulNeighbours[2] != FACET_INDEX_MAX)
     rclN2.Set(_clIter->_aulNeighbours[2]);
   else
     rclN2.End();
@@ -393,7 +393,7 @@ inline void MeshFacetIterator::GetNeighbours (MeshFacetIterator &rclN0, MeshFace
 
 inline void MeshFacetIterator::SetToNeighbour (unsigned short usN)
 { 
-  if (_clIter->_aulNeighbours[usN] != ULONG_MAX)
+  if (_clIter->_aulNeighbours[usN] != FACET_INDEX_MAX)
     _clIter = _rclFAry.begin() + _clIter->_aulNeighbours[usN];
   else
     End();
@@ -91,7 +91,7 @@ unsigned long MeshKDTree::FindNearest(const Base::Vector3f& p, Base::Vector3f& n
     std::pair<MyKDTree::const_iterator, MyKDTree::distance_type> it =
         d->kd_tree.find_nearest(Point3d(p,0));
     if (it.first == d->kd_tree.end())
-        return ULONG_MAX;
+        return POINT_INDEX_MAX;
     unsigned long index = it.first->i;
     n = it.first->p;
     dist = it.second;
@@ -104,7 +104,7 @@ unsigned long MeshKDTree::FindNearest(const Base::Vector3f& p, float max_dist,
     std::pair<MyKDTree::const_iterator, MyKDTree::distance_type> it =
         d->kd_tree.find_nearest(Point3d(p,0), max_dist);
     if (it.first == d->kd_tree.end())
-        return ULONG_MAX;
+        return POINT_INDEX_MAX;
     unsigned long index = it.first->i;
     n = it.first->p;
     dist = it.second;
@@ -116,7 +116,7 @@ unsigned long MeshKDTree::FindExact(const Base::Vector3f& p) const
     MyKDTree::const_iterator it = 
         d->kd_tree.find_exact(Point3d(p,0));
     if (it == d->kd_tree.end())
-        return ULONG_MAX;
+        return POINT_INDEX_MAX;
     unsigned long index = it->i;
     return index;
 }
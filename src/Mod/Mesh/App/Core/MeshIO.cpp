@@ -20,6 +20,7 @@
 #include "Base/FileInfo.h"
 #include "Base/Sequencer.h"
 #include "Base/Stream.h"
+#include "Base/Swap.h"
 #include "Base/Placement.h"
 #include "Base/Tools.h"
 
@@ -30,6 +31,8 @@
 #include <boost/regex.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
+#include <QFile>
+#include <QtConcurrentMap>
 
 
 using namespace MeshCore;
@@ -116,6 +119,16 @@ struct Color_Less  : public std::binary_function<const App::Color&,
     }
 };
 
+/** Checks the data after the 80 bytes header of an STL file for the keywords
+ * of the ASCII format. The passed string gets converted to upper case.
+ */
+static bool hasAsciiKeywords(char* szBuf)
+{
+    upper(szBuf);
+    return ((strstr(szBuf, "SOLID") != NULL)  || (strstr(szBuf, "FACET") != NULL)    || (strstr(szBuf, "NORMAL") != NULL) ||
+            (strstr(szBuf, "VERTEX") != NULL) || (strstr(szBuf, "ENDFACET") != NULL) || (strstr(szBuf, "ENDLOOP") != NULL));
+}
+
 }
 
 // --------------------------------------------------------------
@@ -138,7 +151,27 @@ bool MeshInput::LoadAny(const char* FileName)
     else {
         // read file
         bool ok = false;
-        if (fi.hasExtension(".stl") || fi.hasExtension(".ast")) {
+        if (fi.hasExtension(".stl")) {
+            // Binary files are loaded from a memory mapping, the header check
+            // is the same as in LoadSTL()
+            char szBuf[101];
+            uint32_t ulCt = 0;
+            str.seekg(80, std::ios::beg);
+            str.read((char*)&ulCt, sizeof(ulCt));
+            std::streamsize ulBytes = ulCt > 1 ? 100 : 50;
+            bool binary = false;
+            if (str.read(szBuf, ulBytes)) {
+                szBuf[ulBytes] = 0;
+                binary = !hasAsciiKeywords(szBuf);
+            }
+            str.clear();
+            str.seekg(0, std::ios::beg);
+            if (binary)
+                ok = LoadBinarySTL(FileName);
+            else
+                ok = LoadSTL(str);
+        }
+        else if (fi.hasExtension(".ast")) {
             ok = LoadSTL(str);
         }
         else if (fi.hasExtension(".iv")) {
@@ -224,11 +257,9 @@ bool MeshInput::LoadSTL (std::istream &rstrIn)
     if (!rstrIn.read(szBuf, ulBytes))
         return (ulCt==0);
     szBuf[ulBytes] = 0;
-    upper(szBuf);
 
     try {
-        if ((strstr(szBuf, "SOLID") == NULL)  && (strstr(szBuf, "FACET") == NULL)    && (strstr(szBuf, "NORMAL") == NULL) &&
-            (strstr(szBuf, "VERTEX") == NULL) && (strstr(szBuf, "ENDFACET") == NULL) && (strstr(szBuf, "ENDLOOP") == NULL)) {
+        if (!hasAsciiKeywords(szBuf)) {
             // probably binary STL
             buf->pubseekoff(0, std::ios::beg, std::ios::in);
             return LoadBinarySTL(rstrIn);
@@ -650,6 +681,55 @@ namespace MeshCore {
                 return x.first == y;
             }
         };
+        inline std::size_t sizeOf(Number n)
+        {
+            switch (n) {
+            case int8:
+            case uint8:
+                return 1;
+            case int16:
+            case uint16:
+                return 2;
+            case int32:
+            case uint32:
+            case float32:
+                return 4;
+            case float64:
+                return 8;
+            }
+            return 0;
+        }
+        template <typename T>
+        inline float decode(const char* src, bool swap)
+        {
+            T v;
+            std::memcpy(&v, src, sizeof(T));
+            if (swap)
+                Base::SwapEndian<T>(v);
+            return static_cast<float>(v);
+        }
+        inline float decode(const char* src, Number n, bool swap)
+        {
+            switch (n) {
+            case int8:
+                return decode<int8_t>(src, swap);
+            case uint8:
+                return decode<uint8_t>(src, swap);
+            case int16:
+                return decode<int16_t>(src, swap);
+            case uint16:
+                return decode<uint16_t>(src, swap);
+            case int32:
+                return decode<int32_t>(src, swap);
+            case uint32:
+                return decode<uint32_t>(src, swap);
+            case float32:
+                return decode<float>(src, swap);
+            case float64:
+                return decode<double>(src, swap);
+            }
+            return 0.0f;
+        }
     }
     using namespace Ply;
 }
@@ -980,69 +1060,66 @@ bool MeshInput::LoadPLY (std::istream &inp)
         else
             is.setByteOrder(Base::Stream::BigEndian);
 
-        for (std::size_t i = 0; i < v_count; i++) {
-            // go through the vertex properties
-            std::map<std::string, float> prop_values;
-            for (std::vector<std::pair<std::string, Number> >::iterator it = vertex_props.begin(); it != vertex_props.end(); ++it) {
-                switch (it->second) {
-                case int8:
-                    {
-                        int8_t v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
-                    } break;
-                case uint8:
-                    {
-                        uint8_t v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
-                    } break;
-                case int16:
-                    {
-                        int16_t v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
-                    } break;
-                case uint16:
-                    {
-                        uint16_t v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
-                    } break;
-                case int32:
-                    {
-                        int32_t v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
-                    } break;
-                case uint32:
-                    {
-                        uint32_t v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
-                    } break;
-                case float32:
-                    {
-                        float v; is >> v;
-                        prop_values[it->first] = v;
-                    } break;
-                case float64:
-                    {
-                        double v; is >> v;
-                        prop_values[it->first] = static_cast<float>(v);
-                    } break;
-                default:
-                    return false;
+        // All vertex properties are scalars, so every vertex record has the same
+        // size. Read the whole vertex block at once and decode it in parallel.
+        std::size_t v_size = 0;
+        std::map<std::string, std::pair<std::size_t, Number> > offsets;
+        for (std::vector<std::pair<std::string, Number> >::iterator it = vertex_props.begin(); it != vertex_props.end(); ++it) {
+            offsets[it->first] = std::make_pair(v_size, it->second);
+            v_size += Ply::sizeOf(it->second);
+        }
+
+        std::vector<char> block(v_count * v_size);
+        if (!block.empty() && !inp.read(&block[0], block.size()))
+            return false;
+
+        // the positions of the coordinates and colors in a record
+        typedef std::map<std::string, std::pair<std::size_t, Number> >::const_iterator OffsetIterator;
+        OffsetIterator ix = offsets.find("x"), iy = offsets.find("y"), iz = offsets.find("z");
+        if (ix == offsets.end() || iy == offsets.end() || iz == offsets.end())
+            return false;
+        OffsetIterator ir = offsets.find("red"), ig = offsets.find("green"), ib = offsets.find("blue");
+        bool hasColors = (ir != offsets.end() && ig != offsets.end() && ib != offsets.end());
+        if (rgb_value == MeshIO::PER_VERTEX && !hasColors)
+            return false;
+
+        meshPoints.resize(v_count);
+        App::Color* colors = 0;
+        if (_material && (rgb_value == MeshIO::PER_VERTEX) && v_count > 0) {
+            std::size_t first = _material->diffuseColor.size();
+            _material->diffuseColor.resize(first + v_count);
+            colors = &_material->diffuseColor[first];
+        }
+
+        const bool swap = (format == binary_big_endian);
+        const std::pair<std::size_t, Number> px = ix->second, py = iy->second, pz = iz->second;
+        const std::pair<std::size_t, Number> pr = hasColors ? ir->second : px;
+        const std::pair<std::size_t, Number> pg = hasColors ? ig->second : px;
+        const std::pair<std::size_t, Number> pb = hasColors ? ib->second : px;
+        const char* data = block.empty() ? 0 : &block[0];
+        MeshPoint* points = meshPoints.empty() ? 0 : &meshPoints[0];
+
+        // fixed chunk size so that the result doesn't depend on the number of threads
+        const std::size_t chunkSize = 65536;
+        std::vector<std::size_t> chunks;
+        for (std::size_t i = 0; i < v_count; i += chunkSize)
+            chunks.push_back(i);
+
+        QtConcurrent::blockingMap(chunks, [=](std::size_t start) {
+            std::size_t end = std::min(start + chunkSize, v_count);
+            for (std::size_t i = start; i < end; i++) {
+                const char* record = data + i * v_size;
+                points[i].x = Ply::decode(record + px.first, px.second, swap);
+                points[i].y = Ply::decode(record + py.first, py.second, swap);
+                points[i].z = Ply::decode(record + pz.first, pz.second, swap);
+                if (colors) {
+                    float r = Ply::decode(record + pr.first, pr.second, swap) / 255.0f;
+                    float g = Ply::decode(record + pg.first, pg.second, swap) / 255.0f;
+                    float b = Ply::decode(record + pb.first, pb.second, swap) / 255.0f;
+                    colors[i] = App::Color(r, g, b);
                 }
             }
-
-            Base::Vector3f pt;
-            pt.x = (prop_values["x"]);
-            pt.y = (prop_values["y"]);
-            pt.z = (prop_values["z"]);
-            meshPoints.push_back(pt);
-
-            if (_material && (rgb_value == MeshIO::PER_VERTEX)) {
-                float r = (prop_values["red"]) / 255.0f;
-                float g = (prop_values["green"]) / 255.0f;
-                float b = (prop_values["blue"]) / 255.0f;
-                _material->diffuseColor.push_back(App::Color(r, g, b));
-            }
-        }
+        });
 
         unsigned char n;
         uint32_t f1, f2, f3;
@@ -1301,6 +1378,42 @@ bool MeshInput::LoadBinarySTL (std::istream &rstrIn)
     return true;
 }
 
+/** Loads a binary STL file from a memory mapping. */
+bool MeshInput::LoadBinarySTL (const char* FileName)
+{
+    QFile file(QString::fromUtf8(FileName));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    qint64 ulSize = file.size();
+    const qint64 ulHeader = 80 + sizeof(uint32_t);
+    if (ulSize < ulHeader)
+        return false;
+
+    const char* data = reinterpret_cast<const char*>(file.map(0, ulSize));
+    if (!data) {
+        // mapping is not supported, e.g. for some special files
+        Base::ifstream str(Base::FileInfo(FileName), std::ios::in | std::ios::binary);
+        return LoadBinarySTL(str);
+    }
+
+    uint32_t ulCt = 0;
+    std::memcpy(&ulCt, data + 80, sizeof(ulCt));
+
+    // compare the calculated with the read value
+    uint64_t ulFac = (ulSize - ulHeader) / 50;
+    if (ulCt > ulFac)
+        return false;// not a valid STL file
+
+    MeshFastBuilder builder(this->_rclMesh);
+    builder.Initialize(ulCt);
+    // each record has a normal, three points and a 2 bytes attribute
+    builder.AddFacets(data + ulHeader + 3 * sizeof(float), ulCt, 50);
+    builder.Finish();
+
+    return true;
+}
+
 /** Loads the mesh object from an XML file. */
 void MeshInput::LoadXML (Base::XMLReader &reader)
 {
@@ -3224,7 +3337,7 @@ void MeshPointFacetAdjacency::SetFacetNeighbourhood()
             }
 
             if (!success) {
-                facet1._aulNeighbours[i] = ULONG_MAX;
+                facet1._aulNeighbours[i] = FACET_INDEX_MAX;
             }
         }
     }
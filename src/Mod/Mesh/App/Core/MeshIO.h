@@ -92,6 +92,11 @@ public:
     bool LoadAsciiSTL (std::istream &rstrIn);
     /** Loads a binary STL file. */
     bool LoadBinarySTL (std::istream &rstrIn);
+    /** Loads a binary STL file by mapping it into memory and decoding the
+     * facets in parallel. Falls back to the stream version if the file
+     * cannot be mapped.
+     */
+    bool LoadBinarySTL (const char* FileName);
     /** Loads an OBJ Mesh file. */
     bool LoadOBJ (std::istream &rstrIn);
     /** Loads an SMF Mesh file. */
@@ -10,6 +10,7 @@
 # include <map>
 # include <queue>
 
+#include "Base/ColumnStream.h"
 #include "Base/Exception.h"
 #include "Base/Sequencer.h"
 #include "Base/Stream.h"
@@ -265,13 +266,13 @@ unsigned long MeshKernel::AddFacets(const std::vector<MeshFacet> &rclFAry,
                 if (!pF->IsFlag(MeshFacet::INVALID))
                     ulF0 = pF->_ulProp;
                 else
-                    ulF0 = ULONG_MAX;
+                    ulF0 = FACET_INDEX_MAX;
             }
 
-            if (ulF0 != ULONG_MAX) {
+            if (ulF0 != FACET_INDEX_MAX) {
                 unsigned short usSide =  _aclFacetArray[ulF0].Side(ulP0, ulP1);
                 assert(usSide != USHRT_MAX);
-                _aclFacetArray[ulF0]._aulNeighbours[usSide] = ULONG_MAX;
+                _aclFacetArray[ulF0]._aulNeighbours[usSide] = FACET_INDEX_MAX;
             }
         }
         else if (pE->second.size() == 2)  // normal facet with neighbour
@@ -284,7 +285,7 @@ unsigned long MeshKernel::AddFacets(const std::vector<MeshFacet> &rclFAry,
                 if (!pF->IsFlag(MeshFacet::INVALID))
                     ulF0 = pF->_ulProp;
                 else
-                    ulF0 = ULONG_MAX;
+                    ulF0 = FACET_INDEX_MAX;
             }
             unsigned long ulF1 = pE->second.back();
             if (ulF1 >= countFacets) {
@@ -293,16 +294,16 @@ unsigned long MeshKernel::AddFacets(const std::vector<MeshFacet> &rclFAry,
                 if (!pF->IsFlag(MeshFacet::INVALID))
                     ulF1 = pF->_ulProp;
                 else
-                    ulF1 = ULONG_MAX;
+                    ulF1 = FACET_INDEX_MAX;
             }
             
-            if (ulF0 != ULONG_MAX) {
+            if (ulF0 != FACET_INDEX_MAX) {
                 unsigned short usSide = _aclFacetArray[ulF0].Side(ulP0, ulP1);
                 assert(usSide != USHRT_MAX);
                 _aclFacetArray[ulF0]._aulNeighbours[usSide] = ulF1;
             }
 
-            if (ulF1 != ULONG_MAX) {
+            if (ulF1 != FACET_INDEX_MAX) {
                 unsigned short usSide = _aclFacetArray[ulF1].Side(ulP0, ulP1);
                 assert(usSide != USHRT_MAX);
                 _aclFacetArray[ulF1]._aulNeighbours[usSide] = ulF0;
@@ -416,10 +417,10 @@ bool MeshKernel::DeleteFacet (const MeshFacetIterator &rclIter)
     // invalidate neighbour indices of the neighbour facet to this facet
     for (i = 0; i < 3; i++) {
         ulNFacet = rclIter._clIter->_aulNeighbours[i];
-        if (ulNFacet != ULONG_MAX) {
+        if (ulNFacet != FACET_INDEX_MAX) {
             for (j = 0; j < 3; j++) {
                 if (_aclFacetArray[ulNFacet]._aulNeighbours[j] == ulInd) {
-                    _aclFacetArray[ulNFacet]._aulNeighbours[j] = ULONG_MAX;
+                    _aclFacetArray[ulNFacet]._aulNeighbours[j] = FACET_INDEX_MAX;
                     break;
                 }
             }
@@ -428,8 +429,8 @@ bool MeshKernel::DeleteFacet (const MeshFacetIterator &rclIter)
 
     // erase corner point if needed
     for (i = 0; i < 3; i++) {
-        if ((rclIter._clIter->_aulNeighbours[i] == ULONG_MAX) &&
-            (rclIter._clIter->_aulNeighbours[(i+1)%3] == ULONG_MAX)) {
+        if ((rclIter._clIter->_aulNeighbours[i] == FACET_INDEX_MAX) &&
+            (rclIter._clIter->_aulNeighbours[(i+1)%3] == FACET_INDEX_MAX)) {
             // no neighbours, possibly delete point
             ErasePoint(rclIter._clIter->_aulPoints[(i+1)%3], ulInd);
         }
@@ -670,11 +671,11 @@ void MeshKernel::RemoveInvalids ()
         if (pFIter->IsValid() == true) {
             for (i = 0; i < 3; i++) {
                 k = pFIter->_aulNeighbours[i];
-                if (k != ULONG_MAX) {
+                if (k != FACET_INDEX_MAX) {
                     if (_aclFacetArray[k].IsValid() == true)
                         pFIter->_aulNeighbours[i] -= aulDecrements[k];
                     else
-                        pFIter->_aulNeighbours[i] = ULONG_MAX;
+                        pFIter->_aulNeighbours[i] = FACET_INDEX_MAX;
                 }
             }
         }
@@ -792,18 +793,37 @@ void MeshKernel::Write (std::ostream &rclOut) const
     // write the number of points and facets
     str << (uint32_t)CountPoints() << (uint32_t)CountFacets();
 
-    // write the data
-    for (MeshPointArray::_TConstIterator it = _aclPointArray.begin(); it != _aclPointArray.end(); ++it) {
-        str << it->x << it->y << it->z;
+    // write the data in blocks
+    const std::size_t blockSize = 65536;
+    std::vector<float> coords;
+    coords.reserve(3 * std::min<std::size_t>(_aclPointArray.size(), blockSize));
+    for (std::size_t i = 0; i < _aclPointArray.size(); i += blockSize) {
+        std::size_t end = std::min(i + blockSize, _aclPointArray.size());
+        coords.clear();
+        for (std::size_t j = i; j < end; j++) {
+            const MeshPoint& p = _aclPointArray[j];
+            coords.push_back(p.x);
+            coords.push_back(p.y);
+            coords.push_back(p.z);
+        }
+        str.write(&coords[0], coords.size());
     }
 
-    for (MeshFacetArray::_TConstIterator it = _aclFacetArray.begin(); it != _aclFacetArray.end(); ++it) {
-        str << (uint32_t)it->_aulPoints[0] 
-            << (uint32_t)it->_aulPoints[1] 
-            << (uint32_t)it->_aulPoints[2];
-        str << (uint32_t)it->_aulNeighbours[0] 
-            << (uint32_t)it->_aulNeighbours[1] 
-            << (uint32_t)it->_aulNeighbours[2];
+    std::vector<uint32_t> indices;
+    indices.reserve(6 * std::min<std::size_t>(_aclFacetArray.size(), blockSize));
+    for (std::size_t i = 0; i < _aclFacetArray.size(); i += blockSize) {
+        std::size_t end = std::min(i + blockSize, _aclFacetArray.size());
+        indices.clear();
+        for (std::size_t j = i; j < end; j++) {
+            const MeshFacet& f = _aclFacetArray[j];
+            indices.push_back((uint32_t)f._aulPoints[0]);
+            indices.push_back((uint32_t)f._aulPoints[1]);
+            indices.push_back((uint32_t)f._aulPoints[2]);
+            indices.push_back((uint32_t)f._aulNeighbours[0]);
+            indices.push_back((uint32_t)f._aulNeighbours[1]);
+            indices.push_back((uint32_t)f._aulNeighbours[2]);
+        }
+        str.write(&indices[0], indices.size());
     }
 
     str << _clBoundBox.MinX << _clBoundBox.MaxX;
@@ -811,6 +831,89 @@ void MeshKernel::Write (std::ostream &rclOut) const
     str << _clBoundBox.MinZ << _clBoundBox.MaxZ;
 }
 
+void MeshKernel::WriteCompressed (std::ostream &rclOut, float precision) const
+{
+    if (!rclOut || rclOut.bad())
+        return;
+
+    Base::OutputStream str(rclOut);
+
+    // Write a header with a "magic number" and a version
+    str << (uint32_t)0xA0B0C0D0;
+    str << (uint32_t)0x020000;
+
+    // write the number of points and facets
+    std::size_t ctPoints = CountPoints();
+    std::size_t ctFacets = CountFacets();
+    str << (uint32_t)ctPoints << (uint32_t)ctFacets;
+
+    // write the coordinates and the point indices column by column
+    Base::ColumnWriter columns(rclOut);
+    std::vector<float> coords(ctPoints);
+    for (int k = 0; k < 3; k++) {
+        for (std::size_t i = 0; i < ctPoints; i++)
+            coords[i] = _aclPointArray[i][k];
+        columns.writeFloats(coords.data(), ctPoints, 1, precision);
+    }
+    std::vector<float>().swap(coords);
+
+    std::vector<uint32_t> indices(ctFacets);
+    for (int k = 0; k < 3; k++) {
+        for (std::size_t i = 0; i < ctFacets; i++)
+            indices[i] = (uint32_t)_aclFacetArray[i]._aulPoints[k];
+        columns.writeIndices(indices.data(), ctFacets);
+    }
+}
+
+void MeshKernel::ReadCompressed (std::istream &rclIn)
+{
+    Base::InputStream str(rclIn);
+
+    // read the number of points and facets
+    uint32_t uCtPts=0, uCtFts=0;
+    str >> uCtPts >> uCtFts;
+    if (!rclIn)
+        throw Base::BadFormatError("Reading from stream failed");
+
+    try {
+        Base::ColumnReader columns(rclIn);
+        MeshPointArray pointArray;
+        pointArray.resize(uCtPts);
+        std::vector<float> coords(uCtPts);
+        for (int k = 0; k < 3; k++) {
+            columns.readFloats(coords.data(), uCtPts);
+            for (std::size_t i = 0; i < uCtPts; i++)
+                pointArray[i][k] = coords[i];
+        }
+        std::vector<float>().swap(coords);
+
+        MeshFacetArray facetArray;
+        facetArray.resize(uCtFts);
+        std::vector<uint32_t> indices(uCtFts);
+        for (int k = 0; k < 3; k++) {
+            columns.readIndices(indices.data(), uCtFts);
+            for (std::size_t i = 0; i < uCtFts; i++) {
+                // make sure to have valid indices
+                if (indices[i] >= uCtPts)
+                    throw Base::BadFormatError("Invalid data structure");
+                facetArray[i]._aulPoints[k] = indices[i];
+            }
+        }
+
+        // If we reach this block no exception occurred and we can safely assign the mesh
+        _aclPointArray.swap(pointArray);
+        _aclFacetArray.swap(facetArray);
+    }
+    catch (std::exception&) {
+        // Special handling of std::length_error
+        throw Base::BadFormatError("Reading from stream failed");
+    }
+
+    // the neighbourhood and the bounding box are not stored
+    RebuildNeighbours();
+    RecalcBoundBox();
+}
+
 void MeshKernel::Read (std::istream &rclIn)
 {
     if (!rclIn || rclIn.bad())
@@ -826,6 +929,13 @@ void MeshKernel::Read (std::istream &rclIn)
     swap_version = version; Base::SwapEndian(swap_version);
     uint32_t open_edge = 0xffffffff; // value to mark an open edge
 
+    // the compressed format is written in the byte order of the host and is
+    // only recognized on a host with the same byte order
+    if (magic == 0xA0B0C0D0 && version == 0x020000) {
+        ReadCompressed(rclIn);
+        return;
+    }
+
     // is it the new or old format?
     bool new_format = false;
     if (magic == 0xA0B0C0D0 && version == 0x010000) {
@@ -845,56 +955,58 @@ void MeshKernel::Read (std::istream &rclIn)
         str >> uCtPts >> uCtFts;
 
         try {
-            // read the data
+            // read the data in blocks
+            const std::size_t blockSize = 65536;
             MeshPointArray pointArray;
             pointArray.resize(uCtPts);
-            for (MeshPointArray::_TIterator it = pointArray.begin(); it != pointArray.end(); ++it) {
-                str >> it->x >> it->y >> it->z;
+            std::vector<float> coords;
+            for (std::size_t i = 0; i < pointArray.size(); i += blockSize) {
+                std::size_t end = std::min<std::size_t>(i + blockSize, pointArray.size());
+                coords.resize(3 * (end - i));
+                str.read(&coords[0], coords.size());
+                const float* c = &coords[0];
+                for (std::size_t j = i; j < end; j++, c += 3) {
+                    pointArray[j].Set(c[0], c[1], c[2]);
+                }
             }
-          
+
             MeshFacetArray facetArray;
             facetArray.resize(uCtFts);
 
-            uint32_t v1, v2, v3;
-            for (MeshFacetArray::_TIterator it = facetArray.begin(); it != facetArray.end(); ++it) {
-                str >> v1 >> v2 >> v3;
-
-                // make sure to have valid indices
-                if (v1 >= uCtPts || v2 >= uCtPts || v3 >= uCtPts)
-                    throw Base::BadFormatError("Invalid data structure");
-
-                it->_aulPoints[0] = v1;
-                it->_aulPoints[1] = v2;
-                it->_aulPoints[2] = v3;
-
-                // On systems where an 'unsigned long' is a 64-bit value
-                // the empty neighbour must be explicitly set to 'ULONG_MAX'
-                // because in algorithms this value is always used to check
-                // for open edges.
-                str >> v1 >> v2 >> v3;
-
-                // make sure to have valid indices
-                if (v1 >= uCtFts && v1 < open_edge)
-                    throw Base::BadFormatError("Invalid data structure");
-                if (v2 >= uCtFts && v2 < open_edge)
-                    throw Base::BadFormatError("Invalid data structure");
-                if (v3 >= uCtFts && v3 < open_edge)
-                    throw Base::BadFormatError("Invalid data structure");
-
-                if (v1 < open_edge)
-                    it->_aulNeighbours[0] = v1;
-                else
-                    it->_aulNeighbours[0] = ULONG_MAX;
-
-                if (v2 < open_edge)
-                    it->_aulNeighbours[1] = v2;
-                else
-                    it->_aulNeighbours[1] = ULONG_MAX;
-
-                if (v3 < open_edge)
-                    it->_aulNeighbours[2] = v3;
-                else
-                    it->_aulNeighbours[2] = ULONG_MAX;
+            std::vector<uint32_t> indices;
+            for (std::size_t i = 0; i < facetArray.size(); i += blockSize) {
+                std::size_t end = std::min<std::size_t>(i + blockSize, facetArray.size());
+                indices.resize(6 * (end - i));
+                str.read(&indices[0], indices.size());
+                const uint32_t* v = &indices[0];
+                for (std::size_t j = i; j < end; j++, v += 6) {
+                    MeshFacet& f = facetArray[j];
+
+                    // make sure to have valid indices
+                    if (v[0] >= uCtPts || v[1] >= uCtPts || v[2] >= uCtPts)
+                        throw Base::BadFormatError("Invalid data structure");
+
+                    f._aulPoints[0] = v[0];
+                    f._aulPoints[1] = v[1];
+                    f._aulPoints[2] = v[2];
+
+                    // On systems where an 'unsigned long' is a 64-bit value
+                    // the empty neighbour must be explicitly set to 'FACET_INDEX_MAX'
+                    // because in algorithms this value is always used to check
+                    // for open edges.
+                    for (int k = 0; k < 3; k++) {
+                        uint32_t n = v[3 + k];
+
+                        // make sure to have valid indices
+                        if (n >= uCtFts && n < open_edge)
+                            throw Base::BadFormatError("Invalid data structure");
+
+                        if (n < open_edge)
+                            f._aulNeighbours[k] = n;
+                        else
+                            f._aulNeighbours[k] = FACET_INDEX_MAX;
+                    }
+                }
             }
 
             str >> _clBoundBox.MinX >> _clBoundBox.MaxX;
@@ -973,7 +1085,7 @@ void MeshKernel::Read (std::istream &rclIn)
             for (int i=0; i<3; i++) {
                 if (it->_aulPoints[i] >= uCtPts)
                     throw Base::BadFormatError("Invalid data structure");
-                if (it->_aulNeighbours[i] < ULONG_MAX && it->_aulNeighbours[i] >= uCtFts)
+                if (it->_aulNeighbours[i] < FACET_INDEX_MAX && it->_aulNeighbours[i] >= uCtFts)
                     throw Base::BadFormatError("Invalid data structure");
             }
         }
@@ -1128,7 +1240,7 @@ void MeshKernel::GetEdges (std::vector<MeshGeomEdge>& edges) const
         MeshGeomEdge edge;
         edge._aclPoints[0] = this->_aclPointArray[it2->pt1];
         edge._aclPoints[1] = this->_aclPointArray[it2->pt2];
-        edge._bBorder = it2->facetIdx == ULONG_MAX;
+        edge._bBorder = it2->facetIdx == FACET_INDEX_MAX;
 
         edges.push_back(edge);
     }
@@ -1140,7 +1252,7 @@ unsigned long MeshKernel::CountEdges (void) const
 
     for (MeshFacetArray::_TConstIterator it = _aclFacetArray.begin(); it != _aclFacetArray.end(); ++it) {
         for (int i = 0; i < 3; i++) {
-            if (it->_aulNeighbours[i] == ULONG_MAX)
+            if (it->_aulNeighbours[i] == FACET_INDEX_MAX)
                 openEdges++;
             else
                 closedEdges++;
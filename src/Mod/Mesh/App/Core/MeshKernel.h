@@ -60,6 +60,13 @@ public:
     //@{
     /// Binary streaming of data
     void Write (std::ostream &rclOut) const;
+    /** Binary streaming of data in a compact form. The coordinates and point
+     * indices are stored column-wise, delta-coded and compressed. The neighbourhood
+     * of the facets isn't stored but rebuilt by Read(). If \a precision is greater
+     * than 0 the coordinates are rounded to multiples of \a precision.
+     * The data is written in the byte order of the host.
+     */
+    void WriteCompressed (std::ostream &rclOut, float precision = 0.0f) const;
     void Read (std::istream &rclIn);
     //@}
 
@@ -408,6 +415,8 @@ public:
     //@}
 
 protected:
+    /** Reads the data written by WriteCompressed() after the header. */
+    void ReadCompressed (std::istream &rclIn);
     /** Rebuilds the neighbour indices for subset of all facets from index \a index on. */
     void RebuildNeighbours (unsigned long);
     /** Checks if this point is associated to no other facet and deletes if so.
@@ -4,6 +4,9 @@
  ***************************************************************************/
 
 #include <algorithm>
+#include <queue>
+
+#include <QtConcurrentMap>
 
 #include "Segmentation.h"
 #include "Algorithm.h"
@@ -474,7 +477,7 @@ void MeshSegmentAlgorithm::FindSegments(std::vector<MeshSurfaceSegment*>& segm)
         iCur = std::find_if(iBeg, iEnd, std::bind2nd(MeshCore::MeshIsNotFlag<MeshCore::MeshFacet>(),
             MeshCore::MeshFacet::VISIT));
         startFacet = iCur - iBeg;
-        while (startFacet != ULONG_MAX) {
+        while (startFacet != FACET_INDEX_MAX) {
             // collect all facets of the same geometry
             std::vector<unsigned long> indices;
             (*it)->Initialize(startFacet);
@@ -497,7 +500,227 @@ void MeshSegmentAlgorithm::FindSegments(std::vector<MeshSurfaceSegment*>& segm)
             if (iCur < iEnd)
                 startFacet = iCur - iBeg;
             else
-                startFacet = ULONG_MAX;
+                startFacet = FACET_INDEX_MAX;
+        }
+    }
+}
+
+void MeshSegmentAlgorithm::FindSegmentsParallel(std::vector<MeshSurfaceSegment*>& segm)
+{
+    // The facets that belong to a segment are not available for the following segments
+    std::vector<char> visited(myKernel.CountFacets(), 0);
+    for (std::vector<MeshSurfaceSegment*>::iterator it = segm.begin(); it != segm.end(); ++it) {
+        if ((*it)->IsStateless())
+            GrowSegmentsParallel(**it, visited);
+        else
+            GrowSegments(**it, visited);
+    }
+}
+
+void MeshSegmentAlgorithm::GrowSegments(MeshSurfaceSegment& segm, std::vector<char>& visited) const
+{
+    // Same as FindSegments() but with the visit state kept in 'visited'
+    const MeshFacetArray& rFAry = myKernel.GetFacets();
+    unsigned long numFacets = rFAry.size();
+    std::vector<char> current(visited);
+    std::vector<unsigned long> level, next;
+
+    for (unsigned long startFacet = 0; startFacet < numFacets; startFacet++) {
+        if (current[startFacet])
+            continue;
+
+        std::vector<unsigned long> indices;
+        segm.Initialize(startFacet);
+        if (segm.TestInitialFacet(startFacet))
+            indices.push_back(startFacet);
+
+        current[startFacet] = 1;
+        level.clear();
+        level.push_back(startFacet);
+        while (!level.empty()) {
+            next.clear();
+            for (std::vector<unsigned long>::iterator jt = level.begin(); jt != level.end(); ++jt) {
+                const MeshFacet& face = rFAry[*jt];
+                for (int i = 0; i < 3; i++) {
+                    unsigned long nb = face._aulNeighbours[i];
+                    if (nb >= numFacets || current[nb])
+                        continue;
+                    if (!segm.TestFacet(rFAry[nb]))
+                        continue;
+                    current[nb] = 1;
+                    next.push_back(nb);
+                    indices.push_back(nb);
+                    segm.AddFacet(rFAry[nb]);
+                }
+            }
+            level.swap(next);
         }
+
+        // add or discard the segment, only the start facet becomes available again
+        for (std::vector<unsigned long>::iterator jt = indices.begin(); jt != indices.end(); ++jt) {
+            if (*jt != startFacet)
+                visited[*jt] = 1;
+        }
+        if (indices.size() > 1) {
+            segm.AddSegment(indices);
+            visited[startFacet] = 1;
+        }
+    }
+}
+
+namespace MeshCore {
+
+class MeshSegmentUnion
+{
+public:
+    MeshSegmentUnion(unsigned long size) : parent(size)
+    {
+        for (unsigned long i = 0; i < size; i++)
+            parent[i] = i;
+    }
+    unsigned long Find(unsigned long index)
+    {
+        while (parent[index] != index) {
+            parent[index] = parent[parent[index]];
+            index = parent[index];
+        }
+        return index;
+    }
+    void Unite(unsigned long index1, unsigned long index2)
+    {
+        // the smaller index becomes the root
+        index1 = Find(index1);
+        index2 = Find(index2);
+        if (index1 < index2)
+            parent[index2] = index1;
+        else if (index2 < index1)
+            parent[index1] = index2;
+    }
+
+private:
+    std::vector<unsigned long> parent;
+};
+
+}
+
+void MeshSegmentAlgorithm::GrowSegmentsParallel(MeshSurfaceSegment& segm, std::vector<char>& visited) const
+{
+    const MeshFacetArray& rFAry = myKernel.GetFacets();
+    const MeshPointArray& rPAry = myKernel.GetPoints();
+    const unsigned long numFacets = rFAry.size();
+    if (numFacets == 0)
+        return;
+
+    // test each facet only once
+    std::vector<char> accepted(numFacets, 0);
+    const unsigned long rangeSize = 4096;
+    std::vector<std::pair<unsigned long, unsigned long> > ranges;
+    for (unsigned long i = 0; i < numFacets; i += rangeSize)
+        ranges.push_back(std::make_pair(i, std::min(i + rangeSize, numFacets)));
+
+    QtConcurrent::blockingMap(ranges, [&](const std::pair<unsigned long, unsigned long>& range) {
+        for (unsigned long i = range.first; i < range.second; i++) {
+            if (!visited[i] && segm.TestFacet(rFAry[i]))
+                accepted[i] = 1;
+        }
+    });
+
+    // Divide the mesh into slabs of equal width along the longest axis of its bounding box.
+    // The number of slabs only depends on the mesh so that the result is always the same.
+    Base::BoundBox3f bbox = myKernel.GetBoundBox();
+    int axis = 0;
+    float length = bbox.LengthX();
+    if (bbox.LengthY() > length) {
+        axis = 1;
+        length = bbox.LengthY();
+    }
+    if (bbox.LengthZ() > length) {
+        axis = 2;
+        length = bbox.LengthZ();
+    }
+
+    const unsigned long minPartitionSize = 10000;
+    const unsigned long numPartitions = std::max<unsigned long>(1, std::min<unsigned long>(64, numFacets / minPartitionSize));
+    const float minCoord = axis == 0 ? bbox.MinX : (axis == 1 ? bbox.MinY : bbox.MinZ);
+    std::vector<unsigned long> partition(numFacets);
+    std::vector<std::vector<unsigned long> > partitionFacets(numPartitions);
+    for (unsigned long i = 0; i < numFacets; i++) {
+        const MeshFacet& face = rFAry[i];
+        float center = (rPAry[face._aulPoints[0]][axis] +
+                        rPAry[face._aulPoints[1]][axis] +
+                        rPAry[face._aulPoints[2]][axis]) / 3.0f;
+        unsigned long part = 0;
+        if (length > 0.0f)
+            part = static_cast<unsigned long>((center - minCoord) / length * numPartitions);
+        part = std::min(part, numPartitions - 1);
+        partition[i] = part;
+        if (accepted[i])
+            partitionFacets[part].push_back(i);
+    }
+
+    // Grow the regions inside each partition. Each thread only writes the labels of the
+    // facets of its own partition, a region is labelled with its smallest facet index.
+    std::vector<unsigned long> label(numFacets, FACET_INDEX_MAX);
+    QtConcurrent::blockingMap(partitionFacets, [&](const std::vector<unsigned long>& facets) {
+        std::queue<unsigned long> todo;
+        for (std::vector<unsigned long>::const_iterator it = facets.begin(); it != facets.end(); ++it) {
+            if (label[*it] != FACET_INDEX_MAX)
+                continue;
+            unsigned long seed = *it;
+            unsigned long part = partition[seed];
+            label[seed] = seed;
+            todo.push(seed);
+            while (!todo.empty()) {
+                const MeshFacet& face = rFAry[todo.front()];
+                todo.pop();
+                for (int i = 0; i < 3; i++) {
+                    unsigned long nb = face._aulNeighbours[i];
+                    if (nb >= numFacets || !accepted[nb] || partition[nb] != part)
+                        continue;
+                    if (label[nb] != FACET_INDEX_MAX)
+                        continue;
+                    label[nb] = seed;
+                    todo.push(nb);
+                }
+            }
+        }
+    });
+
+    // merge the regions that touch each other at the partition borders
+    MeshSegmentUnion regions(numFacets);
+    if (numPartitions > 1) {
+        for (unsigned long i = 0; i < numFacets; i++) {
+            if (!accepted[i])
+                continue;
+            const MeshFacet& face = rFAry[i];
+            for (int j = 0; j < 3; j++) {
+                unsigned long nb = face._aulNeighbours[j];
+                if (nb < numFacets && accepted[nb] && partition[nb] != partition[i])
+                    regions.Unite(label[i], label[nb]);
+            }
+        }
+    }
+
+    // collect the segments, iterating over the facets in ascending order keeps them sorted
+    std::vector<unsigned long> segmentOf(numFacets, FACET_INDEX_MAX);
+    std::vector<MeshSegment> segments;
+    for (unsigned long i = 0; i < numFacets; i++) {
+        if (!accepted[i])
+            continue;
+        unsigned long root = regions.Find(label[i]);
+        if (segmentOf[root] == FACET_INDEX_MAX) {
+            segmentOf[root] = segments.size();
+            segments.push_back(MeshSegment());
+        }
+        segments[segmentOf[root]].push_back(i);
+    }
+
+    for (std::vector<MeshSegment>::iterator it = segments.begin(); it != segments.end(); ++it) {
+        // a single facet doesn't form a segment and stays available for the following segments
+        if (it->size() <= 1)
+            continue;
+        segm.AddSegment(*it);
+        for (MeshSegment::iterator jt = it->begin(); jt != it->end(); ++jt)
+            visited[*jt] = 1;
     }
 }
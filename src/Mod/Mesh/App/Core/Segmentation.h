@@ -31,6 +31,10 @@ public:
     virtual void Initialize(unsigned long);
     virtual bool TestInitialFacet(unsigned long) const;
     virtual void AddFacet(const MeshFacet& rclFacet);
+    /** Returns true if TestFacet() only depends on the tested facet but not on the
+     * facets that have been added before. Such segments can be grown in parallel.
+     */
+    virtual bool IsStateless() const { return false; }
     void AddSegment(const std::vector<unsigned long>&);
     const std::vector<MeshSegment>& GetSegments() const { return segments; }
     MeshSegment FindSegment(unsigned long) const;
@@ -167,6 +171,7 @@ class Standard_EXPORT MeshCurvatureSurfaceSegment : public MeshSurfaceSegment
 public:
     MeshCurvatureSurfaceSegment(const std::vector<CurvatureInfo>& ci, unsigned long minFacets)
         : MeshSurfaceSegment(minFacets), info(ci) {}
+    virtual bool IsStateless() const { return true; }
 
 protected:
     const std::vector<CurvatureInfo>& info;
@@ -248,6 +253,21 @@ class Standard_EXPORT MeshSegmentAlgorithm
 public:
     MeshSegmentAlgorithm(const MeshKernel& kernel) : myKernel(kernel) {}
     void FindSegments(std::vector<MeshSurfaceSegment*>&);
+    /** Does the same as FindSegments() but doesn't modify the flags of the facets.
+     * Segments that are stateless, e.g. the curvature based segments, are grown in
+     * parallel: Each facet is tested only once, the mesh is divided into spatial
+     * partitions that are grown independently and the regions that touch each other
+     * at partition borders are merged afterwards. Unlike FindSegments() a facet only
+     * becomes part of such a segment if it passes the test itself, this way the result
+     * doesn't depend on the order of the facets. The facets of a segment are sorted by
+     * index and the segments by their smallest index.
+     * All other segments are grown sequentially.
+     */
+    void FindSegmentsParallel(std::vector<MeshSurfaceSegment*>&);
+
+private:
+    void GrowSegments(MeshSurfaceSegment&, std::vector<char>& visited) const;
+    void GrowSegmentsParallel(MeshSurfaceSegment&, std::vector<char>& visited) const;
 
 private:
     const MeshKernel& myKernel;
@@ -21,21 +21,58 @@
 #include "Evaluation.h"
 #include "Definitions.h"
 #include "Triangulation.h"
+#include "BVH.h"
 
 #include "Base/Sequencer.h"
 #include "Base/Builder3D.h"
 #include "Base/Tools2D.h"
 
+#include <QFuture>
+#include <QtConcurrentMap>
+
 using namespace Base;
 using namespace MeshCore;
 
+namespace MeshCore {
+
+class FacetIntersection
+{
+public:
+  struct Result
+  {
+    int       isect;
+    MeshPoint p0, p1;
+  };
+  typedef Result result_type;
 
-SetOperations::SetOperations (const MeshKernel &cutMesh1, const MeshKernel &cutMesh2, MeshKernel &result, OperationType opType, float minDistanceToPoint)
+  FacetIntersection (const MeshKernel& mesh0, const MeshKernel& mesh1)
+    : mesh0(mesh0), mesh1(mesh1)
+  {
+  }
+  Result operator()(const std::pair<FacetIndex, FacetIndex>& facets) const
+  {
+    Result res;
+    MeshGeomFacet f1 = mesh0.GetFacet(facets.first);
+    MeshGeomFacet f2 = mesh1.GetFacet(facets.second);
+    res.isect = f1.IntersectWithFacet(f2, res.p0, res.p1);
+    return res;
+  }
+
+private:
+  const MeshKernel& mesh0;
+  const MeshKernel& mesh1;
+};
+
+}
+
+
+SetOperations::SetOperations (const MeshKernel &cutMesh1, const MeshKernel &cutMesh2, MeshKernel &result, OperationType opType, float minDistanceToPoint, SearchMethod searchMethod)
 : _cutMesh0(cutMesh1),
   _cutMesh1(cutMesh2),
   _resultMesh(result),
   _operationType(opType),
-  _minDistanceToPoint(minDistanceToPoint)
+  _minDistanceToPoint(minDistanceToPoint),
+  _searchMethod(searchMethod)
 {
 }
 
@@ -151,6 +188,14 @@ void SetOperations::Do ()
 }
 
 void SetOperations::Cut (std::set<unsigned long>& facetsCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1)
+{
+  if (_searchMethod == BVHSearch)
+    CutBVH(facetsCuttingEdge0, facetsCuttingEdge1);
+  else
+    CutGrid(facetsCuttingEdge0, facetsCuttingEdge1);
+}
+
+void SetOperations::CutGrid (std::set<unsigned long>& facetsCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1)
 {
   MeshFacetGrid grid1(_cutMesh0, 20);
   MeshFacetGrid grid2(_cutMesh1, 20);
@@ -193,85 +238,9 @@ void SetOperations::Cut (std::set<unsigned long>& facetsCuttingEdge0, std::set<u
 
                 int isect = f1.IntersectWithFacet(f2, p0, p1);
                 if (isect > 0)
-                { 
-                   // optimize cut line if distance to nearest point is too small
-                  float minDist1 = _minDistanceToPoint, minDist2 = _minDistanceToPoint;
-                  MeshPoint np0 = p0, np1 = p1;
-                  int i;
-                  for (i = 0; i < 3; i++)
-                  {
-                    float d1 = (f1._aclPoints[i] - p0).Length();
-                    float d2 = (f1._aclPoints[i] - p1).Length();
-                    if (d1 < minDist1)
-                    {
-                      minDist1 = d1;
-                      np0 = f1._aclPoints[i];
-                    }
-                    if (d2 < minDist2)
-                    {
-                      minDist2 = d2;
-                      p1 = f1._aclPoints[i];
-                    }
-                  } // for (int i = 0; i < 3; i++)
-
-                  // optimize cut line if distance to nearest point is too small
-                  for (i = 0; i < 3; i++)
-                  {
-                    float d1 = (f2._aclPoints[i] - p0).Length();
-                    float d2 = (f2._aclPoints[i] - p1).Length();
-                    if (d1 < minDist1)
-                    {
-                      minDist1 = d1;
-                      np0 = f2._aclPoints[i];
-                    }
-                    if (d2 < minDist2)
-                    {
-                      minDist2 = d2;
-                      np1 = f2._aclPoints[i];
-                    }
-                  } // for (int i = 0; i < 3; i++)
-
-                  MeshPoint mp0 = np0;
-                  MeshPoint mp1 = np1;
-
-                  if (mp0 != mp1)
-                  {
-                    facetsCuttingEdge0.insert(fidx1);
-                    facetsCuttingEdge1.insert(fidx2);
-
-                    _cutPoints.insert(mp0);
-                    _cutPoints.insert(mp1);
-
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit0 = _cutPoints.insert(mp0);
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit1 = _cutPoints.insert(mp1);
-
-                    _edges[Edge(mp0, mp1)] = EdgeInfo();
-
-                    _facet2points[0][fidx1].push_back(pit0.first);
-                    _facet2points[0][fidx1].push_back(pit1.first);
-                    _facet2points[1][fidx2].push_back(pit0.first);
-                    _facet2points[1][fidx2].push_back(pit1.first);
-
-                  }
-                  else
-                  {
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit = _cutPoints.insert(mp0);
-
-                    // do not insert a facet when only one corner point cuts the edge
-                    // if (!((mp0 == f1._aclPoints[0]) || (mp0 == f1._aclPoints[1]) || (mp0 == f1._aclPoints[2])))
-                    {
-                      facetsCuttingEdge0.insert(fidx1);
-                      _facet2points[0][fidx1].push_back(pit.first);
-                    }
-
-                    // if (!((mp0 == f2._aclPoints[0]) || (mp0 == f2._aclPoints[1]) || (mp0 == f2._aclPoints[2])))
-                    {
-                      facetsCuttingEdge1.insert(fidx2);
-                      _facet2points[1][fidx2].push_back(pit.first);
-                    }
-                  }
-
-                 } // if (f1.IntersectWithFacet(f2, p0, p1))
+                {
+                  AddCutLine(fidx1, f1, fidx2, f2, p0, p1, facetsCuttingEdge0, facetsCuttingEdge1);
+                }
               } // for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); ++it2)
             } // for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); ++it1)
           } // if (vecFacets2.size() > 0)
@@ -281,6 +250,118 @@ void SetOperations::Cut (std::set<unsigned long>& facetsCuttingEdge0, std::set<u
   } // for (gx1 = 0; gx1 < ctGx1; gx1++)  
 }
 
+void SetOperations::CutBVH (std::set<unsigned long>& facetsCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1)
+{
+  MeshFacetBVH tree0(_cutMesh0);
+  MeshFacetBVH tree1(_cutMesh1);
+
+  // every pair of facets with overlapping bounding boxes is reported only once
+  std::vector<std::pair<FacetIndex, FacetIndex> > pairs;
+  tree0.Overlaps(tree1, pairs);
+
+  QFuture<FacetIntersection::result_type> future = QtConcurrent::mapped
+    (pairs, FacetIntersection(_cutMesh0, _cutMesh1));
+  future.waitForFinished();
+
+  // merge the cut lines in the order of the pairs so that the result is reproducible
+  std::vector<std::pair<FacetIndex, FacetIndex> >::iterator it = pairs.begin();
+  QFuture<FacetIntersection::result_type>::const_iterator jt;
+  for (jt = future.begin(); jt != future.end(); ++jt, ++it)
+  {
+    if (jt->isect > 0)
+    {
+      MeshGeomFacet f1 = _cutMesh0.GetFacet(it->first);
+      MeshGeomFacet f2 = _cutMesh1.GetFacet(it->second);
+      AddCutLine(it->first, f1, it->second, f2, jt->p0, jt->p1, facetsCuttingEdge0, facetsCuttingEdge1);
+    }
+  }
+}
+
+void SetOperations::AddCutLine (unsigned long fidx1, const MeshGeomFacet& f1,
+                                unsigned long fidx2, const MeshGeomFacet& f2,
+                                MeshPoint p0, MeshPoint p1,
+                                std::set<unsigned long>& facetsCuttingEdge0,
+                                std::set<unsigned long>& facetsCuttingEdge1)
+{
+  // optimize cut line if distance to nearest point is too small
+  float minDist1 = _minDistanceToPoint, minDist2 = _minDistanceToPoint;
+  MeshPoint np0 = p0, np1 = p1;
+  int i;
+  for (i = 0; i < 3; i++)
+  {
+    float d1 = (f1._aclPoints[i] - p0).Length();
+    float d2 = (f1._aclPoints[i] - p1).Length();
+    if (d1 < minDist1)
+    {
+      minDist1 = d1;
+      np0 = f1._aclPoints[i];
+    }
+    if (d2 < minDist2)
+    {
+      minDist2 = d2;
+      p1 = f1._aclPoints[i];
+    }
+  } // for (int i = 0; i < 3; i++)
+
+  // optimize cut line if distance to nearest point is too small
+  for (i = 0; i < 3; i++)
+  {
+    float d1 = (f2._aclPoints[i] - p0).Length();
+    float d2 = (f2._aclPoints[i] - p1).Length();
+    if (d1 < minDist1)
+    {
+      minDist1 = d1;
+      np0 = f2._aclPoints[i];
+    }
+    if (d2 < minDist2)
+    {
+      minDist2 = d2;
+      np1 = f2._aclPoints[i];
+    }
+  } // for (int i = 0; i < 3; i++)
+
+  MeshPoint mp0 = np0;
+  MeshPoint mp1 = np1;
+
+  if (mp0 != mp1)
+  {
+    facetsCuttingEdge0.insert(fidx1);
+    facetsCuttingEdge1.insert(fidx2);
+
+    _cutPoints.insert(mp0);
+    _cutPoints.insert(mp1);
+
+    std::pair<std::set<MeshPoint>::iterator, bool> pit0 = _cutPoints.insert(mp0);
+    std::pair<std::set<MeshPoint>::iterator, bool> pit1 = _cutPoints.insert(mp1);
+
+    _edges[Edge(mp0, mp1)] = EdgeInfo();
+
+    _facet2points[0][fidx1].push_back(pit0.first);
+    _facet2points[0][fidx1].push_back(pit1.first);
+    _facet2points[1][fidx2].push_back(pit0.first);
+    _facet2points[1][fidx2].push_back(pit1.first);
+
+  }
+  else
+  {
+    std::pair<std::set<MeshPoint>::iterator, bool> pit = _cutPoints.insert(mp0);
+
+    // do not insert a facet when only one corner point cuts the edge
+    // if (!((mp0 == f1._aclPoints[0]) || (mp0 == f1._aclPoints[1]) || (mp0 == f1._aclPoints[2])))
+    {
+      facetsCuttingEdge0.insert(fidx1);
+      _facet2points[0][fidx1].push_back(pit.first);
+    }
+
+    // if (!((mp0 == f2._aclPoints[0]) || (mp0 == f2._aclPoints[1]) || (mp0 == f2._aclPoints[2])))
+    {
+      facetsCuttingEdge1.insert(fidx2);
+      _facet2points[1][fidx2].push_back(pit.first);
+    }
+  }
+
+}
+
 void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
 {
   // Triangulate Mesh 
@@ -39,9 +39,15 @@ class Standard_EXPORT SetOperations
 {
 public:
   enum OperationType { Union, Intersect, Difference, Inner, Outer };
+  /** Spatial structure used to find the pairs of intersecting facets.
+   * GridSearch uses a regular facet grid for each mesh, BVHSearch uses a bounding
+   * volume hierarchy and computes the facet intersections in parallel.
+   */
+  enum SearchMethod { GridSearch, BVHSearch };
 
   /// Construction
-  SetOperations (const MeshKernel &cutMesh1, const MeshKernel &cutMesh2, MeshKernel &result, OperationType opType, float minDistanceToPoint = 1e-5f);
+  SetOperations (const MeshKernel &cutMesh1, const MeshKernel &cutMesh2, MeshKernel &result, OperationType opType, float minDistanceToPoint = 1e-5f,
+                 SearchMethod searchMethod = GridSearch);
   /// Destruction
   virtual ~SetOperations (void);
 
@@ -58,6 +64,7 @@ protected:
   MeshKernel         &_resultMesh;           /** Result mesh */
   OperationType       _operationType;        /** Set Operation Type */
   float               _minDistanceToPoint;   /** Minimal distance to facet corner points */
+  SearchMethod        _searchMethod;         /** Search structure for intersecting facets */
 
 private:
   // Helper class cutting edge to his two attached facets
@@ -156,6 +163,14 @@ private:
 
   /** Cut mesh 1 with mesh 2 */
   void Cut (std::set<unsigned long>& facetsNotCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1);
+  /** Cut mesh 1 with mesh 2 using facet grids */
+  void CutGrid (std::set<unsigned long>& facetsCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1);
+  /** Cut mesh 1 with mesh 2 using bounding volume hierarchies */
+  void CutBVH (std::set<unsigned long>& facetsCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1);
+  /** Add the cut line of two facets to the cut points and edges */
+  void AddCutLine (unsigned long fidx1, const MeshGeomFacet& f1, unsigned long fidx2, const MeshGeomFacet& f2,
+                   MeshPoint p0, MeshPoint p1,
+                   std::set<unsigned long>& facetsCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1);
   /** Trianglute each facets cutted with his cutting points */
   void TriangulateMesh (const MeshKernel &cutMesh, int side);
   /** search facets for adding (with region growing) */
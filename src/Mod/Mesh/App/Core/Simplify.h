@@ -9,6 +9,7 @@
 // * Comment out printf statements
 // * Fix compiler warnings
 // * Remove macros loop,i,j,k
+// * Optional list of locked vertices that are never collapsed
 
 #include <vector>
 #include "Base/Vector3D.h"
@@ -87,6 +88,8 @@ public:
     std::vector<Triangle> triangles;
     std::vector<Vertex> vertices;
     std::vector<Ref> refs;
+    // if not empty a non-zero entry marks a vertex that must not be collapsed
+    std::vector<char> locked;
 
     void simplify_mesh(int target_count, double tolerance, double aggressiveness=7);
 
@@ -196,6 +199,10 @@ void Simplify::simplify_mesh(int target_count, double tolerance, double aggressi
                     if (v0.border != v1.border)
                         continue;
 
+                    // Locked vertices must keep their position
+                    if (!locked.empty() && (locked[i0] || locked[i1]))
+                        continue;
+
                     // Compute vertex to collapse to
                     vec3f p;
                     calculate_error(i0,i1,p);
@@ -12,15 +12,116 @@
 #include "Iterator.h"
 #include "Approximation.h"
 
+#include <QtConcurrentMap>
+
 
 using namespace MeshCore;
 
+namespace MeshCore {
+
+/**
+ * Splits the range [0, count) into blocks of a fixed size and calls \a func for each
+ * block in parallel. Since the block boundaries don't depend on the number of threads
+ * and each block only writes its own elements, the result is always the same.
+ */
+template <class Func>
+static void ForEachRange(std::size_t count, Func func)
+{
+    const std::size_t rangeSize = 4096;
+    std::vector<std::pair<std::size_t, std::size_t> > ranges;
+    for (std::size_t i = 0; i < count; i += rangeSize)
+        ranges.push_back(std::make_pair(i, std::min(i + rangeSize, count)));
+
+    QtConcurrent::blockingMap(ranges, [&func](const std::pair<std::size_t, std::size_t>& range) {
+        func(range.first, range.second);
+    });
+}
+
+/**
+ * Computes the new position of the point \a pos by moving it towards the mean plane
+ * of its neighbourhood \a cv. Returns false if the point doesn't have enough neighbours.
+ */
+static bool PlaneFitPoint(const MeshPointArray& points, const std::set<unsigned long>& cv,
+                          unsigned long pos, float tolerance, Base::Vector3f& pnt)
+{
+    if (cv.size() < 3)
+        return false;
+
+    const MeshPoint& v = points[pos];
+    MeshCore::PlaneFit pf;
+    pf.AddPoint(v);
+    Base::Vector3f center = v;
+
+    std::set<unsigned long>::const_iterator cv_it;
+    for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
+        pf.AddPoint(points[*cv_it]);
+        center += points[*cv_it];
+    }
+
+    float scale = 1.0f/((float)cv.size()+1.0f);
+    center.Scale(scale,scale,scale);
+
+    // get the mean plane of the current vertex with the surrounding vertices
+    pf.Fit();
+    Base::Vector3f N = pf.GetNormal();
+    N.Normalize();
+
+    // look in which direction we should move the vertex
+    Base::Vector3f L(v.x - center.x, v.y - center.y, v.z - center.z);
+    if (N*L < 0.0)
+        N.Scale(-1.0, -1.0, -1.0);
+
+    // maximum value to move is distance to mean plane
+    float d = std::min<float>((float)fabs(tolerance),(float)fabs(N*L));
+    N.Scale(d,d,d);
+
+    pnt.Set(v.x - N.x, v.y - N.y, v.z - N.z);
+    return true;
+}
+
+/**
+ * Computes the new position of the point \a pos by moving it with \a stepsize towards
+ * the centroid of its neighbourhood \a cv. Returns false for border points.
+ */
+static bool UmbrellaPoint(const MeshPointArray& points, const std::set<unsigned long>& cv,
+                          std::size_t numFacets, unsigned long pos, double stepsize,
+                          Base::Vector3f& pnt)
+{
+    if (cv.size() < 3)
+        return false;
+    if (cv.size() != numFacets) {
+        // do nothing for border points
+        return false;
+    }
+
+    const MeshPoint& v = points[pos];
+    unsigned int n_count = cv.size();
+    double w;
+    w=1.0/double(n_count);
+
+    double delx=0.0,dely=0.0,delz=0.0;
+    std::set<unsigned long>::const_iterator cv_it;
+    for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
+        delx += w*(points[*cv_it].x-v.x);
+        dely += w*(points[*cv_it].y-v.y);
+        delz += w*(points[*cv_it].z-v.z);
+    }
+
+    pnt.x = (float)(v.x+stepsize*delx);
+    pnt.y = (float)(v.y+stepsize*dely);
+    pnt.z = (float)(v.z+stepsize*delz);
+    return true;
+}
+
+}
+
 
 AbstractSmoothing::AbstractSmoothing(MeshKernel& m)
   : kernel(m)
   , tolerance(0)
   , component(Normal)
   , continuity(C0)
+  , parallel(false)
 {
 }
 
@@ -45,48 +146,24 @@ PlaneFitSmoothing::~PlaneFitSmoothing()
 
 void PlaneFitSmoothing::Smooth(unsigned int iterations)
 {
-    MeshCore::MeshPoint center;
     MeshCore::MeshPointArray PointArray = kernel.GetPoints();
-
-    MeshCore::MeshPointIterator v_it(kernel);
     MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshPointArray::_TConstIterator v_beg = kernel.GetPoints().begin();
+    const MeshCore::MeshPointArray& points = kernel.GetPoints();
 
     for (unsigned int i=0; i<iterations; i++) {
-        Base::Vector3f N, L;
-        for (v_it.Begin(); v_it.More(); v_it.Next()) {
-            MeshCore::PlaneFit pf;
-            pf.AddPoint(*v_it);
-            center = *v_it;
-            const std::set<unsigned long>& cv = vv_it[v_it.Position()];
-            if (cv.size() < 3)
-                continue;
-
-            std::set<unsigned long>::const_iterator cv_it;
-            for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-                pf.AddPoint(v_beg[*cv_it]);
-                center += v_beg[*cv_it];
+        // the new points only depend on the points of the previous iteration
+        auto smoothRange = [&](std::size_t begin, std::size_t end) {
+            Base::Vector3f pnt;
+            for (std::size_t pos = begin; pos < end; pos++) {
+                if (PlaneFitPoint(points, vv_it[pos], pos, this->tolerance, pnt))
+                    PointArray[pos].Set(pnt.x, pnt.y, pnt.z);
             }
+        };
 
-            float scale = 1.0f/((float)cv.size()+1.0f);
-            center.Scale(scale,scale,scale);
-
-            // get the mean plane of the current vertex with the surrounding vertices
-            pf.Fit();
-            N = pf.GetNormal();
-            N.Normalize();
-
-            // look in which direction we should move the vertex
-            L.Set(v_it->x - center.x, v_it->y - center.y, v_it->z - center.z);
-            if (N*L < 0.0)
-                N.Scale(-1.0, -1.0, -1.0);
-
-            // maximum value to move is distance to mean plane
-            float d = std::min<float>((float)fabs(this->tolerance),(float)fabs(N*L));
-            N.Scale(d,d,d);
-
-            PointArray[v_it.Position()].Set(v_it->x - N.x, v_it->y - N.y, v_it->z - N.z);
-        }
+        if (this->parallel)
+            ForEachRange(points.size(), smoothRange);
+        else
+            smoothRange(0, points.size());
 
         // assign values without affecting iterators
         unsigned long count = kernel.CountPoints();
@@ -98,49 +175,25 @@ void PlaneFitSmoothing::Smooth(unsigned int iterations)
 
 void PlaneFitSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
 {
-    MeshCore::MeshPoint center;
     MeshCore::MeshPointArray PointArray = kernel.GetPoints();
-
-    MeshCore::MeshPointIterator v_it(kernel);
     MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshPointArray::_TConstIterator v_beg = kernel.GetPoints().begin();
+    const MeshCore::MeshPointArray& points = kernel.GetPoints();
 
     for (unsigned int i=0; i<iterations; i++) {
-        Base::Vector3f N, L;
-        for (std::vector<unsigned long>::const_iterator it = point_indices.begin(); it != point_indices.end(); ++it) {
-            v_it.Set(*it);
-            MeshCore::PlaneFit pf;
-            pf.AddPoint(*v_it);
-            center = *v_it;
-            const std::set<unsigned long>& cv = vv_it[v_it.Position()];
-            if (cv.size() < 3)
-                continue;
-
-            std::set<unsigned long>::const_iterator cv_it;
-            for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-                pf.AddPoint(v_beg[*cv_it]);
-                center += v_beg[*cv_it];
+        // the new points only depend on the points of the previous iteration
+        auto smoothRange = [&](std::size_t begin, std::size_t end) {
+            Base::Vector3f pnt;
+            for (std::size_t k = begin; k < end; k++) {
+                unsigned long pos = point_indices[k];
+                if (PlaneFitPoint(points, vv_it[pos], pos, this->tolerance, pnt))
+                    PointArray[pos].Set(pnt.x, pnt.y, pnt.z);
             }
+        };
 
-            float scale = 1.0f/((float)cv.size()+1.0f);
-            center.Scale(scale,scale,scale);
-
-            // get the mean plane of the current vertex with the surrounding vertices
-            pf.Fit();
-            N = pf.GetNormal();
-            N.Normalize();
-
-            // look in which direction we should move the vertex
-            L.Set(v_it->x - center.x, v_it->y - center.y, v_it->z - center.z);
-            if (N*L < 0.0)
-                N.Scale(-1.0, -1.0, -1.0);
-
-            // maximum value to move is distance to mean plane
-            float d = std::min<float>((float)fabs(this->tolerance),(float)fabs(N*L));
-            N.Scale(d,d,d);
-
-            PointArray[v_it.Position()].Set(v_it->x - N.x, v_it->y - N.y, v_it->z - N.z);
-        }
+        if (this->parallel)
+            ForEachRange(point_indices.size(), smoothRange);
+        else
+            smoothRange(0, point_indices.size());
 
         // assign values without affecting iterators
         unsigned long count = kernel.CountPoints();
@@ -163,35 +216,26 @@ void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
                                 const MeshRefPointToFacets& vf_it, double stepsize)
 {
     const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_it,
-    v_beg = points.begin(), v_end = points.end();
-
-    unsigned long pos = 0;
-    for (v_it = points.begin(); v_it != v_end; ++v_it,++pos) {
-        const std::set<unsigned long>& cv = vv_it[pos];
-        if (cv.size() < 3)
-            continue;
-        if (cv.size() != vf_it[pos].size()) {
-            // do nothing for border points
-            continue;
-        }
+    Base::Vector3f pnt;
 
-        unsigned int n_count = cv.size();
-        double w;
-        w=1.0/double(n_count);
+    if (this->parallel) {
+        // Jacobi scheme: compute all new points from the current points first
+        std::vector<Base::Vector3f> newPoints(points.begin(), points.end());
+        ForEachRange(points.size(), [&](std::size_t begin, std::size_t end) {
+            for (std::size_t pos = begin; pos < end; pos++)
+                UmbrellaPoint(points, vv_it[pos], vf_it[pos].size(), pos, stepsize, newPoints[pos]);
+        });
 
-        double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*((v_beg[*cv_it]).x-v_it->x);
-            dely += w*((v_beg[*cv_it]).y-v_it->y);
-            delz += w*((v_beg[*cv_it]).z-v_it->z);
+        unsigned long count = kernel.CountPoints();
+        for (unsigned long pos = 0; pos < count; pos++)
+            kernel.SetPoint(pos, newPoints[pos]);
+    }
+    else {
+        unsigned long count = kernel.CountPoints();
+        for (unsigned long pos = 0; pos < count; pos++) {
+            if (UmbrellaPoint(points, vv_it[pos], vf_it[pos].size(), pos, stepsize, pnt))
+                kernel.SetPoint(pos, pnt);
         }
-
-        float x = (float)(v_it->x+stepsize*delx);
-        float y = (float)(v_it->y+stepsize*dely);
-        float z = (float)(v_it->z+stepsize*delz);
-        kernel.SetPoint(pos,x,y,z);
     }
 }
 
@@ -200,33 +244,29 @@ void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
                                 const std::vector<unsigned long>& point_indices)
 {
     const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_beg = points.begin();
-
-    for (std::vector<unsigned long>::const_iterator pos = point_indices.begin(); pos != point_indices.end(); ++pos) {
-        const std::set<unsigned long>& cv = vv_it[*pos];
-        if (cv.size() < 3)
-            continue;
-        if (cv.size() != vf_it[*pos].size()) {
-            // do nothing for border points
-            continue;
-        }
-
-        unsigned int n_count = cv.size();
-        double w;
-        w=1.0/double(n_count);
+    Base::Vector3f pnt;
+
+    if (this->parallel) {
+        // Jacobi scheme: compute all new points from the current points first
+        std::vector<Base::Vector3f> newPoints(point_indices.size());
+        std::vector<char> moved(point_indices.size());
+        ForEachRange(point_indices.size(), [&](std::size_t begin, std::size_t end) {
+            for (std::size_t k = begin; k < end; k++) {
+                unsigned long pos = point_indices[k];
+                moved[k] = UmbrellaPoint(points, vv_it[pos], vf_it[pos].size(), pos, stepsize, newPoints[k]);
+            }
+        });
 
-        double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*((v_beg[*cv_it]).x-(v_beg[*pos]).x);
-            dely += w*((v_beg[*cv_it]).y-(v_beg[*pos]).y);
-            delz += w*((v_beg[*cv_it]).z-(v_beg[*pos]).z);
+        for (std::size_t k = 0; k < point_indices.size(); k++) {
+            if (moved[k])
+                kernel.SetPoint(point_indices[k], newPoints[k]);
+        }
+    }
+    else {
+        for (std::vector<unsigned long>::const_iterator pos = point_indices.begin(); pos != point_indices.end(); ++pos) {
+            if (UmbrellaPoint(points, vv_it[*pos], vf_it[*pos].size(), *pos, stepsize, pnt))
+                kernel.SetPoint(*pos, pnt);
         }
-
-        float x = (float)((v_beg[*pos]).x+stepsize*delx);
-        float y = (float)((v_beg[*pos]).y+stepsize*dely);
-        float z = (float)((v_beg[*pos]).z+stepsize*delz);
-        kernel.SetPoint(*pos,x,y,z);
     }
 }
 
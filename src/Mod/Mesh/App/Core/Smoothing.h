@@ -35,6 +35,11 @@ public:
     AbstractSmoothing(MeshKernel&);
     virtual ~AbstractSmoothing();
     void initialize(Component comp, Continuity cont);
+    /** If \a on is true the points are processed in parallel. Then each iteration
+     * computes the new points only from the points of the previous iteration
+     * (Jacobi scheme) so that the result doesn't depend on the number of threads.
+     */
+    void SetParallel(bool on) { parallel = on; }
 
     /** Smooth the triangle mesh. */
     virtual void Smooth(unsigned int) = 0;
@@ -46,6 +51,7 @@ protected:
     float tolerance;
     Component   component;
     Continuity  continuity;
+    bool        parallel;
 };
 
 class Standard_EXPORT PlaneFitSmoothing : public AbstractSmoothing
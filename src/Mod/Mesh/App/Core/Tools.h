@@ -159,7 +159,7 @@ class MeshNearestIndexToPlane : public std::unary_function<unsigned long, void>
 {
 public:
     MeshNearestIndexToPlane(const MeshKernel& mesh, const Base::Vector3f& b, const Base::Vector3f& n)
-        : nearest_index(ULONG_MAX),nearest_dist(FLOAT_MAX), it(mesh), base(b), normal(n) {}
+        : nearest_index(FACET_INDEX_MAX),nearest_dist(FLOAT_MAX), it(mesh), base(b), normal(n) {}
     void operator() (unsigned long index)
     {
         float dist = (float)fabs(it(index).DistanceToPlane(base, normal));
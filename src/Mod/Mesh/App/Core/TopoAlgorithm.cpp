@@ -65,9 +65,9 @@ bool MeshTopoAlgorithm::InsertVertex(unsigned long ulFacetPos, const Base::Vecto
   clNewFacet2._aulNeighbours[1] = ulFacetPos;
   clNewFacet2._aulNeighbours[2] = ulSize;
   // adjust the neighbour facet
-  if (rclF._aulNeighbours[1] != ULONG_MAX)
+  if (rclF._aulNeighbours[1] != FACET_INDEX_MAX)
     _rclMesh._aclFacetArray[rclF._aulNeighbours[1]].ReplaceNeighbour(ulFacetPos, ulSize);
-  if (rclF._aulNeighbours[2] != ULONG_MAX)
+  if (rclF._aulNeighbours[2] != FACET_INDEX_MAX)
     _rclMesh._aclFacetArray[rclF._aulNeighbours[2]].ReplaceNeighbour(ulFacetPos, ulSize+1);
   // original facet
   rclF._aulPoints[2] = ulPtInd;
@@ -89,7 +89,7 @@ bool MeshTopoAlgorithm::SnapVertex(unsigned long ulFacetPos, const Base::Vector3
   Base::Vector3f cNo1 = _rclMesh.GetNormal(rFace);
   for (short i=0; i<3; i++)
   {
-    if (rFace._aulNeighbours[i]==ULONG_MAX)
+    if (rFace._aulNeighbours[i]==FACET_INDEX_MAX)
     {
       const Base::Vector3f& rPt1 = _rclMesh._aclPointArray[rFace._aulPoints[i]];
       const Base::Vector3f& rPt2 = _rclMesh._aclPointArray[rFace._aulPoints[(i+1)%3]];
@@ -130,7 +130,7 @@ void MeshTopoAlgorithm::OptimizeTopology(float fMaxAngle)
     for (MeshFacetArray::_TIterator pI = _rclMesh._aclFacetArray.begin(); pI != _rclMesh._aclFacetArray.end(); ++pI) {
         for (int i = 0; i < 3; i++) {
             // ignore open edges
-            if (pI->_aulNeighbours[i] != ULONG_MAX) {
+            if (pI->_aulNeighbours[i] != FACET_INDEX_MAX) {
                 unsigned long ulPt0 = std::min<unsigned long>(pI->_aulPoints[i],  pI->_aulPoints[(i+1)%3]);
                 unsigned long ulPt1 = std::max<unsigned long>(pI->_aulPoints[i],  pI->_aulPoints[(i+1)%3]);
                 aEdge2Face[std::pair<unsigned long, unsigned long>(ulPt0, ulPt1)].push_back(pI - _rclMesh._aclFacetArray.begin());
@@ -247,7 +247,7 @@ float MeshTopoAlgorithm::SwapEdgeBenefit(unsigned long f, int e) const
     const MeshPointArray& vertices = _rclMesh.GetPoints();
 
     unsigned long n = faces[f]._aulNeighbours[e];
-    if (n == ULONG_MAX)
+    if (n == FACET_INDEX_MAX)
         return 0.0f; // border edge
 
     unsigned long v1 = faces[f]._aulPoints[e];
@@ -320,7 +320,7 @@ void MeshTopoAlgorithm::DelaunayFlip(float fMaxAngle)
     for (MeshFacetArray::_TIterator pI = _rclMesh._aclFacetArray.begin(); pI != _rclMesh._aclFacetArray.end(); ++pI, index++) {
         for (int i = 0; i < 3; i++) {
             // ignore open edges
-            if (pI->_aulNeighbours[i] != ULONG_MAX) {
+            if (pI->_aulNeighbours[i] != FACET_INDEX_MAX) {
                 unsigned long ulFt0 = std::min<unsigned long>(index, pI->_aulNeighbours[i]);
                 unsigned long ulFt1 = std::max<unsigned long>(index, pI->_aulNeighbours[i]);
                 aEdge2Face.insert(std::pair<unsigned long, unsigned long>(ulFt0, ulFt1));
@@ -343,12 +343,12 @@ void MeshTopoAlgorithm::DelaunayFlip(float fMaxAngle)
             if (Base::DistanceP2(center, vertex) < radius) {
                 SwapEdge(edge.first, edge.second);
                 for (int i=0; i<3; i++) {
-                    if (face_1._aulNeighbours[i] != ULONG_MAX && face_1._aulNeighbours[i] != edge.second) {
+                    if (face_1._aulNeighbours[i] != FACET_INDEX_MAX && face_1._aulNeighbours[i] != edge.second) {
                         unsigned long ulFt0 = std::min<unsigned long>(edge.first, face_1._aulNeighbours[i]);
                         unsigned long ulFt1 = std::max<unsigned long>(edge.first, face_1._aulNeighbours[i]);
                         aEdge2Face.insert(std::pair<unsigned long, unsigned long>(ulFt0, ulFt1));
                     }
-                    if (face_2._aulNeighbours[i] != ULONG_MAX && face_2._aulNeighbours[i] != edge.first) {
+                    if (face_2._aulNeighbours[i] != FACET_INDEX_MAX && face_2._aulNeighbours[i] != edge.first) {
                         unsigned long ulFt0 = std::min<unsigned long>(edge.second, face_2._aulNeighbours[i]);
                         unsigned long ulFt1 = std::max<unsigned long>(edge.second, face_2._aulNeighbours[i]);
                         aEdge2Face.insert(std::pair<unsigned long, unsigned long>(ulFt0, ulFt1));
@@ -370,7 +370,7 @@ int MeshTopoAlgorithm::DelaunayFlip()
             continue;
         for (int j=0;j<3;j++) {
             unsigned long n = f_face._aulNeighbours[j];
-            if (n != ULONG_MAX) {
+            if (n != FACET_INDEX_MAX) {
                 const MeshFacet& n_face = _rclMesh._aclFacetArray[n];
                 if (n_face.IsFlag(MeshFacet::TMP0))
                     continue;
@@ -509,7 +509,7 @@ bool MeshTopoAlgorithm::InsertVertexAndSwapEdge(unsigned long ulFacetPos, const
   for ( i=0; i<3; i++ )
   {
     unsigned long uNeighbour = rclF1._aulNeighbours[i];
-    if ( uNeighbour!=ULONG_MAX && uNeighbour!=ulF1Ind && uNeighbour!=ulF2Ind )
+    if ( uNeighbour!=FACET_INDEX_MAX && uNeighbour!=ulF1Ind && uNeighbour!=ulF2Ind )
     {
       if ( ShouldSwapEdge(ulFacetPos, uNeighbour, fMaxAngle) ) {
         SwapEdge(ulFacetPos, uNeighbour);
@@ -521,7 +521,7 @@ bool MeshTopoAlgorithm::InsertVertexAndSwapEdge(unsigned long ulFacetPos, const
   {
     // second facet
     unsigned long uNeighbour = rclF2._aulNeighbours[i];
-    if ( uNeighbour!=ULONG_MAX && uNeighbour!=ulFacetPos && uNeighbour!=ulF2Ind )
+    if ( uNeighbour!=FACET_INDEX_MAX && uNeighbour!=ulFacetPos && uNeighbour!=ulF2Ind )
     {
       if ( ShouldSwapEdge(ulF1Ind, uNeighbour, fMaxAngle) ) {
         SwapEdge(ulF1Ind, uNeighbour);
@@ -534,7 +534,7 @@ bool MeshTopoAlgorithm::InsertVertexAndSwapEdge(unsigned long ulFacetPos, const
   for ( i=0; i<3; i++ )
   {
     unsigned long uNeighbour = rclF3._aulNeighbours[i];
-    if ( uNeighbour!=ULONG_MAX && uNeighbour!=ulFacetPos && uNeighbour!=ulF1Ind )
+    if ( uNeighbour!=FACET_INDEX_MAX && uNeighbour!=ulFacetPos && uNeighbour!=ulF1Ind )
     {
       if ( ShouldSwapEdge(ulF2Ind, uNeighbour, fMaxAngle) ) {
         SwapEdge(ulF2Ind, uNeighbour);
@@ -631,9 +631,9 @@ void MeshTopoAlgorithm::SwapEdge(unsigned long ulFacetPos, unsigned long ulNeigh
         return; // not neighbours
 
     // adjust the neighbourhood
-    if (rclF._aulNeighbours[(uFSide+1)%3] != ULONG_MAX)
+    if (rclF._aulNeighbours[(uFSide+1)%3] != FACET_INDEX_MAX)
         _rclMesh._aclFacetArray[rclF._aulNeighbours[(uFSide+1)%3]].ReplaceNeighbour(ulFacetPos, ulNeighbour);
-    if (rclN._aulNeighbours[(uNSide+1)%3] != ULONG_MAX)
+    if (rclN._aulNeighbours[(uNSide+1)%3] != FACET_INDEX_MAX)
         _rclMesh._aclFacetArray[rclN._aulNeighbours[(uNSide+1)%3]].ReplaceNeighbour(ulNeighbour, ulFacetPos);
 
     // swap the point and neighbour indices
@@ -666,9 +666,9 @@ bool MeshTopoAlgorithm::SplitEdge(unsigned long ulFacetPos, unsigned long ulNeig
         return false;
 
     // adjust the neighbourhood
-    if (rclF._aulNeighbours[(uFSide+1)%3] != ULONG_MAX)
+    if (rclF._aulNeighbours[(uFSide+1)%3] != FACET_INDEX_MAX)
         _rclMesh._aclFacetArray[rclF._aulNeighbours[(uFSide+1)%3]].ReplaceNeighbour(ulFacetPos, ulSize);
-    if (rclN._aulNeighbours[(uNSide+2)%3] != ULONG_MAX)
+    if (rclN._aulNeighbours[(uNSide+2)%3] != FACET_INDEX_MAX)
         _rclMesh._aclFacetArray[rclN._aulNeighbours[(uNSide+2)%3]].ReplaceNeighbour(ulNeighbour, ulSize+1);
 
     MeshFacet cNew1, cNew2;
@@ -702,7 +702,7 @@ bool MeshTopoAlgorithm::SplitEdge(unsigned long ulFacetPos, unsigned long ulNeig
 void MeshTopoAlgorithm::SplitOpenEdge(unsigned long ulFacetPos, unsigned short uSide, const Base::Vector3f& rP)
 {
     MeshFacet& rclF = _rclMesh._aclFacetArray[ulFacetPos];
-    if (rclF._aulNeighbours[uSide] != ULONG_MAX) 
+    if (rclF._aulNeighbours[uSide] != FACET_INDEX_MAX) 
         return; // not open
 
     unsigned long uPtCnt = _rclMesh._aclPointArray.size();
@@ -713,14 +713,14 @@ void MeshTopoAlgorithm::SplitOpenEdge(unsigned long ulFacetPos, unsigned short u
         return; // the given point is already part of the mesh => creating new facets would be an illegal operation
 
     // adjust the neighbourhood
-    if (rclF._aulNeighbours[(uSide+1)%3] != ULONG_MAX)
+    if (rclF._aulNeighbours[(uSide+1)%3] != FACET_INDEX_MAX)
         _rclMesh._aclFacetArray[rclF._aulNeighbours[(uSide+1)%3]].ReplaceNeighbour(ulFacetPos, ulSize);
 
     MeshFacet cNew;
     cNew._aulPoints[0] = uPtInd;
     cNew._aulPoints[1] = rclF._aulPoints[(uSide+1)%3];
     cNew._aulPoints[2] = rclF._aulPoints[(uSide+2)%3];
-    cNew._aulNeighbours[0] = ULONG_MAX;
+    cNew._aulNeighbours[0] = FACET_INDEX_MAX;
     cNew._aulNeighbours[1] = rclF._aulNeighbours[(uSide+1)%3];
     cNew._aulNeighbours[2] = ulFacetPos;
 
@@ -790,11 +790,11 @@ std::vector<unsigned long> MeshTopoAlgorithm::GetFacetsToPoint(unsigned long uFa
         MeshFacet& rFace = _rclMesh._aclFacetArray[uIndex];
         for (int i=0; i<3; i++) {
             if (rFace._aulPoints[i] == uPointPos) {
-                if (rFace._aulNeighbours[i] != ULONG_MAX) {
+                if (rFace._aulNeighbours[i] != FACET_INDEX_MAX) {
                     if (aRefFacet.find(rFace._aulNeighbours[i]) == aRefFacet.end())
                         aReference.push_back( rFace._aulNeighbours[i] );
                 }
-                if (rFace._aulNeighbours[(i+2)%3] != ULONG_MAX) {
+                if (rFace._aulNeighbours[(i+2)%3] != FACET_INDEX_MAX) {
                     if (aRefFacet.find(rFace._aulNeighbours[(i+2)%3]) == aRefFacet.end())
                         aReference.push_back( rFace._aulNeighbours[(i+2)%3] );
                 }
@@ -831,7 +831,7 @@ bool MeshTopoAlgorithm::CollapseVertex(const VertexCollapse& vc)
     MeshFacet& rFace3 = _rclMesh._aclFacetArray[vc._circumFacets[2]];
 
     // get the point that is not shared by rFace1
-    unsigned long ptIndex = ULONG_MAX;
+    unsigned long ptIndex = POINT_INDEX_MAX;
     std::vector<unsigned long>::const_iterator it;
     for (it = vc._circumPoints.begin(); it != vc._circumPoints.end(); ++it) {
         if (!rFace1.HasPoint(*it)) {
@@ -840,11 +840,11 @@ bool MeshTopoAlgorithm::CollapseVertex(const VertexCollapse& vc)
         }
     }
 
-    if (ptIndex == ULONG_MAX)
+    if (ptIndex == POINT_INDEX_MAX)
         return false;
 
-    unsigned long neighbour1 = ULONG_MAX;
-    unsigned long neighbour2 = ULONG_MAX;
+    unsigned long neighbour1 = FACET_INDEX_MAX;
+    unsigned long neighbour2 = FACET_INDEX_MAX;
 
     const std::vector<unsigned long>& faces = vc._circumFacets;
     // get neighbours that are not part of the faces to be removed
@@ -862,11 +862,11 @@ bool MeshTopoAlgorithm::CollapseVertex(const VertexCollapse& vc)
     rFace1.ReplaceNeighbour(vc._circumFacets[1], neighbour1);
     rFace1.ReplaceNeighbour(vc._circumFacets[2], neighbour2);
 
-    if (neighbour1 != ULONG_MAX) {
+    if (neighbour1 != FACET_INDEX_MAX) {
         MeshFacet& rFace4 = _rclMesh._aclFacetArray[neighbour1];
         rFace4.ReplaceNeighbour(vc._circumFacets[1], vc._circumFacets[0]);
     }
-    if (neighbour2 != ULONG_MAX) {
+    if (neighbour2 != FACET_INDEX_MAX) {
         MeshFacet& rFace5 = _rclMesh._aclFacetArray[neighbour2];
         rFace5.ReplaceNeighbour(vc._circumFacets[2], vc._circumFacets[0]);
     }
@@ -908,23 +908,23 @@ bool MeshTopoAlgorithm::CollapseEdge(unsigned long ulFacetPos, unsigned long ulN
   }
 
   // set the new neighbourhood
-  if (rclF._aulNeighbours[(uFSide+1)%3] != ULONG_MAX)
+  if (rclF._aulNeighbours[(uFSide+1)%3] != FACET_INDEX_MAX)
     _rclMesh._aclFacetArray[rclF._aulNeighbours[(uFSide+1)%3]].ReplaceNeighbour(ulFacetPos, rclF._aulNeighbours[(uFSide+2)%3]);
-  if (rclF._aulNeighbours[(uFSide+2)%3] != ULONG_MAX)
+  if (rclF._aulNeighbours[(uFSide+2)%3] != FACET_INDEX_MAX)
     _rclMesh._aclFacetArray[rclF._aulNeighbours[(uFSide+2)%3]].ReplaceNeighbour(ulFacetPos, rclF._aulNeighbours[(uFSide+1)%3]);
-  if (rclN._aulNeighbours[(uNSide+1)%3] != ULONG_MAX)
+  if (rclN._aulNeighbours[(uNSide+1)%3] != FACET_INDEX_MAX)
     _rclMesh._aclFacetArray[rclN._aulNeighbours[(uNSide+1)%3]].ReplaceNeighbour(ulNeighbour, rclN._aulNeighbours[(uNSide+2)%3]);
-  if (rclN._aulNeighbours[(uNSide+2)%3] != ULONG_MAX)
+  if (rclN._aulNeighbours[(uNSide+2)%3] != FACET_INDEX_MAX)
     _rclMesh._aclFacetArray[rclN._aulNeighbours[(uNSide+2)%3]].ReplaceNeighbour(ulNeighbour, rclN._aulNeighbours[(uNSide+1)%3]);
 
   // isolate the both facets and the point
-  rclF._aulNeighbours[0] = ULONG_MAX;
-  rclF._aulNeighbours[1] = ULONG_MAX;
-  rclF._aulNeighbours[2] = ULONG_MAX;
+  rclF._aulNeighbours[0] = FACET_INDEX_MAX;
+  rclF._aulNeighbours[1] = FACET_INDEX_MAX;
+  rclF._aulNeighbours[2] = FACET_INDEX_MAX;
   rclF.SetInvalid();
-  rclN._aulNeighbours[0] = ULONG_MAX;
-  rclN._aulNeighbours[1] = ULONG_MAX;
-  rclN._aulNeighbours[2] = ULONG_MAX;
+  rclN._aulNeighbours[0] = FACET_INDEX_MAX;
+  rclN._aulNeighbours[1] = FACET_INDEX_MAX;
+  rclN._aulNeighbours[2] = FACET_INDEX_MAX;
   rclN.SetInvalid();
   _rclMesh._aclPointArray[ulPointPos].SetInvalid();
 
@@ -1013,31 +1013,31 @@ bool MeshTopoAlgorithm::CollapseFacet(unsigned long ulFacetPos)
 
     // set the neighbourhood of the circumjacent facets
     for (int i=0; i<3; i++) {
-        if (rclF._aulNeighbours[i] == ULONG_MAX)
+        if (rclF._aulNeighbours[i] == FACET_INDEX_MAX)
             continue;
         MeshFacet& rclN = _rclMesh._aclFacetArray[rclF._aulNeighbours[i]];
         unsigned short uNSide = rclN.Side(rclF);
 
-        if (rclN._aulNeighbours[(uNSide+1)%3] != ULONG_MAX) {
+        if (rclN._aulNeighbours[(uNSide+1)%3] != FACET_INDEX_MAX) {
             _rclMesh._aclFacetArray[rclN._aulNeighbours[(uNSide+1)%3]]
                     .ReplaceNeighbour(rclF._aulNeighbours[i],rclN._aulNeighbours[(uNSide+2)%3]);
         }
-        if (rclN._aulNeighbours[(uNSide+2)%3] != ULONG_MAX) {
+        if (rclN._aulNeighbours[(uNSide+2)%3] != FACET_INDEX_MAX) {
             _rclMesh._aclFacetArray[rclN._aulNeighbours[(uNSide+2)%3]]
                     .ReplaceNeighbour(rclF._aulNeighbours[i],rclN._aulNeighbours[(uNSide+1)%3]);
         }
 
         // Isolate the neighbours from the topology
-        rclN._aulNeighbours[0] = ULONG_MAX;
-        rclN._aulNeighbours[1] = ULONG_MAX;
-        rclN._aulNeighbours[2] = ULONG_MAX;
+        rclN._aulNeighbours[0] = FACET_INDEX_MAX;
+        rclN._aulNeighbours[1] = FACET_INDEX_MAX;
+        rclN._aulNeighbours[2] = FACET_INDEX_MAX;
         rclN.SetInvalid();
     }
 
     // Isolate this facet and make two of its points invalid
-    rclF._aulNeighbours[0] = ULONG_MAX;
-    rclF._aulNeighbours[1] = ULONG_MAX;
-    rclF._aulNeighbours[2] = ULONG_MAX;
+    rclF._aulNeighbours[0] = FACET_INDEX_MAX;
+    rclF._aulNeighbours[1] = FACET_INDEX_MAX;
+    rclF._aulNeighbours[2] = FACET_INDEX_MAX;
     rclF.SetInvalid();
     _rclMesh._aclPointArray[ulPointInd1].SetInvalid();
     _rclMesh._aclPointArray[ulPointInd2].SetInvalid();
@@ -1094,7 +1094,7 @@ void MeshTopoAlgorithm::SplitFacet(unsigned long ulFacetPos, const Base::Vector3
     }
     if ( fMinDist < 0.05f )
     {
-      if ( rFace._aulNeighbours[iEdgeNo] != ULONG_MAX )
+      if ( rFace._aulNeighbours[iEdgeNo] != FACET_INDEX_MAX )
         SplitEdge(ulFacetPos, rFace._aulNeighbours[iEdgeNo], rP2);
       else
         SplitOpenEdge(ulFacetPos, iEdgeNo, rP2);
@@ -1120,7 +1120,7 @@ void MeshTopoAlgorithm::SplitFacet(unsigned long ulFacetPos, const Base::Vector3
     }
     if ( fMinDist < 0.05f )
     {
-      if ( rFace._aulNeighbours[iEdgeNo] != ULONG_MAX )
+      if ( rFace._aulNeighbours[iEdgeNo] != FACET_INDEX_MAX )
         SplitEdge(ulFacetPos, rFace._aulNeighbours[iEdgeNo], rP1);
       else
         SplitOpenEdge(ulFacetPos, iEdgeNo, rP1);
@@ -1168,9 +1168,9 @@ void MeshTopoAlgorithm::SplitFacet(unsigned long ulFacetPos, const Base::Vector3
     }
 
     // split up the facet now
-    if ( rFace._aulNeighbours[iEdgeNo1] != ULONG_MAX )
+    if ( rFace._aulNeighbours[iEdgeNo1] != FACET_INDEX_MAX )
       SplitNeighbourFacet(ulFacetPos, iEdgeNo1, cP1);
-    if ( rFace._aulNeighbours[iEdgeNo2] != ULONG_MAX )
+    if ( rFace._aulNeighbours[iEdgeNo2] != FACET_INDEX_MAX )
       SplitNeighbourFacet(ulFacetPos, iEdgeNo2, cP1);
   }
 }
@@ -1189,7 +1189,7 @@ void MeshTopoAlgorithm::SplitNeighbourFacet(unsigned long ulFacetPos, unsigned s
   unsigned long ulSize = _rclMesh._aclFacetArray.size();
 
   // adjust the neighbourhood
-  if (rclN._aulNeighbours[(uNSide+1)%3] != ULONG_MAX)
+  if (rclN._aulNeighbours[(uNSide+1)%3] != FACET_INDEX_MAX)
     _rclMesh._aclFacetArray[rclN._aulNeighbours[(uNSide+1)%3]].ReplaceNeighbour(ulNeighbour, ulSize);
 
   MeshFacet cNew;
@@ -1244,15 +1244,15 @@ void MeshTopoAlgorithm::RemoveDegeneratedFacet(unsigned long index)
     if (rE0 == rE1) {
       unsigned long uN1 = rFace._aulNeighbours[(i+1)%3];
       unsigned long uN2 = rFace._aulNeighbours[(i+2)%3];
-      if (uN2 != ULONG_MAX)
+      if (uN2 != FACET_INDEX_MAX)
         _rclMesh._aclFacetArray[uN2].ReplaceNeighbour(index, uN1);
-      if (uN1 != ULONG_MAX)
+      if (uN1 != FACET_INDEX_MAX)
         _rclMesh._aclFacetArray[uN1].ReplaceNeighbour(index, uN2);
 
       // isolate the face and remove it
-      rFace._aulNeighbours[0] = ULONG_MAX;
-      rFace._aulNeighbours[1] = ULONG_MAX;
-      rFace._aulNeighbours[2] = ULONG_MAX;
+      rFace._aulNeighbours[0] = FACET_INDEX_MAX;
+      rFace._aulNeighbours[1] = FACET_INDEX_MAX;
+      rFace._aulNeighbours[2] = FACET_INDEX_MAX;
       _rclMesh.DeleteFacet(index);
       return;
     }
@@ -1268,7 +1268,7 @@ void MeshTopoAlgorithm::RemoveDegeneratedFacet(unsigned long index)
     // adjust the neighbourhoods and point indices
     if (cVec1 * cVec2 < 0.0f) {
       unsigned long uN1 = rFace._aulNeighbours[(j+1)%3];
-      if (uN1 != ULONG_MAX) {
+      if (uN1 != FACET_INDEX_MAX) {
         // get the neighbour and common edge side
         MeshFacet& rNb = _rclMesh._aclFacetArray[uN1];
         unsigned short side = rNb.Side(index);
@@ -1280,12 +1280,12 @@ void MeshTopoAlgorithm::RemoveDegeneratedFacet(unsigned long index)
         // set correct neighbourhood
         unsigned long uN2 = rFace._aulNeighbours[(j+2)%3];
         rNb._aulNeighbours[side] = uN2;
-        if (uN2 != ULONG_MAX) {
+        if (uN2 != FACET_INDEX_MAX) {
           _rclMesh._aclFacetArray[uN2].ReplaceNeighbour(index, uN1);
         }
         unsigned long uN3 = rNb._aulNeighbours[(side+1)%3];
         rFace._aulNeighbours[(j+1)%3] = uN3;
-        if (uN3 != ULONG_MAX) {
+        if (uN3 != FACET_INDEX_MAX) {
           _rclMesh._aclFacetArray[uN3].ReplaceNeighbour(uN1, index);
         }
         rNb._aulNeighbours[(side+1)%3] = index;
@@ -1309,15 +1309,15 @@ void MeshTopoAlgorithm::RemoveCorruptedFacet(unsigned long index)
     if (rFace._aulPoints[i] == rFace._aulPoints[(i+1)%3]) {
       unsigned long uN1 = rFace._aulNeighbours[(i+1)%3];
       unsigned long uN2 = rFace._aulNeighbours[(i+2)%3];
-      if (uN2 != ULONG_MAX)
+      if (uN2 != FACET_INDEX_MAX)
         _rclMesh._aclFacetArray[uN2].ReplaceNeighbour(index, uN1);
-      if (uN1 != ULONG_MAX)
+      if (uN1 != FACET_INDEX_MAX)
         _rclMesh._aclFacetArray[uN1].ReplaceNeighbour(index, uN2);
 
       // isolate the face and remove it
-      rFace._aulNeighbours[0] = ULONG_MAX;
-      rFace._aulNeighbours[1] = ULONG_MAX;
-      rFace._aulNeighbours[2] = ULONG_MAX;
+      rFace._aulNeighbours[0] = FACET_INDEX_MAX;
+      rFace._aulNeighbours[1] = FACET_INDEX_MAX;
+      rFace._aulNeighbours[2] = FACET_INDEX_MAX;
       _rclMesh.DeleteFacet(index);
       return;
     }
@@ -1531,7 +1531,7 @@ void MeshComponents::SearchForComponents(TMode tMode, const std::vector<unsigned
   std::vector<std::vector<unsigned long> > aclConnectComp;
   MeshTopFacetVisitor clFVisitor( aclComponent );
 
-  while ( ulStartFacet !=  ULONG_MAX )
+  while ( ulStartFacet !=  FACET_INDEX_MAX )
   {
     // collect all facets of a component
     aclComponent.clear();
@@ -1552,7 +1552,7 @@ void MeshComponents::SearchForComponents(TMode tMode, const std::vector<unsigned
     if (iTri < iEnd)
       ulStartFacet = iTri - iBeg;
     else
-      ulStartFacet = ULONG_MAX;
+      ulStartFacet = FACET_INDEX_MAX;
   }
 
   // sort components by size (descending order)
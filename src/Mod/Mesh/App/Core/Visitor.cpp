@@ -34,7 +34,7 @@ unsigned long MeshKernel::VisitNeighbourFacets (MeshFacetVisitor &rclFVisitor, u
             // visit all neighbours of the current level if not yet done
             for (unsigned short i = 0; i < 3; i++) {
                 j = clCurrFacet->_aulNeighbours[i]; // index to neighbour facet
-                if (j == ULONG_MAX) 
+                if (j == FACET_INDEX_MAX) 
                     continue;      // no neighbour facet
 
                 if (j >= ulCount) 
@@ -18,7 +18,7 @@ Facet::Facet(const MeshCore::MeshFacet& face, MeshObject* obj, unsigned long ind
         PIndex[i] = face._aulPoints[i];
         NIndex[i] = face._aulNeighbours[i];
     }
-    if (Mesh.isValid() && index != ULONG_MAX) {
+    if (Mesh.isValid() && index != MeshCore::FACET_INDEX_MAX) {
         for (int i=0; i<3; i++) {
             Base::Vector3d vert = Mesh->getPoint(PIndex[i]);
             _aclPoints[i].Set((float)vert.x, (float)vert.y, (float)vert.z);
@@ -27,11 +27,11 @@ class MeshObject;
 class Standard_EXPORT Facet : public MeshCore::MeshGeomFacet
 {
 public:
-    Facet(const MeshCore::MeshFacet& face = MeshCore::MeshFacet(), MeshObject* obj = 0, unsigned long index = ULONG_MAX);
+    Facet(const MeshCore::MeshFacet& face = MeshCore::MeshFacet(), MeshObject* obj = 0, unsigned long index = MeshCore::FACET_INDEX_MAX);
     Facet(const Facet& f);
     ~Facet();
 
-    bool isBound(void) const {return Index != ULONG_MAX;}
+    bool isBound(void) const {return Index != MeshCore::FACET_INDEX_MAX;}
     void operator = (const Facet& f);
 
     unsigned long Index;
@@ -55,7 +55,7 @@ PyObject*  FacetPy::unbound(PyObject *args)
 {
     if (!PyArg_ParseTuple(args, ""))
         return NULL;
-    getFacetPtr()->Index = ULONG_MAX;
+    getFacetPtr()->Index = MeshCore::FACET_INDEX_MAX;
     getFacetPtr()->Mesh = 0;
     Py_Return;
 }
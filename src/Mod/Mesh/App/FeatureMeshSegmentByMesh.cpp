@@ -100,7 +100,7 @@ App::DocumentObjectExecReturn *SegmentByMesh::execute(void)
         // so we need the nearest facet to the front clipping plane
         //
         float fDist = FLOAT_MAX;
-        unsigned long uIdx=ULONG_MAX;
+        unsigned long uIdx=MeshCore::FACET_INDEX_MAX;
         MeshFacetIterator cFIt(rMeshKernel);
 
         // get the nearest facet to the user (front clipping plane)
@@ -114,7 +114,7 @@ App::DocumentObjectExecReturn *SegmentByMesh::execute(void)
         }
 
         // succeeded
-        if ( uIdx != ULONG_MAX ) {
+        if ( uIdx != MeshCore::FACET_INDEX_MAX ) {
             // set VISIT-Flag to all outer facets
             cAlg.SetFacetFlag( MeshFacet::VISIT );
             cAlg.ResetFacetsFlag(faces, MeshFacet::VISIT);
@@ -31,6 +31,7 @@ SetOperations::SetOperations(void)
     ADD_PROPERTY(Source1  ,(0));
     ADD_PROPERTY(Source2  ,(0));
     ADD_PROPERTY(OperationType, ("union"));
+    ADD_PROPERTY(Algorithm, ("grid"));
 }
 
 short SetOperations::mustExecute() const
@@ -42,6 +43,8 @@ short SetOperations::mustExecute() const
             return 1;
         if (OperationType.isTouched())
             return 1;
+        if (Algorithm.isTouched())
+            return 1;
     }
 
     return 0;
@@ -74,8 +77,17 @@ App::DocumentObjectExecReturn *SetOperations::execute(void)
             throw Base::ValueError("Operation type must either be 'union' or 'intersection'"
                                    " or 'difference' or 'inner' or 'outer'");
 
+        MeshCore::SetOperations::SearchMethod method;
+        string alg(Algorithm.getValue());
+        if (alg == "grid")
+            method = MeshCore::SetOperations::GridSearch;
+        else if (alg == "bvh")
+            method = MeshCore::SetOperations::BVHSearch;
+        else
+            throw Base::ValueError("Algorithm must either be 'grid' or 'bvh'");
+
         MeshCore::SetOperations setOp(meshKernel1.getKernel(), meshKernel2.getKernel(), 
-            pcKernel->getKernel(), type, 1.0e-5f);
+            pcKernel->getKernel(), type, 1.0e-5f, method);
         setOp.Do();
         Mesh.setValuePtr(pcKernel.release());
     }
@@ -33,6 +33,7 @@ public:
     App::PropertyLink   Source1;
     App::PropertyLink   Source2;
     App::PropertyString OperationType;
+    App::PropertyString Algorithm;
 
     /** @name methods override Feature */
     //@{
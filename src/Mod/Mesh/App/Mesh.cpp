@@ -8,6 +8,7 @@
 # include <sstream>
 
 #include <CXX/Objects.hxx>
+#include <App/Application.h>
 #include "Base/Builder3D.h"
 #include "Base/Console.h"
 #include "Base/Exception.h"
@@ -302,7 +303,15 @@ void MeshObject::Save (Base::Writer &/*writer*/) const
 
 void MeshObject::SaveDocFile (Base::Writer &writer) const
 {
-    _kernel.Write(writer.Stream());
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Document");
+    if (hGrp->GetBool("CompressMeshData", false)) {
+        float precision = static_cast<float>(hGrp->GetFloat("CompressMeshPrecision", 0.0));
+        _kernel.WriteCompressed(writer.Stream(), precision);
+    }
+    else {
+        _kernel.Write(writer.Stream());
+    }
 }
 
 void MeshObject::Restore(Base::XMLReader &/*reader*/)
@@ -599,11 +608,11 @@ void MeshObject::deletedFacets(const std::vector<unsigned long>& remFacets)
         return; // nothing has changed
     if (this->_segments.empty())
         return; // nothing to do
-    // set an array with the original indices and mark the removed as ULONG_MAX
+    // set an array with the original indices and mark the removed as MeshCore::FACET_INDEX_MAX
     std::vector<unsigned long> f_indices(_kernel.CountFacets()+remFacets.size());
     for (std::vector<unsigned long>::const_iterator it = remFacets.begin();
         it != remFacets.end(); ++it) {
-        f_indices[*it] = ULONG_MAX;
+        f_indices[*it] = MeshCore::FACET_INDEX_MAX;
     }
 
     unsigned long index = 0;
@@ -626,7 +635,7 @@ void MeshObject::deletedFacets(const std::vector<unsigned long>& remFacets)
             std::sort(segm.begin(), segm.end());
             std::vector<unsigned long>::iterator ft = std::find_if
                 (segm.begin(), segm.end(), 
-                std::bind2nd(std::equal_to<unsigned long>(), ULONG_MAX));
+                std::bind2nd(std::equal_to<unsigned long>(), MeshCore::FACET_INDEX_MAX));
             if (ft != segm.end())
                 segm.erase(ft, segm.end());
             it->_indices = segm;
@@ -923,10 +932,13 @@ void MeshObject::smooth(int iterations, float d_max)
     _kernel.Smooth(iterations, d_max);
 }
 
-void MeshObject::decimate(float fTolerance, float fReduction)
+void MeshObject::decimate(float fTolerance, float fReduction, bool parallel)
 {
     MeshCore::MeshSimplify dm(this->_kernel);
-    dm.simplify(fTolerance, fReduction);
+    if (parallel)
+        dm.simplifyParallel(fTolerance, fReduction);
+    else
+        dm.simplify(fTolerance, fReduction);
 }
 
 Base::Vector3d MeshObject::getPointNormal(unsigned long index) const
@@ -1025,7 +1037,13 @@ void MeshObject::trim(const Base::Polygon2d& polygon2d,
         this->_kernel.AddFacets(triangle);
 }
 
-MeshObject* MeshObject::unite(const MeshObject& mesh) const
+static MeshCore::SetOperations::SearchMethod searchMethod(MeshObject::BooleanMethod method)
+{
+    return method == MeshObject::BVH ? MeshCore::SetOperations::BVHSearch
+                                     : MeshCore::SetOperations::GridSearch;
+}
+
+MeshObject* MeshObject::unite(const MeshObject& mesh, BooleanMethod method) const
 {
     MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
@@ -1033,12 +1051,13 @@ MeshObject* MeshObject::unite(const MeshObject& mesh) const
     MeshCore::MeshKernel kernel2(mesh._kernel);
     kernel2.Transform(mesh._Mtrx);
     MeshCore::SetOperations setOp(kernel1, kernel2, result,
-                                  MeshCore::SetOperations::Union, Epsilon);
+                                  MeshCore::SetOperations::Union, Epsilon,
+                                  searchMethod(method));
     setOp.Do();
     return new MeshObject(result);
 }
 
-MeshObject* MeshObject::intersect(const MeshObject& mesh) const
+MeshObject* MeshObject::intersect(const MeshObject& mesh, BooleanMethod method) const
 {
     MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
@@ -1046,12 +1065,13 @@ MeshObject* MeshObject::intersect(const MeshObject& mesh) const
     MeshCore::MeshKernel kernel2(mesh._kernel);
     kernel2.Transform(mesh._Mtrx);
     MeshCore::SetOperations setOp(kernel1, kernel2, result,
-                                  MeshCore::SetOperations::Intersect, Epsilon);
+                                  MeshCore::SetOperations::Intersect, Epsilon,
+                                  searchMethod(method));
     setOp.Do();
     return new MeshObject(result);
 }
 
-MeshObject* MeshObject::subtract(const MeshObject& mesh) const
+MeshObject* MeshObject::subtract(const MeshObject& mesh, BooleanMethod method) const
 {
     MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
@@ -1059,12 +1079,13 @@ MeshObject* MeshObject::subtract(const MeshObject& mesh) const
     MeshCore::MeshKernel kernel2(mesh._kernel);
     kernel2.Transform(mesh._Mtrx);
     MeshCore::SetOperations setOp(kernel1, kernel2, result,
-                                  MeshCore::SetOperations::Difference, Epsilon);
+                                  MeshCore::SetOperations::Difference, Epsilon,
+                                  searchMethod(method));
     setOp.Do();
     return new MeshObject(result);
 }
 
-MeshObject* MeshObject::inner(const MeshObject& mesh) const
+MeshObject* MeshObject::inner(const MeshObject& mesh, BooleanMethod method) const
 {
     MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
@@ -1072,12 +1093,13 @@ MeshObject* MeshObject::inner(const MeshObject& mesh) const
     MeshCore::MeshKernel kernel2(mesh._kernel);
     kernel2.Transform(mesh._Mtrx);
     MeshCore::SetOperations setOp(kernel1, kernel2, result,
-                                  MeshCore::SetOperations::Inner, Epsilon);
+                                  MeshCore::SetOperations::Inner, Epsilon,
+                                  searchMethod(method));
     setOp.Do();
     return new MeshObject(result);
 }
 
-MeshObject* MeshObject::outer(const MeshObject& mesh) const
+MeshObject* MeshObject::outer(const MeshObject& mesh, BooleanMethod method) const
 {
     MeshCore::MeshKernel result;
     MeshCore::MeshKernel kernel1(this->_kernel);
@@ -1085,7 +1107,8 @@ MeshObject* MeshObject::outer(const MeshObject& mesh) const
     MeshCore::MeshKernel kernel2(mesh._kernel);
     kernel2.Transform(mesh._Mtrx);
     MeshCore::SetOperations setOp(kernel1, kernel2, result,
-                                  MeshCore::SetOperations::Outer, Epsilon);
+                                  MeshCore::SetOperations::Outer, Epsilon,
+                                  searchMethod(method));
     setOp.Do();
     return new MeshObject(result);
 }
@@ -1144,7 +1167,7 @@ void MeshObject::splitEdges()
     const MeshCore::MeshFacetArray& rFacets = _kernel.GetFacets();
     for (MeshCore::MeshFacetArray::_TConstIterator pF = rFacets.begin(); pF != rFacets.end(); ++pF) {
         int id=2;
-        if (pF->_aulNeighbours[id] != ULONG_MAX) {
+        if (pF->_aulNeighbours[id] != MeshCore::FACET_INDEX_MAX) {
             const MeshCore::MeshFacet& rFace = rFacets[pF->_aulNeighbours[id]];
             if (!pF->IsFlag(MeshCore::MeshFacet::VISIT) && !rFace.IsFlag(MeshCore::MeshFacet::VISIT)) {
                 pF->SetFlag(MeshCore::MeshFacet::VISIT);
@@ -57,6 +57,7 @@ class Standard_EXPORT MeshObject : public Data::ComplexGeoData
 public:
     enum GeometryType {PLANE, CYLINDER, SPHERE};
     enum CutType {INNER, OUTER};
+    enum BooleanMethod {GRID, BVH};
 
     // typedef needed for cross-section
     typedef std::pair<Base::Vector3f, Base::Vector3f> TPlane;
@@ -200,7 +201,7 @@ public:
     void movePoint(unsigned long, const Base::Vector3d& v);
     void setPoint(unsigned long, const Base::Vector3d& v);
     void smooth(int iterations, float d_max);
-    void decimate(float fTolerance, float fReduction);
+    void decimate(float fTolerance, float fReduction, bool parallel = false);
     Base::Vector3d getPointNormal(unsigned long) const;
     std::vector<Base::Vector3d> getPointNormals() const;
     void crossSections(const std::vector<TPlane>&, std::vector<TPolylines> &sections,
@@ -229,11 +230,11 @@ public:
 
     /** @name Boolean operations */
     //@{
-    MeshObject* unite(const MeshObject&) const;
-    MeshObject* intersect(const MeshObject&) const;
-    MeshObject* subtract(const MeshObject&) const;
-    MeshObject* inner(const MeshObject&) const;
-    MeshObject* outer(const MeshObject&) const;
+    MeshObject* unite(const MeshObject&, BooleanMethod method = GRID) const;
+    MeshObject* intersect(const MeshObject&, BooleanMethod method = GRID) const;
+    MeshObject* subtract(const MeshObject&, BooleanMethod method = GRID) const;
+    MeshObject* inner(const MeshObject&, BooleanMethod method = GRID) const;
+    MeshObject* outer(const MeshObject&, BooleanMethod method = GRID) const;
     //@}
 
     /** @name Topological operations */
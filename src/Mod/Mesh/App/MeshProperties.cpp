@@ -136,9 +136,8 @@ void PropertyNormalList::SaveDocFile (Base::Writer &writer) const
     Base::OutputStream str(writer.Stream());
     uint32_t uCt = (uint32_t)getSize();
     str << uCt;
-    for (std::vector<Base::Vector3f>::const_iterator it = _lValueList.begin(); it != _lValueList.end(); ++it) {
-        str << it->x << it->y << it->z;
-    }
+    if (uCt > 0)
+        str.write(&_lValueList[0].x, 3 * _lValueList.size());
 }
 
 void PropertyNormalList::RestoreDocFile(Base::Reader &reader)
@@ -147,9 +146,8 @@ void PropertyNormalList::RestoreDocFile(Base::Reader &reader)
     uint32_t uCt=0;
     str >> uCt;
     std::vector<Base::Vector3f> values(uCt);
-    for (std::vector<Base::Vector3f>::iterator it = values.begin(); it != values.end(); ++it) {
-        str >> it->x >> it->y >> it->z;
-    }
+    if (uCt > 0)
+        str.read(&values[0].x, 3 * values.size());
     setValues(values);
 }
 
@@ -415,15 +413,39 @@ PropertyMeshKernel::PropertyMeshKernel()
 }
 
 PropertyMeshKernel::~PropertyMeshKernel()
+{
+    releasePyObject();
+}
+
+void PropertyMeshKernel::releasePyObject()
 {
     if (meshPyObject) {
         // Note: Do not call setInvalid() of the Python binding 
         // because the mesh should still be accessible afterwards.
         meshPyObject->parentProperty = 0;
         Py_DECREF(meshPyObject);
+        meshPyObject = 0;
     }
 }
 
+void PropertyMeshKernel::detachMesh(bool keepData)
+{
+    // the Python binding holds a reference, too
+    int owners = meshPyObject ? 2 : 1;
+    if (_meshObject.getRefCount() <= owners)
+        return;
+
+    if (keepData)
+        _meshObject = new MeshObject(*_meshObject);
+    else
+        _meshObject = new MeshObject(MeshCore::MeshKernel(), _meshObject->getTransform());
+    // The binding must follow the property: methods of MeshPy call startEditing()
+    // and then modify the mesh of the binding, which otherwise would still be
+    // the shared one, i.e. the undo copy.
+    if (meshPyObject)
+        meshPyObject->setMeshObjectPtr(_meshObject);
+}
+
 void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
 {
     // use the tmp. object to guarantee that the referenced mesh is not destroyed
@@ -431,12 +453,15 @@ void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
     Base::Reference<MeshObject> tmp(_meshObject);
     aboutToSetValue();
     _meshObject = mesh;
+    if (&*tmp != mesh)
+        releasePyObject();
     hasSetValue();
 }
 
 void PropertyMeshKernel::setValue(const MeshObject& mesh)
 {
     aboutToSetValue();
+    detachMesh(false);
     *_meshObject = mesh;
     hasSetValue();
 }
@@ -444,6 +469,7 @@ void PropertyMeshKernel::setValue(const MeshObject& mesh)
 void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
+    detachMesh(false);
     _meshObject->setKernel(mesh);
     hasSetValue();
 }
@@ -451,6 +477,7 @@ void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 {
     aboutToSetValue();
+    detachMesh(true);
     _meshObject->swap(mesh);
     hasSetValue();
 }
@@ -458,6 +485,7 @@ void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 void PropertyMeshKernel::swapMesh(MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
+    detachMesh(true);
     _meshObject->swap(mesh);
     hasSetValue();
 }
@@ -493,6 +521,7 @@ unsigned int PropertyMeshKernel::getMemSize (void) const
 MeshObject* PropertyMeshKernel::startEditing()
 {
     aboutToSetValue();
+    detachMesh(true);
     return (MeshObject*)_meshObject;
 }
 
@@ -504,6 +533,7 @@ void PropertyMeshKernel::finishEditing()
 void PropertyMeshKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
     aboutToSetValue();
+    detachMesh(true);
     _meshObject->transformGeometry(rclMat);
     hasSetValue();
 }
@@ -511,6 +541,7 @@ void PropertyMeshKernel::transformGeometry(const Base::Matrix4D &rclMat)
 void PropertyMeshKernel::setPointIndices(const std::vector<std::pair<unsigned long, Base::Vector3f> >& inds)
 {
     aboutToSetValue();
+    detachMesh(true);
     MeshCore::MeshKernel& kernel = _meshObject->getKernel();
     for (std::vector<std::pair<unsigned long, Base::Vector3f> >::const_iterator it = inds.begin(); it != inds.end(); ++it)
         kernel.SetPoint(it->first, it->second);
@@ -582,6 +613,7 @@ void PropertyMeshKernel::Restore(Base::XMLReader &reader)
         kernel.Adopt(points, facets);
 
         aboutToSetValue();
+        detachMesh(false);
         _meshObject->getKernel().Adopt(points, facets);
         hasSetValue();
     } 
@@ -593,29 +625,60 @@ void PropertyMeshKernel::Restore(Base::XMLReader &reader)
 
 void PropertyMeshKernel::SaveDocFile (Base::Writer &writer) const
 {
-    _meshObject->save(writer.Stream());
+    _meshObject->SaveDocFile(writer);
 }
 
 void PropertyMeshKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    detachMesh(false);
     _meshObject->load(reader);
     hasSetValue();
 }
 
+bool PropertyMeshKernel::readDocFile(Base::Reader &reader)
+{
+    // the mesh is read into a separate object that is taken over by applyDocFile()
+    _restoredMesh = new MeshObject();
+    _restoredMesh->load(reader);
+    return true;
+}
+
+void PropertyMeshKernel::applyDocFile()
+{
+    if (!_restoredMesh.isValid())
+        return;
+
+    aboutToSetValue();
+    detachMesh(false);
+    _meshObject->swap(_restoredMesh->getKernel());
+    _restoredMesh = Base::Reference<MeshObject>();
+    hasSetValue();
+}
+
+void PropertyMeshKernel::discardDocFile()
+{
+    _restoredMesh = Base::Reference<MeshObject>();
+}
+
 App::Property *PropertyMeshKernel::Copy(void) const
 {
-    // Note: Copy the content, do NOT reference the same mesh object
+    // Note: Reference the same mesh object, it gets copied as soon as one of
+    // the properties is about to modify it
     PropertyMeshKernel *prop = new PropertyMeshKernel();
-    *(prop->_meshObject) = *(this->_meshObject);
+    prop->_meshObject = this->_meshObject;
     return prop;
 }
 
 void PropertyMeshKernel::Paste(const App::Property &from)
 {
-    // Note: Copy the content, do NOT reference the same mesh object
+    // Note: Reference the same mesh object, it gets copied as soon as one of
+    // the properties is about to modify it
     aboutToSetValue();
     const PropertyMeshKernel& prop = dynamic_cast<const PropertyMeshKernel&>(from);
-    *(this->_meshObject) = *(prop._meshObject);
+    if (&*this->_meshObject != &*prop._meshObject) {
+        this->_meshObject = prop._meshObject;
+        releasePyObject();
+    }
     hasSetValue();
 }
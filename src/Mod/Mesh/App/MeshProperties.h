@@ -228,13 +228,26 @@ public:
 
     void SaveDocFile (Base::Writer &writer) const;
     void RestoreDocFile(Base::Reader &reader);
+    bool readDocFile(Base::Reader &reader);
+    void applyDocFile();
+    void discardDocFile();
 
     App::Property *Copy(void) const;
     void Paste(const App::Property &from);
     //@}
 
+private:
+    /** The mesh object is shared with the copies of this property made for undo/redo.
+     * Before it gets modified the property gets its own mesh object, if \a keepData is
+     * false only the placement is copied because the caller replaces the mesh data anyway.
+     */
+    void detachMesh(bool keepData);
+    void releasePyObject();
+
 private:
     Base::Reference<MeshObject> _meshObject;
+    // The mesh read by readDocFile() until applyDocFile() takes it over
+    Base::Reference<MeshObject> _restoredMesh;
     MeshPy* meshPyObject;
 };
 
@@ -42,6 +42,14 @@ private:
     PropertyMeshKernel* prop;
 };
 
+void MeshPy::setMeshObjectPtr(MeshObject* mesh)
+{
+    // the binding holds a reference to its mesh, see ComplexGeoDataPy
+    mesh->ref();
+    getMeshObjectPtr()->unref();
+    _pcTwinPointer = mesh;
+}
+
 int MeshPy::PyInit(PyObject* args, PyObject*)
 {
     PyObject *pcObj=0;
@@ -407,17 +415,29 @@ PyObject*  MeshPy::crossSections(PyObject *args)
     return Py::new_reference_to(crossSections);
 }
 
+static MeshObject::BooleanMethod booleanMethod(const char* method)
+{
+    std::string name(method);
+    if (name == "grid")
+        return MeshObject::GRID;
+    else if (name == "bvh")
+        return MeshObject::BVH;
+    throw Base::ValueError("Method must either be 'grid' or 'bvh'");
+}
+
 PyObject*  MeshPy::unite(PyObject *args)
 {
     MeshPy   *pcObject;
     PyObject *pcObj;
-    if (!PyArg_ParseTuple(args, "O!", &(MeshPy::Type), &pcObj))     // convert args: Python->C 
+    const char *method = "grid";
+    if (!PyArg_ParseTuple(args, "O!|s", &(MeshPy::Type), &pcObj, &method))     // convert args: Python->C 
         return NULL;                             // NULL triggers exception 
 
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->unite(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh = getMeshObjectPtr()->unite(*pcObject->getMeshObjectPtr(),
+                                                     booleanMethod(method));
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -428,13 +448,15 @@ PyObject*  MeshPy::intersect(PyObject *args)
 {
     MeshPy   *pcObject;
     PyObject *pcObj;
-    if (!PyArg_ParseTuple(args, "O!", &(MeshPy::Type), &pcObj))     // convert args: Python->C 
+    const char *method = "grid";
+    if (!PyArg_ParseTuple(args, "O!|s", &(MeshPy::Type), &pcObj, &method))     // convert args: Python->C 
         return NULL;                             // NULL triggers exception 
 
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->intersect(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh = getMeshObjectPtr()->intersect(*pcObject->getMeshObjectPtr(),
+                                                         booleanMethod(method));
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -445,13 +467,15 @@ PyObject*  MeshPy::difference(PyObject *args)
 {
     MeshPy   *pcObject;
     PyObject *pcObj;
-    if (!PyArg_ParseTuple(args, "O!", &(MeshPy::Type), &pcObj))     // convert args: Python->C 
+    const char *method = "grid";
+    if (!PyArg_ParseTuple(args, "O!|s", &(MeshPy::Type), &pcObj, &method))     // convert args: Python->C 
         return NULL;                             // NULL triggers exception 
 
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->subtract(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh = getMeshObjectPtr()->subtract(*pcObject->getMeshObjectPtr(),
+                                                        booleanMethod(method));
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -462,13 +486,15 @@ PyObject*  MeshPy::inner(PyObject *args)
 {
     MeshPy   *pcObject;
     PyObject *pcObj;
-    if (!PyArg_ParseTuple(args, "O!", &(MeshPy::Type), &pcObj))     // convert args: Python->C 
+    const char *method = "grid";
+    if (!PyArg_ParseTuple(args, "O!|s", &(MeshPy::Type), &pcObj, &method))     // convert args: Python->C 
         return NULL;                             // NULL triggers exception 
 
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->inner(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh = getMeshObjectPtr()->inner(*pcObject->getMeshObjectPtr(),
+                                                     booleanMethod(method));
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -479,13 +505,15 @@ PyObject*  MeshPy::outer(PyObject *args)
 {
     MeshPy   *pcObject;
     PyObject *pcObj;
-    if (!PyArg_ParseTuple(args, "O!", &(MeshPy::Type), &pcObj))     // convert args: Python->C 
+    const char *method = "grid";
+    if (!PyArg_ParseTuple(args, "O!|s", &(MeshPy::Type), &pcObj, &method))     // convert args: Python->C 
         return NULL;                             // NULL triggers exception 
 
     pcObject = static_cast<MeshPy*>(pcObj);
 
     PY_TRY {
-        MeshObject* mesh = getMeshObjectPtr()->outer(*pcObject->getMeshObjectPtr());
+        MeshObject* mesh = getMeshObjectPtr()->outer(*pcObject->getMeshObjectPtr(),
+                                                     booleanMethod(method));
         return new MeshPy(mesh);
     } PY_CATCH;
 
@@ -1595,9 +1623,11 @@ PyObject*  MeshPy::smooth(PyObject *args, PyObject *kwds)
     int iter=1;
     double lambda = 0;
     double micro = 0;
-    static char* keywords_smooth[] = {"Method","Iteration","Lambda","Micro",NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|sidd",keywords_smooth,
-                                     &method, &iter, &lambda, &micro))
+    PyObject *parallel = Py_False;
+    static char* keywords_smooth[] = {"Method","Iteration","Lambda","Micro","Parallel",NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|siddO!",keywords_smooth,
+                                     &method, &iter, &lambda, &micro,
+                                     &PyBool_Type, &parallel))
         return 0;
 
     PY_TRY {
@@ -1605,12 +1635,14 @@ PyObject*  MeshPy::smooth(PyObject *args, PyObject *kwds)
         MeshCore::MeshKernel& kernel = getMeshObjectPtr()->getKernel();
         if (strcmp(method, "Laplace") == 0) {
             MeshCore::LaplaceSmoothing smooth(kernel);
+            smooth.SetParallel(PyObject_IsTrue(parallel) ? true : false);
             if (lambda > 0)
                 smooth.SetLambda(lambda);
             smooth.Smooth(iter);
         }
         else if (strcmp(method, "Taubin") == 0) {
             MeshCore::TaubinSmoothing smooth(kernel);
+            smooth.SetParallel(PyObject_IsTrue(parallel) ? true : false);
             if (lambda > 0)
                 smooth.SetLambda(lambda);
             if (micro > 0)
@@ -1619,6 +1651,7 @@ PyObject*  MeshPy::smooth(PyObject *args, PyObject *kwds)
         }
         else if (strcmp(method, "PlaneFit") == 0) {
             MeshCore::PlaneFitSmoothing smooth(kernel);
+            smooth.SetParallel(PyObject_IsTrue(parallel) ? true : false);
             smooth.Smooth(iter);
         }
         else {
@@ -1632,11 +1665,12 @@ PyObject*  MeshPy::smooth(PyObject *args, PyObject *kwds)
 PyObject*  MeshPy::decimate(PyObject *args)
 {
     float fTol, fRed;
-    if (!PyArg_ParseTuple(args, "ff", &fTol,&fRed))
+    PyObject *parallel = Py_False;
+    if (!PyArg_ParseTuple(args, "ff|O!", &fTol,&fRed, &PyBool_Type, &parallel))
         return NULL;
 
     PY_TRY {
-        getMeshObjectPtr()->decimate(fTol, fRed);
+        getMeshObjectPtr()->decimate(fTol, fRed, PyObject_IsTrue(parallel) ? true : false);
     } PY_CATCH;
 
     Py_Return;
@@ -1775,7 +1809,8 @@ PyObject*  MeshPy::getSegmentsOfType(PyObject *args)
 PyObject*  MeshPy::getSegmentsByCurvature(PyObject *args)
 {
     PyObject* l;
-    if (!PyArg_ParseTuple(args, "O",&l))
+    PyObject* parallel = Py_False;
+    if (!PyArg_ParseTuple(args, "O|O!",&l,&PyBool_Type,&parallel))
         return NULL;
 
     const MeshCore::MeshKernel& kernel = getMeshObjectPtr()->getKernel();
@@ -1796,7 +1831,10 @@ PyObject*  MeshPy::getSegmentsByCurvature(PyObject *args)
         segm.push_back(new MeshCore::MeshCurvatureFreeformSegment(meshCurv.GetCurvature(), num, tol1, tol2, c1, c2));
     }
 
-    finder.FindSegments(segm);
+    if (PyObject_IsTrue(parallel))
+        finder.FindSegmentsParallel(segm);
+    else
+        finder.FindSegments(segm);
 
     Py::List list;
     for (std::vector<MeshCore::MeshSurfaceSegment*>::iterator segmIt = segm.begin(); segmIt != segm.end(); ++segmIt) {
@@ -225,3 +225,27 @@ class PolynomialFitCases(unittest.TestCase):
 
     def tearDown(self):
         pass
+
+
+class MeshUndoTestCases(unittest.TestCase):
+    def setUp(self):
+        self.doc = FreeCAD.newDocument("MeshUndoTest")
+        self.doc.UndoMode = 1
+
+    def testEditInTransaction(self):
+        feature = self.doc.addObject("Mesh::Feature","Mesh")
+        feature.Mesh = Mesh.createBox(1.0,1.0,1.0)
+        topology = feature.Mesh.Topology[1]
+
+        # the methods of the binding must modify the mesh of the document,
+        # not the copy held by the transaction
+        self.doc.openTransaction("Flip normals")
+        feature.Mesh.flipNormals()
+        self.doc.commitTransaction()
+        self.failIf(feature.Mesh.Topology[1] == topology, "Normals of the document mesh not flipped")
+
+        self.doc.undo()
+        self.failUnless(feature.Mesh.Topology[1] == topology, "Undo didn't restore the mesh")
+
+    def tearDown(self):
+        FreeCAD.closeDocument("MeshUndoTest")
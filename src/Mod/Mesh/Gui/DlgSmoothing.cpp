@@ -85,6 +85,11 @@ bool DlgSmoothing::smoothSelection() const
     return ui->checkBoxSelection->isChecked();
 }
 
+bool DlgSmoothing::parallel() const
+{
+    return ui->checkBoxParallel->isChecked();
+}
+
 void DlgSmoothing::on_checkBoxSelection_toggled(bool on)
 {
     /*emit*/ toggledSelection(on);
@@ -175,6 +180,7 @@ bool TaskSmoothing::accept()
             case MeshGui::DlgSmoothing::Taubin:
                 {
                     MeshCore::TaubinSmoothing s(mm->getKernel());
+                    s.SetParallel(widget->parallel());
                     s.SetLambda(widget->lambdaStep());
                     s.SetMicro(widget->microStep());
                     if (widget->smoothSelection()) {
@@ -187,6 +193,7 @@ bool TaskSmoothing::accept()
             case MeshGui::DlgSmoothing::Laplace:
                 {
                     MeshCore::LaplaceSmoothing s(mm->getKernel());
+                    s.SetParallel(widget->parallel());
                     s.SetLambda(widget->lambdaStep());
                     if (widget->smoothSelection()) {
                         s.SmoothPoints(widget->iterations(), selection);
@@ -36,6 +36,7 @@ public:
     double microStep() const;
     Smooth method() const;
     bool smoothSelection() const;
+    bool parallel() const;
 
 private Q_SLOTS:
     void method_clicked(int);
@@ -70,6 +71,8 @@ public:
     { return widget->method(); }
     bool smoothSelection() const
     { return widget->smoothSelection(); }
+    bool parallel() const
+    { return widget->parallel(); }
 
 private:
     DlgSmoothing* widget;
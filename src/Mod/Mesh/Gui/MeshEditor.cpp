@@ -288,8 +288,8 @@ void MeshFaceAddition::showMarker(SoPickedPoint* pp)
                 int index = (int)f._aulPoints[i];
                 if (std::find(faceView->index.begin(), faceView->index.end(), index) != faceView->index.end())
                     continue; // already inside
-                if (f._aulNeighbours[i] == ULONG_MAX ||
-                    f._aulNeighbours[(i+2)%3] == ULONG_MAX) {
+                if (f._aulNeighbours[i] == MeshCore::FACET_INDEX_MAX ||
+                    f._aulNeighbours[(i+2)%3] == MeshCore::FACET_INDEX_MAX) {
                     pnt = points[index];
                     float len = Base::DistanceP2(pnt, Base::Vector3f(vec[0],vec[1],vec[2]));
                     if (len < distance) {
@@ -590,7 +590,7 @@ float MeshFillHole::findClosestPoint(const SbLine& ray, const TBoundary& polygon
 {
     // now check which vertex of the polygon is closest to the ray
     float minDist = FLT_MAX;
-    vertex_index = ULONG_MAX;
+    vertex_index = MeshCore::POINT_INDEX_MAX;
 
     const MeshCore::MeshKernel & rMesh = myMesh->Mesh.getValue().getKernel();
     const MeshCore::MeshPointArray& pts = rMesh.GetPoints();
@@ -1088,7 +1088,7 @@ void SoFCMeshOpenEdgeSet::drawLines(const MeshCore::MeshPointArray * rPoints,
   glBegin(GL_LINES);
   for ( MeshCore::MeshFacetArray::_TConstIterator it = rFacets->begin(); it != rFacets->end(); ++it ) {
     for ( int i=0; i<3; i++ ) {
-      if ( it->_aulNeighbours[i] == ULONG_MAX ) {
+      if ( it->_aulNeighbours[i] == MeshCore::FACET_INDEX_MAX ) {
         glVertex((*rPoints)[it->_aulPoints[i]]);
         glVertex((*rPoints)[it->_aulPoints[(i+1)%3]]);
       }
@@ -1116,7 +1116,7 @@ void SoFCMeshOpenEdgeSet::generatePrimitives(SoAction* action)
   for ( MeshCore::MeshFacetArray::_TConstIterator it = rFacets->begin(); it != rFacets->end(); ++it )
   {
     for ( int i=0; i<3; i++ ) {
-      if ( it->_aulNeighbours[i] == ULONG_MAX ) {
+      if ( it->_aulNeighbours[i] == MeshCore::FACET_INDEX_MAX ) {
         const MeshCore::MeshPoint& v0 = (*rPoints)[it->_aulPoints[i]];
         const MeshCore::MeshPoint& v1 = (*rPoints)[it->_aulPoints[(i+1)%3]];
 
@@ -1174,7 +1174,7 @@ void SoFCMeshOpenEdgeSet::getPrimitiveCount(SoGetPrimitiveCountAction * action)
   int ctEdges=0;
   for ( MeshCore::MeshFacetArray::_TConstIterator jt = rFaces->begin(); jt != rFaces->end(); ++jt ) {
     for ( int i=0; i<3; i++ ) {
-      if ( jt->_aulNeighbours[i] == ULONG_MAX ) {
+      if ( jt->_aulNeighbours[i] == MeshCore::FACET_INDEX_MAX ) {
         ctEdges++;
       }
     }
@@ -566,6 +566,7 @@ SoFCMeshObjectShape::SoFCMeshObjectShape()
     : renderTriangleLimit(UINT_MAX)
     , selectBuf(0)
     , updateGLArray(false)
+    , updateVBO(false)
 {
     SO_NODE_CONSTRUCTOR(SoFCMeshObjectShape);
     setName(SoFCMeshObjectShape::getClassTypeId().getName());
@@ -579,6 +580,7 @@ void SoFCMeshObjectShape::notify(SoNotList * node)
 {
     inherited::notify(node);
     updateGLArray = true;
+    updateVBO = true;
 }
 
 #define RENDER_GLARRAYS
@@ -619,11 +621,24 @@ void SoFCMeshObjectShape::GLRender(SoGLRenderAction *action)
             }
             else {
 #ifdef RENDER_GLARRAYS
-                if (updateGLArray) {
-                    updateGLArray = false;
-                    generateGLArrays(state);
+                // get the VBO status of the viewer
+                SbBool useVBO = true;
+                Gui::SoGLVBOActivatedElement::get(state, useVBO);
+
+                // Check for a matching OpenGL context
+                if (useVBO && !render.canRenderGLArray(action))
+                    useVBO = false;
+
+                if (useVBO) {
+                    renderFacesVBO(action, mesh);
+                }
+                else {
+                    if (updateGLArray) {
+                        updateGLArray = false;
+                        generateGLArrays(mesh, this->vertex_array, this->index_array);
+                    }
+                    renderFacesGLArray(action);
                 }
-                renderFacesGLArray(action);
 #else
                 drawFaces(mesh, 0, mbind, needNormals, ccw);
 #endif
@@ -839,12 +854,12 @@ void SoFCMeshObjectShape::drawPoints(const Mesh::MeshObject * mesh, SbBool needN
     }
 }
 
-void SoFCMeshObjectShape::generateGLArrays(SoState * state)
+void SoFCMeshObjectShape::generateGLArrays(const Mesh::MeshObject * mesh,
+                                           std::vector<float>& vertex,
+                                           std::vector<int32_t>& index) const
 {
-    const Mesh::MeshObject * mesh = SoFCMeshObjectElement::get(state);
-
-    this->index_array.resize(0);
-    this->vertex_array.resize(0);
+    vertex.resize(0);
+    index.resize(0);
 
     std::vector<float> face_vertices;
     std::vector<int32_t> face_indices;
@@ -901,8 +916,8 @@ void SoFCMeshObjectShape::generateGLArrays(SoState * state)
     }
 #endif
 
-    this->index_array.swap(face_indices);
-    this->vertex_array.swap(face_vertices);
+    index.swap(face_indices);
+    vertex.swap(face_vertices);
 }
 
 void SoFCMeshObjectShape::renderFacesGLArray(SoGLRenderAction *action)
@@ -920,6 +935,33 @@ void SoFCMeshObjectShape::renderFacesGLArray(SoGLRenderAction *action)
     glDisableClientState(GL_NORMAL_ARRAY);
 }
 
+/**
+ * Renders the triangles from vertex buffer objects. The buffers are only
+ * filled again after the mesh has changed, so that the client-side arrays
+ * need not to be kept in memory.
+ */
+void SoFCMeshObjectShape::renderFacesVBO(SoGLRenderAction *action, const Mesh::MeshObject * mesh)
+{
+    if (mesh->countFacets() == 0)
+        return;
+
+    if (updateVBO) {
+        updateVBO = false;
+        std::vector<float> face_vertices;
+        std::vector<int32_t> face_indices;
+        generateGLArrays(mesh, face_vertices, face_indices);
+        render.generateGLArrays(action, SoMaterialBindingElement::OVERALL,
+                                face_vertices, face_indices);
+
+        // the client-side arrays are not needed any more
+        std::vector<float>().swap(this->vertex_array);
+        std::vector<int32_t>().swap(this->index_array);
+        updateGLArray = true;
+    }
+
+    render.renderFacesGLArray(action);
+}
+
 void SoFCMeshObjectShape::renderCoordsGLArray(SoGLRenderAction *action)
 {
     (void)action;
@@ -1682,7 +1724,7 @@ void SoFCMeshObjectBoundary::drawLines(const Mesh::MeshObject * mesh) const
     glBegin(GL_LINES);
     for (MeshCore::MeshFacetArray::_TConstIterator it = rFacets.begin(); it != rFacets.end(); ++it) {
         for (int i=0; i<3; i++) {
-            if (it->_aulNeighbours[i] == ULONG_MAX) {
+            if (it->_aulNeighbours[i] == MeshCore::FACET_INDEX_MAX) {
                 glVertex(rPoints[it->_aulPoints[i]]);
                 glVertex(rPoints[it->_aulPoints[(i+1)%3]]);
             }
@@ -1714,7 +1756,7 @@ void SoFCMeshObjectBoundary::generatePrimitives(SoAction* action)
     for (MeshCore::MeshFacetArray::_TConstIterator it = rFacets.begin(); it != rFacets.end(); ++it)
     {
         for (int i=0; i<3; i++) {
-            if (it->_aulNeighbours[i] == ULONG_MAX) {
+            if (it->_aulNeighbours[i] == MeshCore::FACET_INDEX_MAX) {
                 const MeshCore::MeshPoint& v0 = rPoints[it->_aulPoints[i]];
                 const MeshCore::MeshPoint& v1 = rPoints[it->_aulPoints[(i+1)%3]];
 
@@ -1778,7 +1820,7 @@ void SoFCMeshObjectBoundary::getPrimitiveCount(SoGetPrimitiveCountAction * actio
     int ctEdges=0;
     for (MeshCore::MeshFacetArray::_TConstIterator jt = rFaces.begin(); jt != rFaces.end(); ++jt) {
         for (int i=0; i<3; i++) {
-            if (jt->_aulNeighbours[i] == ULONG_MAX) {
+            if (jt->_aulNeighbours[i] == MeshCore::FACET_INDEX_MAX) {
                 ctEdges++;
             }
         }
@@ -17,6 +17,7 @@
 #include <Inventor/elements/SoReplacedElement.h>
 #include "Mod/Mesh/App/Core/Elements.h"
 #include "Mod/Mesh/App/Mesh.h"
+#include "SoFCIndexedFaceSet.h"
 
 typedef unsigned int GLuint;
 typedef int GLint;
@@ -139,6 +140,9 @@ protected:
  * The limit of maximum allowed triangles can be specified in \a renderTriangleLimit, the
  * default value is set to 100.000.
  *
+ * If vertex buffer objects are supported and not disabled in the viewer the triangles are
+ * uploaded once into buffer objects and rendered from there until the mesh changes.
+ *
  * The GLRender() method checks the status of the SoFCInteractiveElement to decide to be in
  * interactive mode or not.
  * To take advantage of this facility the client programmer must set the status of the
@@ -194,8 +198,10 @@ private:
     void stopSelection(SoAction * action, const Mesh::MeshObject*);
     void renderSelectionGeometry(const Mesh::MeshObject*);
 
-    void generateGLArrays(SoState * state);
+    void generateGLArrays(const Mesh::MeshObject*, std::vector<float>& vertex,
+                          std::vector<int32_t>& index) const;
     void renderFacesGLArray(SoGLRenderAction *action);
+    void renderFacesVBO(SoGLRenderAction *action, const Mesh::MeshObject*);
     void renderCoordsGLArray(SoGLRenderAction *action);
 
 private:
@@ -206,6 +212,9 @@ private:
     std::vector<int32_t> index_array;
     std::vector<float> vertex_array;
     SbBool updateGLArray;
+    // Vertex buffer handling
+    MeshRenderer render;
+    SbBool updateVBO;
 };
 
 class MeshGuiExport SoFCMeshSegmentShape : public SoShape {
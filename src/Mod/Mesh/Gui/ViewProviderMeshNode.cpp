@@ -344,7 +344,7 @@ void ViewProviderMeshNode::showOpenEdges(bool show)
     int ctEdges=0;
     for ( MeshCore::MeshFacetArray::_TConstIterator jt = rFaces.begin(); jt != rFaces.end(); ++jt ) {
       for ( int i=0; i<3; i++ ) {
-        if ( jt->_aulNeighbours[i] == ULONG_MAX ) {
+        if ( jt->_aulNeighbours[i] == MeshCore::FACET_INDEX_MAX ) {
           ctEdges++;
         }
       }
@@ -358,7 +358,7 @@ void ViewProviderMeshNode::showOpenEdges(bool show)
     lines->numVertices.setNum(ctEdges);
     for ( MeshCore::MeshFacetArray::_TConstIterator it = rFaces.begin(); it != rFaces.end(); ++it ) {
       for ( int i=0; i<3; i++ ) {
-        if ( it->_aulNeighbours[i] == ULONG_MAX ) {
+        if ( it->_aulNeighbours[i] == MeshCore::FACET_INDEX_MAX ) {
           const MeshCore::MeshPoint& cP0 = rPoint[it->_aulPoints[i]];
           const MeshCore::MeshPoint& cP1 = rPoint[it->_aulPoints[(i+1)%3]];
           points->point.set1Value(index++, cP0.x, cP0.y, cP0.z);
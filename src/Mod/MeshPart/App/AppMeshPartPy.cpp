@@ -51,7 +51,8 @@ public:
             "                         AngularDeflection=0.5,\n"
             "                         Relative=False,"
             "                         Segments=False,\n"
-            "                         GroupColors=[])\n"
+            "                         GroupColors=[],\n"
+            "                         Batch=False)\n"
             "    meshFromShape(Shape, MaxLength)\n"
             "    meshFromShape(Shape, MaxArea)\n"
             "    meshFromShape(Shape, LocalLength)\n"
@@ -64,6 +65,8 @@ public:
             "    AngularDeflection (optional, float)\n"
             "    Segments (optional, boolean)\n"
             "    GroupColors (optional, list of (Red, Green, Blue) tuples)\n"
+            "    Batch (optional, boolean) - tessellate the faces in parallel and keep\n"
+            "        existing triangulations that are fine enough\n"
             "    MaxLength (required, float)\n"
             "    MaxArea (required, float)\n"
             "    LocalLength (required, float)\n"
@@ -200,17 +203,19 @@ private:
         PyObject *shape;
 
         static char* kwds_lindeflection[] = {"Shape", "LinearDeflection", "AngularDeflection",
-                                             "Relative", "Segments", "GroupColors", NULL};
+                                             "Relative", "Segments", "GroupColors", "Batch", NULL};
         PyErr_Clear();
         double lindeflection=0;
         double angdeflection=0.5;
         PyObject* relative = Py_False;
         PyObject* segment = Py_False;
         PyObject* groupColors = 0;
-        if (PyArg_ParseTupleAndKeywords(args.ptr(), kwds.ptr(), "O!d|dO!O!O", kwds_lindeflection,
+        PyObject* batch = Py_False;
+        if (PyArg_ParseTupleAndKeywords(args.ptr(), kwds.ptr(), "O!d|dO!O!OO!", kwds_lindeflection,
                                         &(Part::TopoShapePy::Type), &shape, &lindeflection,
                                         &angdeflection, &(PyBool_Type), &relative,
-                                        &(PyBool_Type), &segment, &groupColors)) {
+                                        &(PyBool_Type), &segment, &groupColors,
+                                        &(PyBool_Type), &batch)) {
             MeshPart::Mesher mesher(static_cast<Part::TopoShapePy*>(shape)->getTopoShapePtr()->getShape());
             mesher.setMethod(MeshPart::Mesher::Standard);
             mesher.setDeflection(lindeflection);
@@ -218,6 +223,7 @@ private:
             mesher.setRegular(true);
             mesher.setRelative(PyObject_IsTrue(relative) ? true : false);
             mesher.setSegments(PyObject_IsTrue(segment) ? true : false);
+            mesher.setBatch(PyObject_IsTrue(batch) ? true : false);
             if (groupColors) {
                 Py::Sequence list(groupColors);
                 std::vector<uint32_t> colors;
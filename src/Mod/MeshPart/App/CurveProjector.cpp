@@ -98,7 +98,7 @@ void CurveProjectorShape::projectCurve( const TopoDS_Edge& aEdge,
                                               (float)gpPt.Z());
   Base::Vector3f cResultPoint, cSplitPoint, cPlanePnt, cPlaneNormal;
   unsigned long uStartFacetIdx,uCurFacetIdx;
-  unsigned long uLastFacetIdx=ULONG_MAX-1; // use another value as ULONG_MAX
+  unsigned long uLastFacetIdx=MeshCore::FACET_INDEX_MAX-1; // use another value as MeshCore::FACET_INDEX_MAX
   unsigned long auNeighboursIdx[3];
   bool GoOn;
   
@@ -124,7 +124,7 @@ void CurveProjectorShape::projectCurve( const TopoDS_Edge& aEdge,
       const Base::Vector3f& cP0 = cCurFacet._aclPoints[i];
       const Base::Vector3f& cP1 = cCurFacet._aclPoints[(i+1)%3];
 
-      if ( auNeighboursIdx[i] != ULONG_MAX )
+      if ( auNeighboursIdx[i] != MeshCore::FACET_INDEX_MAX )
       {
         // calculate the normal by the edge vector and the middle between the two face normals
         MeshGeomFacet N = _Mesh.GetFacet( auNeighboursIdx[i] );
@@ -352,7 +352,7 @@ void CurveProjectorSimple::projectCurve( const TopoDS_Edge& aEdge,
     MeshGeomFacet cCurFacet= MeshK.GetFacet(uCurFacetIdx);
     MeshK.GetFacetNeighbours ( uCurFacetIdx, auNeighboursIdx[0], auNeighboursIdx[1], auNeighboursIdx[2]);
     
-    uCurFacetIdx = ULONG_MAX;
+    uCurFacetIdx = MeshCore::FACET_INDEX_MAX;
     PointCount = 0;
 
     for(int i=0; i<3; i++)
@@ -370,7 +370,7 @@ void CurveProjectorSimple::projectCurve( const TopoDS_Edge& aEdge,
     }
 
 
-  }while(uCurFacetIdx != ULONG_MAX);
+  }while(uCurFacetIdx != MeshCore::FACET_INDEX_MAX);
 */
 }
 
@@ -391,7 +391,7 @@ void CurveProjectorSimple::projectCurve( const TopoDS_Edge& aEdge,
   Base::Vector3f cStartPoint = Base::Vector3f(gpPt.X(),gpPt.Y(),gpPt.Z());
   Base::Vector3f cResultPoint, cSplitPoint, cPlanePnt, cPlaneNormal,TempResultPoint;
   unsigned long uStartFacetIdx,uCurFacetIdx;
-  unsigned long uLastFacetIdx=ULONG_MAX-1; // use another value as ULONG_MAX
+  unsigned long uLastFacetIdx=MeshCore::FACET_INDEX_MAX-1; // use another value as MeshCore::FACET_INDEX_MAX
   unsigned long auNeighboursIdx[3];
   bool GoOn;
 
@@ -436,7 +436,7 @@ void CurveProjectorSimple::projectCurve( const TopoDS_Edge& aEdge,
       for(int i=0; i<3; i++)
       {
         // if the i'th neighbour is valid
-        if ( auNeighboursIdx[i] != ULONG_MAX )
+        if ( auNeighboursIdx[i] != MeshCore::FACET_INDEX_MAX )
         {
           // try to project next interval
           MeshGeomFacet N = MeshK.GetFacet( auNeighboursIdx[i] );
@@ -477,7 +477,7 @@ void CurveProjectorSimple::projectCurve( const TopoDS_Edge& aEdge,
   Base::Vector3f cStartPoint = Base::Vector3f(gpPt.X(),gpPt.Y(),gpPt.Z());
   Base::Vector3f cResultPoint, cSplitPoint, cPlanePnt, cPlaneNormal;
   unsigned long uStartFacetIdx,uCurFacetIdx;
-  unsigned long uLastFacetIdx=ULONG_MAX-1; // use another value as ULONG_MAX
+  unsigned long uLastFacetIdx=MeshCore::FACET_INDEX_MAX-1; // use another value as MeshCore::FACET_INDEX_MAX
   unsigned long auNeighboursIdx[3];
   bool GoOn;
   
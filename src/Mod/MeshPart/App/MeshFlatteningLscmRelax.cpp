@@ -18,6 +18,8 @@
 #include <tuple>
 #include <array>
 
+#include <QtConcurrentMap>
+
 #ifndef M_PI
 #define M_PI    3.14159265358979323846f
 #endif
@@ -127,68 +129,152 @@ LscmRelax::LscmRelax(
 //////////////////////////////////////////////////////////////////////////
 /////////////////                 F.E.M                      /////////////
 //////////////////////////////////////////////////////////////////////////
+bool LscmRelax::relax_pattern_valid()
+{
+    return this->relax_solver &&
+           this->relax_K_g.rows() == this->vertices.cols() * 2 + 3 &&
+           this->relax_triangles.cols() == this->triangles.cols() &&
+           this->relax_triangles == this->triangles;
+}
+
+void LscmRelax::init_relax_pattern()
+{
+    long n = this->vertices.cols();
+    long num_tris = this->triangles.cols();
+    // only the lower triangle is used by the solver
+    std::vector<trip> K_g_triplets;
+    K_g_triplets.reserve(num_tris * 21 + n * 4);
+    for (long i=0; i < num_tris; i++)
+    {
+        for (int a=0; a < 6; a++)
+        {
+            long row_pos = this->triangles(a / 2, i) * 2 + a % 2;
+            for (int b=0; b < 6; b++)
+            {
+                long col_pos = this->triangles(b / 2, i) * 2 + b % 2;
+                if (row_pos >= col_pos)
+                    K_g_triplets.push_back(trip(row_pos, col_pos, 0));
+            }
+        }
+    }
+    for (long i=0; i < n; i++)
+    {
+        K_g_triplets.push_back(trip(n * 2,     i * 2,     0));
+        K_g_triplets.push_back(trip(n * 2 + 1, i * 2 + 1, 0));
+        K_g_triplets.push_back(trip(n * 2 + 2, i * 2,     0));
+        K_g_triplets.push_back(trip(n * 2 + 2, i * 2 + 1, 0));
+    }
+    this->relax_K_g.resize(n * 2 + 3, n * 2 + 3);
+    this->relax_K_g.setFromTriplets(K_g_triplets.begin(), K_g_triplets.end());
+    this->relax_K_g.makeCompressed();
+
+    // position of an entry in the value array of relax_K_g
+    const spMat& K = this->relax_K_g;
+    auto value_index = [&K](long row, long col) -> long {
+        const int* inner = K.innerIndexPtr();
+        const int* begin = inner + K.outerIndexPtr()[col];
+        const int* end = inner + K.outerIndexPtr()[col + 1];
+        return std::lower_bound(begin, end, static_cast<int>(row)) - inner;
+    };
+
+    // element entry (a, b) is stored at b * 6 + a (column major)
+    this->relax_K_g_element_index.assign(num_tris * 36, -1);
+    for (long i=0; i < num_tris; i++)
+    {
+        for (int b=0; b < 6; b++)
+        {
+            long col_pos = this->triangles(b / 2, i) * 2 + b % 2;
+            for (int a=0; a < 6; a++)
+            {
+                long row_pos = this->triangles(a / 2, i) * 2 + a % 2;
+                if (row_pos >= col_pos)
+                    this->relax_K_g_element_index[i * 36 + b * 6 + a] = value_index(row_pos, col_pos);
+            }
+        }
+    }
+    this->relax_K_g_lagrange_index.resize(n * 4);
+    for (long i=0; i < n; i++)
+    {
+        this->relax_K_g_lagrange_index[i * 4]     = value_index(n * 2,     i * 2);
+        this->relax_K_g_lagrange_index[i * 4 + 1] = value_index(n * 2 + 1, i * 2 + 1);
+        this->relax_K_g_lagrange_index[i * 4 + 2] = value_index(n * 2 + 2, i * 2);
+        this->relax_K_g_lagrange_index[i * 4 + 3] = value_index(n * 2 + 2, i * 2 + 1);
+    }
+
+    this->relax_triangles = this->triangles;
+    this->relax_solver = std::make_shared<Eigen::SimplicialLDLT<spMat, Eigen::Lower>>();
+    this->relax_solver->analyzePattern(this->relax_K_g);
+}
+
 void LscmRelax::relax(double weight)
 {
     ColMat<double, 3> d_q_l_g = this->q_l_m - this->q_l_g;
-    // for every triangle
-    Eigen::Matrix<double, 3, 6> B;
-    Eigen::Matrix<double, 2, 2> T;
-    Eigen::Matrix<double, 6, 6> K_m;
-    Eigen::Matrix<double, 6, 1> u_m, rhs_m;
-    Eigen::VectorXd rhs(this->vertices.cols() * 2 + 3);
+    long n = this->vertices.cols();
+    long num_tris = this->triangles.cols();
+    Eigen::VectorXd rhs(n * 2 + 3);
     if (this->sol.size() == 0)
-        this->sol.Zero(this->vertices.cols() * 2 + 3);
-    spMat K_g(this->vertices.cols() * 2 + 3, this->vertices.cols() * 2 + 3);
-    std::vector<trip> K_g_triplets;
-    Vector2 v1, v2, v3, v12, v23, v31;
-    long row_pos, col_pos;
-    double A;
+        this->sol.Zero(n * 2 + 3);
+    if (!this->relax_pattern_valid())
+        this->init_relax_pattern();
+
+    // element matrices and element rhs, computed in parallel
+    Eigen::MatrixXd K_e(36, num_tris);
+    Eigen::MatrixXd rhs_e(6, num_tris);
+    std::vector<std::pair<long, long>> ranges;
+    for (long i=0; i < num_tris; i += 4096)
+        ranges.push_back(std::make_pair(i, std::min(i + 4096, num_tris)));
+
+    QtConcurrent::blockingMap(ranges, [&](const std::pair<long, long>& range) {
+        Eigen::Matrix<double, 3, 6> B;
+        Eigen::Matrix<double, 2, 2> T;
+        Eigen::Matrix<double, 6, 1> u_m;
+        Vector2 v1, v2, v3, v12, v23, v31;
+        double A;
+        for (long i=range.first; i < range.second; i++)
+        {
+            // 1: construct B-mat in m-system
+            v1 = this->flat_vertices.col(this->triangles(0, i));
+            v2 = this->flat_vertices.col(this->triangles(1, i));
+            v3 = this->flat_vertices.col(this->triangles(2, i));
+            v12 = v2 - v1;
+            v23 = v3 - v2;
+            v31 = v1 - v3;
+            B << -v23.y(),   0,        -v31.y(),   0,        -v12.y(),   0,
+                  0,         v23.x(),   0,         v31.x(),   0,         v12.x(),
+                 -v23.x(),   v23.y(),  -v31.x(),   v31.y(),  -v12.x(),   v12.y();
+            T << v12.x(), -v12.y(),
+                 v12.y(), v12.x();
+            T /= v12.norm();
+            A = std::abs(this->q_l_m(i, 0) * this->q_l_m(i, 2) / 2);
+            B /= A * 2; // (2*area)
+
+            // 2: sigma due dqlg in m-system
+            u_m << Vector2(0, 0), T * Vector2(d_q_l_g(i, 0), 0), T * Vector2(d_q_l_g(i, 1), d_q_l_g(i, 2));
+
+            // 3: rhs_m = B.T * C * B * dqlg_m
+            //    K_m = B.T * C * B
+            Eigen::Map<Eigen::Matrix<double, 6, 6>> K_m(K_e.col(i).data());
+            K_m = B.transpose() * this->C * B * A;
+            rhs_e.col(i) = K_m * u_m;
+        }
+    });
 
+    // 5: add to rhs_g, relax_K_g (sequentially to get the same sums on every run)
+    double* K_g_values = this->relax_K_g.valuePtr();
+    std::fill(K_g_values, K_g_values + this->relax_K_g.nonZeros(), 0.);
     rhs.setZero();
-
-    for (long i=0; i<this->triangles.cols(); i++)
+    for (long i=0; i < num_tris; i++)
     {
-        // 1: construct B-mat in m-system
-        v1 = this->flat_vertices.col(this->triangles(0, i));
-        v2 = this->flat_vertices.col(this->triangles(1, i));
-        v3 = this->flat_vertices.col(this->triangles(2, i));
-        v12 = v2 - v1;
-        v23 = v3 - v2;
-        v31 = v1 - v3;
-        B << -v23.y(),   0,        -v31.y(),   0,        -v12.y(),   0,
-              0,         v23.x(),   0,         v31.x(),   0,         v12.x(),
-             -v23.x(),   v23.y(),  -v31.x(),   v31.y(),  -v12.x(),   v12.y();
-        T << v12.x(), -v12.y(),
-             v12.y(), v12.x();
-        T /= v12.norm();
-        A = std::abs(this->q_l_m(i, 0) * this->q_l_m(i, 2) / 2);
-        B /= A * 2; // (2*area)
-
-        // 2: sigma due dqlg in m-system
-        u_m << Vector2(0, 0), T * Vector2(d_q_l_g(i, 0), 0), T * Vector2(d_q_l_g(i, 1), d_q_l_g(i, 2));
-
-        // 3: rhs_m = B.T * C * B * dqlg_m
-        //    K_m = B.T * C * B
-        rhs_m = B.transpose() * this->C * B * u_m * A;
-        K_m = B.transpose() * this->C * B * A;
-
-        // 5: add to rhs_g, K_g
-        for (int j=0; j < 3; j++)
+        for (int a=0; a < 6; a++)
+            rhs[this->triangles(a / 2, i) * 2 + a % 2] += rhs_e(a, i);
+        const long* index = &this->relax_K_g_element_index[i * 36];
+        for (int e=0; e < 36; e++)
         {
-            row_pos = this->triangles(j, i);
-            rhs[row_pos * 2]     += rhs_m[j * 2];
-            rhs[row_pos * 2 + 1] += rhs_m[j * 2 +1];
-            for (int k=0; k < 3; k++)
-            {
-                col_pos = this->triangles(k, i);
-                K_g_triplets.push_back(trip(row_pos * 2,     col_pos * 2,        K_m(j * 2,      k * 2)));
-                K_g_triplets.push_back(trip(row_pos * 2 + 1, col_pos * 2,        K_m(j * 2 + 1,  k * 2)));
-                K_g_triplets.push_back(trip(row_pos * 2 + 1, col_pos * 2 + 1,    K_m(j * 2 + 1,  k * 2 + 1)));
-                K_g_triplets.push_back(trip(row_pos * 2,     col_pos * 2 + 1,    K_m(j * 2,      k * 2 + 1)));
-                // we don't have to fill all because the matrix is symmetric.
-            }
+            if (index[e] >= 0)
+                K_g_values[index[e]] += K_e(e, i);
         }
     }
+
     // FIXING SOME PINS:
     // - if there are no pins (or only one pin) selected solve the system without the nullspace solution.
     // - if there are some pins selected, delete all columns, rows that refer to this pins
@@ -236,16 +322,12 @@ void LscmRelax::relax(double weight)
     for (long i=0; i < this->flat_vertices.cols() ; i++)
     {
         // fixing total ux
-        K_g_triplets.push_back(trip(i * 2, this->flat_vertices.cols() * 2, 1));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2, i * 2, 1));
+        K_g_values[this->relax_K_g_lagrange_index[i * 4]] = 1;
         // fixing total uy
-        K_g_triplets.push_back(trip(i * 2 + 1, this->flat_vertices.cols() * 2 + 1, 1));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2 + 1, i * 2 + 1, 1));
+        K_g_values[this->relax_K_g_lagrange_index[i * 4 + 1]] = 1;
         // fixing ux*y-uy*x
-        K_g_triplets.push_back(trip(i * 2, this->flat_vertices.cols() * 2 + 2, - this->flat_vertices(1, i)));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2 + 2, i * 2, - this->flat_vertices(1, i)));
-        K_g_triplets.push_back(trip(i * 2 + 1, this->flat_vertices.cols() * 2 + 2, this->flat_vertices(0, i)));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2 + 2, i * 2 + 1, this->flat_vertices(0, i)));
+        K_g_values[this->relax_K_g_lagrange_index[i * 4 + 2]] = - this->flat_vertices(1, i);
+        K_g_values[this->relax_K_g_lagrange_index[i * 4 + 3]] = this->flat_vertices(0, i);
     }
 
     // project out the nullspace solution:
@@ -264,13 +346,12 @@ void LscmRelax::relax(double weight)
     // rhs -= nullspace1.dot(rhs) * nullspace1;
     // rhs -= nullspace2.dot(rhs) * nullspace2;
 
-    K_g.setFromTriplets(K_g_triplets.begin(), K_g_triplets.end());
     // rhs +=  K_g * Eigen::VectorXd::Ones(K_g.rows());
     
     // solve linear system (privately store the value for guess in next step)
-    Eigen::SimplicialLDLT<spMat, Eigen::Lower> solver;
-    solver.compute(K_g);
-    this->sol = solver.solve(-rhs);
+    // only the numeric factorization is done, the symbolic one is reused
+    this->relax_solver->factorize(this->relax_K_g);
+    this->sol = this->relax_solver->solve(-rhs);
     this->set_shift(this->sol.head(this->vertices.cols() * 2) * weight);
     this->set_q_l_m();
 }
@@ -26,6 +26,7 @@
 
 #include <Eigen/Geometry>
 #include <Eigen/IterativeLinearSolvers>
+#include <Eigen/SparseCholesky>
 
 typedef Eigen::SparseMatrix<double> spMat;
 
@@ -73,6 +74,17 @@ private:
     std::vector<long> get_fem_fixed_pins();
     Eigen::MatrixXd get_nullspace();
 
+    // the stiffness matrix of relax() only changes its values from one call to the next,
+    // so the pattern, the positions of the element entries in it and the symbolic
+    // factorization are kept. (shared_ptr because the solver isn't copyable)
+    bool relax_pattern_valid();
+    void init_relax_pattern();
+    RowMat<long, 3> relax_triangles;
+    spMat relax_K_g;
+    std::vector<long> relax_K_g_element_index;   // 36 per triangle, -1 for the upper triangle
+    std::vector<long> relax_K_g_lagrange_index;  // 4 per vertex
+    std::shared_ptr<Eigen::SimplicialLDLT<spMat, Eigen::Lower>> relax_solver;
+
 public:
     LscmRelax() {}
     LscmRelax(
@@ -4,16 +4,26 @@
  ***************************************************************************/
 
 #include <algorithm>
+#include <cstring>
 #include "Mesher.h"
 
 #include "Base/Console.h"
 #include "Base/Exception.h"
 #include "Base/Tools.h"
 #include "Mod/Mesh/App/Mesh.h"
+#include "Mod/Mesh/App/Core/Builder.h"
 #include "Mod/Part/App/TopoShape.h"
 
+#include <QtConcurrentMap>
+
+#include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
 #include <TopoDS_Shape.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopLoc_Location.hxx>
+#include <BRep_Tool.hxx>
 #include <BRepTools.hxx>
+#include <Poly_Triangulation.hxx>
 #include <BRepMesh_IncrementalMesh.hxx>
 #include <Standard_Version.hxx>
 
@@ -138,6 +148,7 @@ Mesher::Mesher(const TopoDS_Shape& s)
   , relative(false)
   , regular(false)
   , segments(false)
+  , batch(false)
 {
 }
 
@@ -148,7 +159,10 @@ Mesher::~Mesher()
 Mesh::MeshObject* Mesher::createMesh() const
 {
     // OCC standard mesher
-    if (method == Standard) {
+    if (method == Standard && batch) {
+        return createBatchMesh();
+    }
+    else if (method == Standard) {
         if (!shape.IsNull()) {
             BRepTools::Clean(shape);
             BRepMesh_IncrementalMesh aMesh(shape, deflection, relative, angularDeflection);
@@ -157,11 +171,6 @@ Mesh::MeshObject* Mesher::createMesh() const
         std::vector<Part::TopoShape::Domain> domains;
         Part::TopoShape(shape).getDomains(domains);
 
-        std::map<uint32_t, std::vector<std::size_t> > colorMap;
-        for (std::size_t i=0; i<colors.size(); i++) {
-            colorMap[colors[i]].push_back(i);
-        }
-
         bool createSegm = (colors.size() == domains.size());
 
         MeshCore::MeshFacetArray faces;
@@ -262,25 +271,7 @@ Mesh::MeshObject* Mesher::createMesh() const
 
         Mesh::MeshObject* meshdata = new Mesh::MeshObject();
         meshdata->swap(kernel);
-        if (createSegm) {
-            int index = 0;
-            for (auto it : colorMap) {
-                Mesh::Segment segm(meshdata, false);
-                for (auto jt : it.second) {
-                    segm.addIndices(meshSegments[jt]);
-                }
-                segm.save(true);
-                std::stringstream str;
-                str << "patch" << index++;
-                segm.setName(str.str());
-                meshdata->addSegment(segm);
-            }
-        }
-        else {
-            for (auto it : meshSegments) {
-                meshdata->addSegment(it);
-            }
-        }
+        addSegments(meshdata, meshSegments);
         return meshdata;
     }
 
@@ -526,3 +517,134 @@ Mesh::MeshObject* Mesher::createMesh() const
 #endif // HAVE_SMESH
 }
 
+void Mesher::addSegments(Mesh::MeshObject* meshdata,
+                         const std::vector< std::vector<unsigned long> >& meshSegments) const
+{
+    // group the faces by color if there is a color for each face
+    if (!meshSegments.empty() && colors.size() == meshSegments.size()) {
+        std::map<uint32_t, std::vector<std::size_t> > colorMap;
+        for (std::size_t i=0; i<colors.size(); i++) {
+            colorMap[colors[i]].push_back(i);
+        }
+
+        int index = 0;
+        for (auto it : colorMap) {
+            Mesh::Segment segm(meshdata, false);
+            for (auto jt : it.second) {
+                segm.addIndices(meshSegments[jt]);
+            }
+            segm.save(true);
+            std::stringstream str;
+            str << "patch" << index++;
+            segm.setName(str.str());
+            meshdata->addSegment(segm);
+        }
+    }
+    else {
+        for (auto it : meshSegments) {
+            meshdata->addSegment(it);
+        }
+    }
+}
+
+Mesh::MeshObject* Mesher::createBatchMesh() const
+{
+    // The faces are tessellated in parallel by OCC. Without cleaning the shape
+    // first an existing triangulation is only replaced if it's too coarse.
+    if (!shape.IsNull()) {
+        BRepMesh_IncrementalMesh aMesh(shape, deflection, relative, angularDeflection, Standard_True);
+    }
+
+    // the same faces in the same order as TopoShape::getDomains() uses
+    std::vector<TopoDS_Face> faces;
+    std::vector<std::size_t> offsets;
+    std::size_t numTriangles = 0;
+    for (TopExp_Explorer xp(shape, TopAbs_FACE); xp.More(); xp.Next()) {
+        TopoDS_Face face = TopoDS::Face(xp.Current());
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(face, loc);
+        if (triangulation.IsNull())
+            continue;
+        faces.push_back(face);
+        offsets.push_back(numTriangles);
+        numTriangles += triangulation->NbTriangles();
+    }
+
+    // Each face writes its triangles into its own part of one block. Triangles that
+    // degenerate when converting to float are skipped, so the number of written
+    // triangles may be less than the reserved space.
+    std::vector<float> triangles(9 * numTriangles);
+    std::vector<std::size_t> counts(faces.size(), 0);
+    std::vector<std::size_t> indices(faces.size());
+    for (std::size_t i = 0; i < indices.size(); i++)
+        indices[i] = i;
+
+    QtConcurrent::blockingMap(indices, [&](std::size_t index) {
+        const TopoDS_Face& face = faces[index];
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(face, loc);
+        const TColgp_Array1OfPnt& nodes = triangulation->Nodes();
+        const Poly_Array1OfTriangle& trias = triangulation->Triangles();
+        const gp_Trsf& trsf = loc.Transformation();
+        bool identity = loc.IsIdentity();
+        bool flip = (face.Orientation() == TopAbs_REVERSED);
+
+        float* out = triangles.data() + 9 * offsets[index];
+        std::size_t count = 0;
+        for (int i = trias.Lower(); i <= trias.Upper(); i++) {
+            Standard_Integer n[3];
+            trias(i).Get(n[0], n[1], n[2]);
+            if (flip)
+                std::swap(n[0], n[1]);
+
+            Base::Vector3f v[3];
+            for (int j = 0; j < 3; j++) {
+                gp_Pnt p = nodes(n[j]);
+                if (!identity)
+                    p.Transform(trsf);
+                v[j].Set(static_cast<float>(p.X()), static_cast<float>(p.Y()), static_cast<float>(p.Z()));
+            }
+
+            if (v[0] == v[1] || v[1] == v[2] || v[2] == v[0])
+                continue;
+            for (int j = 0; j < 3; j++) {
+                *out++ = v[j].x;
+                *out++ = v[j].y;
+                *out++ = v[j].z;
+            }
+            count++;
+        }
+        counts[index] = count;
+    });
+
+    // close the gaps of skipped triangles
+    std::vector< std::vector<unsigned long> > meshSegments;
+    std::size_t numFacets = 0;
+    for (std::size_t i = 0; i < faces.size(); i++) {
+        if (numFacets != offsets[i] && counts[i] > 0) {
+            std::memmove(triangles.data() + 9 * numFacets, triangles.data() + 9 * offsets[i],
+                         9 * counts[i] * sizeof(float));
+        }
+
+        if (this->segments || colors.size() == faces.size()) {
+            std::vector<unsigned long> segment(counts[i]);
+            std::generate(segment.begin(), segment.end(), Base::iotaGen<unsigned long>(numFacets));
+            meshSegments.push_back(segment);
+        }
+        numFacets += counts[i];
+    }
+
+    MeshCore::MeshKernel kernel;
+    MeshCore::MeshFastBuilder builder(kernel);
+    builder.Initialize(numFacets);
+    if (numFacets > 0) {
+        builder.AddFacets(reinterpret_cast<const char*>(triangles.data()), numFacets, 9 * sizeof(float));
+    }
+    std::vector<float>().swap(triangles);
+    builder.Finish();
+
+    Mesh::MeshObject* meshdata = new Mesh::MeshObject();
+    meshdata->swap(kernel);
+    addSegments(meshdata, meshSegments);
+    return meshdata;
+}
@@ -75,10 +75,22 @@ public:
     { return segments; }
     void setColors(const std::vector<uint32_t>& c)
     { colors = c; }
+    /** With the Standard method the faces are tessellated in parallel and their
+     * triangles are copied in parallel into a MeshFastBuilder. An existing
+     * triangulation of a face is kept if it is fine enough.
+     */
+    void setBatch(bool s)
+    { batch = s; }
+    bool isBatch() const
+    { return batch; }
     //@}
 
     Mesh::MeshObject* createMesh() const;
 
+private:
+    Mesh::MeshObject* createBatchMesh() const;
+    void addSegments(Mesh::MeshObject*, const std::vector< std::vector<unsigned long> >&) const;
+
 private:
     const TopoDS_Shape& shape;
     Method method;
@@ -91,6 +103,7 @@ private:
     bool relative;
     bool regular;
     bool segments;
+    bool batch;
     std::vector<uint32_t> colors;
     struct Vertex;
 
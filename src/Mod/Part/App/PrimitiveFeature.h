@@ -28,6 +28,11 @@ public:
     /// recalculate the feature
     App::DocumentObjectExecReturn *execute(void);
     short mustExecute() const;
+    /** A primitive builds its shape from its own properties. The attachment
+     * reads the shapes and placements of the Support objects, which is safe
+     * because linked objects are always recomputed in an earlier stage.
+     */
+    bool canRecomputeInParallel() const { return true; }
     PyObject* getPyObject();
     //@}
 
@@ -14,7 +14,6 @@
 # include <Bnd_Box.hxx>
 # include <BRepTools.hxx>
 # include <BRepTools_ShapeSet.hxx>
-# include <BRepBuilderAPI_Copy.hxx>
 # include <TopTools_HSequenceOfShape.hxx>
 # include <TopTools_MapOfShape.hxx>
 # include <TopoDS.hxx>
@@ -183,12 +182,10 @@ void PropertyPartShape::setPyObject(PyObject *value)
 
 App::Property *PropertyPartShape::Copy(void) const
 {
+    // Note: The copy references the same shape. The topology and geometry of a shape
+    // are not modified in place, changing the shape of this property assigns a new one.
     PropertyPartShape *prop = new PropertyPartShape();
     prop->_Shape = this->_Shape;
-    if (!_Shape.getShape().IsNull()) {
-        BRepBuilderAPI_Copy copy(_Shape.getShape());
-        prop->_Shape.setShape(copy.Shape());
-    }
 
     return prop;
 }
@@ -417,6 +414,40 @@ void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
     }
 }
 
+bool PropertyPartShape::readDocFile(Base::Reader &reader)
+{
+    // The detour over a temporary file is left to RestoreDocFile()
+    static Base::CachedParameter<bool> direct(App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part/General"), "DirectAccess", true);
+
+    Base::FileInfo brep(reader.getFileName());
+    if (brep.hasExtension(".bin")) {
+        _restoredShape.importBinary(reader);
+    }
+    else if (direct.getValue()) {
+        BRep_Builder builder;
+        TopoDS_Shape shape;
+        BRepTools::Read(shape, reader, builder);
+        _restoredShape.setShape(shape);
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+void PropertyPartShape::applyDocFile()
+{
+    setValue(_restoredShape);
+    _restoredShape = TopoShape();
+}
+
+void PropertyPartShape::discardDocFile()
+{
+    _restoredShape = TopoShape();
+}
+
 // -------------------------------------------------------------------------
 
 TYPESYSTEM_SOURCE(Part::PropertyShapeHistory , App::PropertyLists);
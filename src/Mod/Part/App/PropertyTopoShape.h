@@ -66,6 +66,9 @@ public:
 
     void SaveDocFile (Base::Writer &writer) const;
     void RestoreDocFile(Base::Reader &reader);
+    bool readDocFile(Base::Reader &reader);
+    void applyDocFile();
+    void discardDocFile();
 
     App::Property *Copy(void) const;
     void Paste(const App::Property &from);
@@ -77,6 +80,8 @@ public:
 
 private:
     TopoShape _Shape;
+    // The shape read by readDocFile() until applyDocFile() takes it over
+    TopoShape _restoredShape;
 };
 
 struct Standard_EXPORT ShapeHistory {
@@ -25,6 +25,7 @@ using namespace Path;
 TYPESYSTEM_SOURCE(Path::PropertyPath, App::Property);
 
 PropertyPath::PropertyPath()
+  : _Path(std::make_shared<Toolpath>())
 {
 }
 
@@ -35,19 +36,22 @@ PropertyPath::~PropertyPath()
 void PropertyPath::setValue(const Toolpath& pa)
 {
     aboutToSetValue();
-    _Path = pa;
+    if (_Path.use_count() > 1)
+        _Path = std::make_shared<Toolpath>(pa);
+    else
+        *_Path = pa;
     hasSetValue();
 }
 
 
 const Toolpath &PropertyPath::getValue(void)const 
 {
-    return _Path;
+    return *_Path;
 }
 
 PyObject *PropertyPath::getPyObject(void)
 {
-    return new PathPy(new Toolpath(_Path));
+    return new PathPy(new Toolpath(*_Path));
 }
 
 void PropertyPath::setPyObject(PyObject *value)
@@ -78,14 +82,20 @@ void PropertyPath::Paste(const App::Property &from)
     hasSetValue();
 }
 
+void PropertyPath::detach()
+{
+    if (_Path.use_count() > 1)
+        _Path = std::make_shared<Toolpath>(*_Path);
+}
+
 unsigned int PropertyPath::getMemSize (void) const
 {
-    return _Path.getMemSize();
+    return _Path->getMemSize();
 }
 
 void PropertyPath::Save (Base::Writer &writer) const
 {
-    _Path.Save(writer);
+    _Path->Save(writer);
 }
 
 void PropertyPath::Restore(Base::XMLReader &reader)
@@ -106,7 +116,8 @@ void PropertyPath::Restore(Base::XMLReader &reader)
             double y = reader.getAttributeAsFloat("y");
             double z = reader.getAttributeAsFloat("z");
             Base::Vector3d center(x, y, z);
-            _Path.setCenter(center);
+            detach();
+            _Path->setCenter(center);
         }
     }
 }
@@ -129,7 +140,8 @@ void PropertyPath::RestoreDocFile(Base::Reader &reader)
     }
 
     aboutToSetValue();
-    _Path.RestoreDocFile(reader);
+    detach();
+    _Path->RestoreDocFile(reader);
     hasSetValue();
 
     if (obj) {
@@ -137,5 +149,45 @@ void PropertyPath::RestoreDocFile(Base::Reader &reader)
     }
 }
 
+bool PropertyPath::readDocFile(Base::Reader &reader)
+{
+    // parsing the G-code doesn't touch anything else, so it can be done in a worker thread
+    _restoredPath = std::make_shared<Toolpath>();
+    _restoredPath->RestoreDocFile(reader);
+    return true;
+}
+
+void PropertyPath::applyDocFile()
+{
+    if (!_restoredPath)
+        return;
+
+    App::PropertyContainer *container = getContainer();
+    App::DocumentObject *obj = 0;
+    if (container->isDerivedFrom(App::DocumentObject::getClassTypeId())) {
+        obj = static_cast<App::DocumentObject*>(container);
+    }
+
+    if (obj) {
+        obj->setStatus(App::ObjectStatus::Restore, true);
+    }
+
+    aboutToSetValue();
+    // the center has already been restored from the XML data
+    _restoredPath->setCenter(_Path->getCenter());
+    _Path = _restoredPath;
+    _restoredPath.reset();
+    hasSetValue();
+
+    if (obj) {
+        obj->setStatus(App::ObjectStatus::Restore, false);
+    }
+}
+
+void PropertyPath::discardDocFile()
+{
+    _restoredPath.reset();
+}
+
 
 
@@ -8,6 +8,7 @@
 #define PROPERTYPATH_H
 
 #include "stdexport.h"
+#include <memory>
 #include "Path.h"
 #include "App/Property.h"
 
@@ -44,6 +45,9 @@ public:
     void Restore(Base::XMLReader &reader);
     void SaveDocFile (Base::Writer &writer) const;
     void RestoreDocFile(Base::Reader &reader);
+    bool readDocFile(Base::Reader &reader);
+    void applyDocFile();
+    void discardDocFile();
 
     App::Property *Copy(void) const;
     void Paste(const App::Property &from);
@@ -51,7 +55,15 @@ public:
     //@}
 
 private:
-    Toolpath _Path;
+    /// Gives the property its own tool path if it is shared with a copy of the property
+    void detach();
+
+private:
+    // The tool path is shared with the copies made for undo/redo and only copied
+    // when it gets modified while still being shared
+    std::shared_ptr<Toolpath> _Path;
+    // The tool path parsed by readDocFile() until applyDocFile() takes it over
+    std::shared_ptr<Toolpath> _restoredPath;
 };
 
 
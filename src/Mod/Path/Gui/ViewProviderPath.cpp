@@ -54,6 +54,41 @@ using namespace PathGui;
 using namespace Path;
 using namespace PartGui;
 
+namespace {
+
+// The parameters that are read whenever the path is drawn again
+struct PathParameters
+{
+    PathParameters()
+      : meshDeviation(App::GetApplication().GetParameterGroupByPath
+                      ("User parameter:BaseApp/Preferences/Mod/Part"), "MeshDeviation", 0.2)
+      , rapidPathColor(pathGroup(), "DefaultRapidPathColor", 2852126975UL) // dark red (170,0,0)
+      , probePathColor(pathGroup(), "DefaultProbePathColor", 4293591295UL) // yellow (255,255,5)
+      , bboxNormalColor(pathGroup(), "DefaultBBoxNormalColor", 4294967295UL) // white (255,255,255)
+      , bboxSelectionColor(pathGroup(), "DefaultBBoxSelectionColor", 0xc8ffff00UL) // rgb(0,85,255)
+    {
+    }
+
+    static ParameterGrp::handle pathGroup()
+    {
+        return App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Path");
+    }
+
+    CachedParameter<double> meshDeviation;
+    CachedParameter<unsigned long> rapidPathColor;
+    CachedParameter<unsigned long> probePathColor;
+    CachedParameter<unsigned long> bboxNormalColor;
+    CachedParameter<unsigned long> bboxSelectionColor;
+};
+
+const PathParameters& pathParameters()
+{
+    static PathParameters params;
+    return params;
+}
+
+}
+
 PROPERTY_SOURCE(PathGui::ViewProviderPath, Gui::ViewProviderGeometryObject)
 
 ViewProviderPath::ViewProviderPath()
@@ -285,12 +320,11 @@ void ViewProviderPath::onChanged(const App::Property* prop)
     } else if (prop == &NormalColor) {
         if (colorindex.size() > 0 && coordStart>=0 && coordStart<(int)colorindex.size()) {
             const App::Color& c = NormalColor.getValue();
-            ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Path");
-            unsigned long rcol = hGrp->GetUnsigned("DefaultRapidPathColor",2852126975UL); // dark red (170,0,0)
+            unsigned long rcol = pathParameters().rapidPathColor.getValue();
             float rr,rg,rb;
             rr = ((rcol >> 24) & 0xff) / 255.0; rg = ((rcol >> 16) & 0xff) / 255.0; rb = ((rcol >> 8) & 0xff) / 255.0;
 
-            unsigned long pcol = hGrp->GetUnsigned("DefaultProbePathColor",4293591295UL); // yellow (255,255,5)
+            unsigned long pcol = pathParameters().probePathColor.getValue();
             float pr,pg,pb;
             pr = ((pcol >> 24) & 0xff) / 255.0; pg = ((pcol >> 16) & 0xff) / 255.0; pb = ((pcol >> 8) & 0xff) / 255.0;
 
@@ -347,11 +381,10 @@ void ViewProviderPath::showBoundingBox(bool show) {
 }
 
 unsigned long ViewProviderPath::getBoundColor() const {
-    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Path");
     if(SelectionStyle.getValue() == 0 || !Selectable.getValue())
-        return hGrp->GetUnsigned("DefaultBBoxNormalColor",4294967295UL); // white (255,255,255)
+        return pathParameters().bboxNormalColor.getValue();
     else
-        return hGrp->GetUnsigned("DefaultBBoxSelectionColor",0xc8ffff00UL); // rgb(0,85,255)
+        return pathParameters().bboxSelectionColor.getValue();
 }
 
 void ViewProviderPath::updateShowConstraints() {
@@ -432,8 +465,7 @@ void ViewProviderPath::updateVisual(bool rebuild) {
             return;
         }
 
-        ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Part");
-        float deviation = hGrp->GetFloat("MeshDeviation",0.2);
+        float deviation = pathParameters().meshDeviation.getValue();
         std::deque<Base::Vector3d> points;
         std::deque<Base::Vector3d> markers;
 
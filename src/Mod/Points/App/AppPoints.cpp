@@ -9,6 +9,7 @@
 #include "Base/Console.h"
 #include "Base/Interpreter.h"
 
+#include "OctreeFeature.h"
 #include "Points.h"
 #include "PointsPy.h"
 #include "Properties.h"
@@ -41,5 +42,6 @@ PyMOD_INIT_FUNC(Points)
     Points::FeatureCustom         ::init();
     Points::StructuredCustom      ::init();
     Points::FeaturePython         ::init();
+    Points::OctreeFeature         ::init();
     PyMOD_Return(pointsModule);
 }
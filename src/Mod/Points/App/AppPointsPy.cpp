@@ -41,6 +41,10 @@ public:
         add_varargs_method("show",&Module::show,
             "show(points,[string]) -- Add the points to the active document or create one if no document exists."
         );
+        add_varargs_method("buildOctree",&Module::buildOctree,
+            "buildOctree(string,string,[int]) -- Convert the points of an ASCII file into an octree file with\n"
+            "the given maximum number of points per node. Use a Points::OctreeFeature to show the octree file."
+        );
         initialize("This module is the Points module."); // register with Python
     }
 
@@ -372,6 +376,32 @@ private:
 
         return Py::None();
     }
+
+    Py::Object buildOctree(const Py::Tuple& args)
+    {
+        char* Name;
+        char* OctreeName;
+        int nodeSize = 50000;
+        if (!PyArg_ParseTuple(args.ptr(), "etet|i","utf-8",&Name,"utf-8",&OctreeName,&nodeSize))
+            throw Py::Exception();
+        std::string EncodedName = std::string(Name);
+        PyMem_Free(Name);
+        std::string EncodedOctreeName = std::string(OctreeName);
+        PyMem_Free(OctreeName);
+
+        if (nodeSize < 1)
+            throw Py::ValueError("Node size must be positive");
+
+        try {
+            PointsAlgos::BuildOctree(EncodedName.c_str(), EncodedOctreeName.c_str(),
+                                     static_cast<unsigned long>(nodeSize));
+        }
+        catch (const Base::Exception& e) {
+            throw Py::RuntimeError(e.what());
+        }
+
+        return Py::None();
+    }
 };
 
 PyObject* initModule()
@@ -0,0 +1,89 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *   FreeCAD LICENSE IS LGPL3 WITHOUT ANY WARRANTY                         *
+ ***************************************************************************/
+
+
+
+
+#include <vector>
+
+#include "Base/Exception.h"
+
+
+#include "OctreeFeature.h"
+
+using namespace Points;
+
+
+//===========================================================================
+// OctreeFeature
+//===========================================================================
+/*
+import Points
+Points.buildOctree("scan.asc", "scan.oct")
+doc=App.ActiveDocument
+oct=doc.addObject('Points::OctreeFeature','Scan')
+oct.File="scan.oct"
+doc.recompute()
+*/
+
+// ---------------------------------------------------------
+
+PROPERTY_SOURCE(Points::OctreeFeature, Points::Feature)
+
+OctreeFeature::OctreeFeature()
+{
+    ADD_PROPERTY_TYPE(File,(""),"Octree", App::Prop_None, "The octree file");
+    ADD_PROPERTY_TYPE(PointBudget,(1000000),"Octree", App::Prop_None, "Maximum number of points to show");
+}
+
+OctreeFeature::~OctreeFeature()
+{
+}
+
+const PointsOctree& OctreeFeature::getOctree() const
+{
+    if (!octree.isOpen() && File.getValue()[0] != '\0')
+        octree.open(File.getValue());
+    return octree;
+}
+
+short OctreeFeature::mustExecute() const
+{
+    if (File.isTouched() || PointBudget.isTouched())
+        return 1;
+    return Feature::mustExecute();
+}
+
+App::DocumentObjectExecReturn *OctreeFeature::execute(void)
+{
+    if (File.getValue()[0] == '\0')
+        return new App::DocumentObjectExecReturn("No octree file given");
+    if (PointBudget.getValue() < 0)
+        return new App::DocumentObjectExecReturn("Point budget must not be negative");
+
+    // the points of the upper levels give an overview of the whole cloud
+    const PointsOctree& tree = getOctree();
+    std::vector<unsigned long> nodes;
+    tree.selectNodes(static_cast<std::size_t>(PointBudget.getValue()), nodes);
+
+    std::vector<PointKernel::value_type> pts;
+    for (std::vector<unsigned long>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        PointsOctree::PointsPtr data = tree.getPoints(*it);
+        pts.insert(pts.end(), data->begin(), data->end());
+    }
+
+    PointKernel kernel;
+    kernel.swap(pts);
+    kernel.setTransform(this->Placement.getValue().toMatrix());
+    this->Points.setValue(kernel);
+    return App::DocumentObject::StdReturn;
+}
+
+void OctreeFeature::onChanged(const App::Property* prop)
+{
+    if (prop == &this->File)
+        octree.close();
+    Feature::onChanged(prop);
+}
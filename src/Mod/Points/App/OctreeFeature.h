@@ -0,0 +1,58 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *   FreeCAD LICENSE IS LGPL3 WITHOUT ANY WARRANTY                         *
+ ***************************************************************************/
+
+
+#ifndef POINTS_OCTREE_FEATURE_H
+#define POINTS_OCTREE_FEATURE_H
+
+#include "App/PropertyFile.h"
+#include "PointsFeature.h"
+#include "PointsOctree.h"
+
+
+namespace Points
+{
+
+/*! The OctreeFeature class shows a point cloud that is stored in an octree file,
+  see PointsOctree. The cloud is never loaded completely but the Points property
+  only holds a thinned out version of at most PointBudget points. The view provider
+  refines it depending on the camera.
+ */
+class Standard_EXPORT OctreeFeature : public Feature
+{
+    PROPERTY_HEADER(Points::OctreeFeature);
+
+public:
+    /// Constructor
+    OctreeFeature(void);
+    virtual ~OctreeFeature(void);
+
+    App::PropertyFile File; /**< The octree file. */
+    App::PropertyInteger PointBudget; /**< The maximum number of points to show. */
+
+    /** Returns the octree of the file. It is opened on first use. */
+    const PointsOctree& getOctree() const;
+
+    /** @name methods override Feature */
+    //@{
+    short mustExecute() const;
+    /// recalculate the Feature
+    virtual App::DocumentObjectExecReturn *execute(void);
+    /// returns the type name of the ViewProvider
+    virtual const char* getViewProviderName(void) const {
+        return "PointsGui::ViewProviderOctree";
+    }
+protected:
+    void onChanged(const App::Property* prop);
+    //@}
+
+private:
+    mutable PointsOctree octree;
+};
+
+} //namespace Points
+
+
+#endif
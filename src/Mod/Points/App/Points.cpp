@@ -10,6 +10,8 @@
 #include <boost/math/special_functions/fpclassify.hpp>
 #include <QtConcurrentMap>
 
+#include <App/Application.h>
+#include "Base/ColumnStream.h"
 #include "Base/Exception.h"
 #include "Base/Matrix.h"
 #include "Base/Persistence.h"
@@ -157,11 +159,25 @@ void PointKernel::SaveDocFile (Base::Writer &writer) const
 {
     Base::OutputStream str(writer.Stream());
     uint32_t uCt = (uint32_t)size();
+
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Document");
+    if (hGrp->GetBool("CompressMeshData", false)) {
+        float precision = static_cast<float>(hGrp->GetFloat("CompressMeshPrecision", 0.0));
+        // Write a header with a "magic number" and a version
+        str << (uint32_t)0xA0B0C0D0 << (uint32_t)0x020000 << uCt;
+        Base::ColumnWriter columns(writer.Stream());
+        if (uCt > 0) {
+            for (int k = 0; k < 3; k++)
+                columns.writeFloats(&_Points[0][k], _Points.size(), 3, precision);
+        }
+        return;
+    }
+
     str << uCt;
     // store the data without transforming it
-    for (std::vector<value_type>::const_iterator it = _Points.begin(); it != _Points.end(); ++it) {
-        str << it->x << it->y << it->z;
-    }
+    if (uCt > 0)
+        str.write(&_Points[0].x, 3 * _Points.size());
 }
 
 void PointKernel::Restore(Base::XMLReader &reader)
@@ -186,12 +202,27 @@ void PointKernel::RestoreDocFile(Base::Reader &reader)
     Base::InputStream str(reader);
     uint32_t uCt = 0;
     str >> uCt;
-    _Points.resize(uCt);
-    for (unsigned long i=0; i < uCt; i++) {
-        float x, y, z;
-        str >> x >> y >> z;
-        _Points[i].Set(x,y,z);
+
+    // the compressed format starts with a "magic number" and a version
+    if (uCt == 0xA0B0C0D0) {
+        uint32_t version = 0;
+        str >> version;
+        if (version != 0x020000)
+            throw Base::BadFormatError("Unsupported version of point data");
+        str >> uCt;
+        std::vector<value_type> points(uCt);
+        Base::ColumnReader columns(reader);
+        if (uCt > 0) {
+            for (int k = 0; k < 3; k++)
+                columns.readFloats(&points[0][k], points.size(), 3);
+        }
+        _Points.swap(points);
+        return;
     }
+
+    _Points.resize(uCt);
+    if (uCt > 0)
+        str.read(&_Points[0].x, 3 * _Points.size());
 }
 
 void PointKernel::save(const char* file) const
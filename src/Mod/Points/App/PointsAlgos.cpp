@@ -7,10 +7,19 @@
 #ifdef FC_OS_LINUX
 # include <unistd.h>
 #endif
+# include <algorithm>
+# include <cmath>
+# include <cstdlib>
+# include <cstring>
+# include <functional>
+# include <limits>
+# include <queue>
 # include <sstream>
 
 
 #include "PointsAlgos.h"
+#include "PointsKDTree.h"
+#include "PointsOctree.h"
 #include "Points.h"
 
 #include "Base/Exception.h"
@@ -19,14 +28,371 @@
 #include "Base/Sequencer.h"
 #include "Base/Stream.h"
 
+#include <QFile>
+#include <QString>
+#include <QtConcurrentMap>
+
+#include <Eigen/Eigenvalues>
+
 #include <boost/shared_ptr.hpp>
-#include <boost/regex.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
 
 using namespace Points;
 
+namespace Points {
+
+/**
+ * The AsciiTableParser class reads rows of numbers from text. The text is split
+ * into chunks at line breaks and the chunks are parsed in parallel. Lines that
+ * don't start with a number, e.g. comments or column titles, are skipped.
+ */
+class AsciiTableParser
+{
+public:
+    /** Each row provides \a numFields values. Rows with less than \a minFields
+     * numbers are skipped, missing values are set to 0 and additional numbers
+     * are ignored.
+     */
+    AsciiTableParser(std::size_t numFields, std::size_t minFields)
+        : numFields(numFields), minFields(std::max<std::size_t>(1, minFields))
+    {
+    }
+
+    /** Parses the complete lines in the range [begin, end). For each chunk of rows
+     * \a sink is called with the values and the number of rows in the order of the
+     * text. If \a sink returns false parsing stops and false is returned.
+     */
+    template <typename Sink>
+    bool parse(const char* begin, const char* end, Sink& sink) const
+    {
+        const std::size_t chunkSize = 1 << 20;
+        std::vector<Chunk> chunks;
+        while (begin < end) {
+            const char* next = end;
+            if (static_cast<std::size_t>(end - begin) > chunkSize) {
+                next = static_cast<const char*>(std::memchr(begin + chunkSize, '\n', end - begin - chunkSize));
+                next = next ? next + 1 : end;
+            }
+            Chunk chunk;
+            chunk.begin = begin;
+            chunk.end = next;
+            chunk.rows = 0;
+            chunks.push_back(chunk);
+            begin = next;
+        }
+
+        QtConcurrent::blockingMap(chunks, [this](Chunk& chunk) {
+            parseChunk(chunk);
+        });
+
+        for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+            if (it->rows > 0 && !sink(&it->values[0], it->rows))
+                return false;
+        }
+        return true;
+    }
+
+    /** Returns the values of the first \a maxRows lines of [begin, end) that start with a number. */
+    static std::vector<std::vector<double> > firstRows(const char* begin, const char* end, std::size_t maxRows)
+    {
+        std::vector<std::vector<double> > rows;
+        std::vector<double> values;
+        while (begin < end && rows.size() < maxRows) {
+            values.clear();
+            parseLine(begin, end, values, std::numeric_limits<std::size_t>::max());
+            if (!values.empty())
+                rows.push_back(values);
+        }
+        return rows;
+    }
+
+    /** Parses the number in [it, end) and returns the position after it or null. */
+    static const char* parseNumber(const char* it, const char* end, double& value)
+    {
+        static const double powers[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        const char* start = it;
+        bool negative = false;
+        if (it != end && (*it == '-' || *it == '+')) {
+            negative = (*it == '-');
+            ++it;
+        }
+
+        // up to 19 significant digits fit into the mantissa, further digits are dropped
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        bool anyDigit = false;
+        bool truncated = false;
+        for (; it != end && *it >= '0' && *it <= '9'; ++it) {
+            anyDigit = true;
+            if (digits < 19) {
+                mantissa = 10 * mantissa + (*it - '0');
+                if (mantissa > 0)
+                    digits++;
+            }
+            else {
+                exponent++;
+                truncated = truncated || *it != '0';
+            }
+        }
+        if (it != end && *it == '.') {
+            for (++it; it != end && *it >= '0' && *it <= '9'; ++it) {
+                anyDigit = true;
+                if (digits < 19) {
+                    mantissa = 10 * mantissa + (*it - '0');
+                    if (mantissa > 0)
+                        digits++;
+                    exponent--;
+                }
+                else {
+                    truncated = truncated || *it != '0';
+                }
+            }
+        }
+
+        if (!anyDigit) {
+            // special values like nan or inf
+            char buf[32];
+            std::size_t len = 0;
+            for (it = start; it != end && len < sizeof(buf) - 1 && !isSeparator(*it); ++it)
+                buf[len++] = *it;
+            buf[len] = '\0';
+            char* last = nullptr;
+            value = std::strtod(buf, &last);
+            if (len == 0 || last != buf + len)
+                return nullptr;
+            return it;
+        }
+
+        if (it != end && (*it == 'e' || *it == 'E')) {
+            const char* pos = it + 1;
+            bool negExp = false;
+            if (pos != end && (*pos == '-' || *pos == '+')) {
+                negExp = (*pos == '-');
+                ++pos;
+            }
+            if (pos != end && *pos >= '0' && *pos <= '9') {
+                int exp = 0;
+                for (; pos != end && *pos >= '0' && *pos <= '9'; ++pos) {
+                    if (exp < 10000)
+                        exp = 10 * exp + (*pos - '0');
+                }
+                exponent += negExp ? -exp : exp;
+                it = pos;
+            }
+        }
+
+        // If the mantissa and the power of ten are exact doubles the result is correctly
+        // rounded because only a single rounding happens. Other numbers are left to strtod.
+        const uint64_t maxExact = uint64_t(1) << 53;
+        if (truncated || mantissa > maxExact || exponent < -22 || exponent > 22) {
+            std::string text(start, it);
+            value = std::strtod(text.c_str(), nullptr);
+            return it;
+        }
+
+        double result = static_cast<double>(mantissa);
+        if (exponent >= 0)
+            result *= powers[exponent];
+        else
+            result /= powers[-exponent];
+
+        value = negative ? -result : result;
+        return it;
+    }
+
+private:
+    struct Chunk
+    {
+        const char* begin;
+        const char* end;
+        std::vector<double> values;
+        std::size_t rows;
+    };
+
+    static bool isSeparator(char c)
+    {
+        return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r' || c == '\n';
+    }
+
+    /** Parses the line at \a it, appends at most \a maxFields values to \a values and
+     * moves \a it to the beginning of the next line. Returns the number of values
+     * or 0 if the line doesn't start with a number.
+     */
+    static std::size_t parseLine(const char*& it, const char* end, std::vector<double>& values,
+                                 std::size_t maxFields)
+    {
+        std::size_t count = 0;
+        bool valid = true;
+        while (it != end) {
+            char c = *it;
+            if (c == '\n') {
+                ++it;
+                break;
+            }
+            if (isSeparator(c)) {
+                ++it;
+                continue;
+            }
+
+            double value;
+            const char* next = valid ? parseNumber(it, end, value) : nullptr;
+            if (next && (next == end || isSeparator(*next))) {
+                if (count < maxFields)
+                    values.push_back(value);
+                count++;
+                it = next;
+            }
+            else {
+                // a comment or text: skip the rest of the line
+                valid = false;
+                const char* eol = static_cast<const char*>(std::memchr(it, '\n', end - it));
+                it = eol ? eol : end;
+            }
+        }
+
+        return count;
+    }
+
+    void parseChunk(Chunk& chunk) const
+    {
+        const char* it = chunk.begin;
+        while (it < chunk.end) {
+            std::size_t size = chunk.values.size();
+            std::size_t count = parseLine(it, chunk.end, chunk.values, numFields);
+            if (count < minFields) {
+                chunk.values.resize(size);
+                continue;
+            }
+            chunk.values.resize(size + numFields, 0.0);
+            chunk.rows++;
+        }
+    }
+
+    std::size_t numFields;
+    std::size_t minFields;
+};
+
+/** Parses the text file \a filename with \a parser. The file is mapped into
+ * memory in windows of limited size. Returns false if the file cannot be mapped.
+ */
+template <typename Sink>
+bool parseMappedFile(const std::string& filename, const AsciiTableParser& parser, Sink& sink)
+{
+    QFile file(QString::fromUtf8(filename.c_str()));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const qint64 windowSize = 64 << 20;
+    qint64 fileSize = file.size();
+    qint64 numWindows = (fileSize + windowSize - 1) / windowSize;
+    Base::SequencerLauncher seq("Loading points...", static_cast<size_t>(numWindows));
+
+    qint64 pos = 0;
+    while (pos < fileSize) {
+        qint64 len = std::min(windowSize, fileSize - pos);
+        uchar* data = file.map(pos, len);
+        if (!data) {
+            // mapping is not supported, e.g. for some special files
+            if (pos == 0)
+                return false;
+            throw Base::FileException("Failed to map file", filename.c_str());
+        }
+
+        const char* begin = reinterpret_cast<const char*>(data);
+        const char* end = begin + len;
+        if (pos + len < fileSize) {
+            // only pass complete lines, the rest is part of the next window
+            const char* last = end;
+            while (last > begin && *(last - 1) != '\n')
+                --last;
+            if (last == begin) {
+                file.unmap(data);
+                throw Base::BadFormatError("Line is too long");
+            }
+            end = last;
+        }
+
+        bool more = parser.parse(begin, end, sink);
+        file.unmap(data);
+        pos += end - begin;
+        seq.next();
+        if (!more)
+            break;
+    }
+
+    return true;
+}
+
+/** Parses the remaining text of the stream \a in with \a parser. */
+template <typename Sink>
+void parseStream(std::istream& in, const AsciiTableParser& parser, Sink& sink)
+{
+    const std::size_t blockSize = 16 << 20;
+    std::vector<char> buffer;
+    std::size_t keep = 0;
+    while (true) {
+        buffer.resize(keep + blockSize);
+        in.read(&buffer[keep], blockSize);
+        std::size_t size = keep + static_cast<std::size_t>(in.gcount());
+        bool atEnd = !in;
+        if (size == 0)
+            break;
+
+        const char* begin = &buffer[0];
+        const char* end = begin + size;
+        if (!atEnd) {
+            // only pass complete lines, the rest is kept for the next block
+            const char* last = end;
+            while (last > begin && *(last - 1) != '\n')
+                --last;
+            if (last != begin)
+                end = last;
+        }
+
+        if (!parser.parse(begin, end, sink))
+            break;
+        keep = size - (end - begin);
+        if (atEnd)
+            break;
+        if (keep > 0)
+            std::memmove(&buffer[0], end, keep);
+    }
+}
+
+/** Copies the parsed rows into the rows of a matrix up to its size. */
+class AsciiMatrixSink
+{
+public:
+    AsciiMatrixSink(Eigen::MatrixXd& data) : data(data), row(0)
+    {
+    }
+    bool operator()(const double* values, std::size_t rows)
+    {
+        std::size_t numFields = data.cols();
+        std::size_t numRows = data.rows();
+        for (std::size_t i = 0; i < rows && row < numRows; i++, row++) {
+            for (std::size_t col = 0; col < numFields; col++)
+                data(row, col) = values[i * numFields + col];
+        }
+        return row < numRows;
+    }
+
+private:
+    Eigen::MatrixXd& data;
+    std::size_t row;
+};
+
+}
+
+// ----------------------------------------------------------------------------
+
 void PointsAlgos::Load(PointKernel &points, const char *FileName)
 {
     Base::FileInfo File(FileName);
@@ -43,57 +409,316 @@ void PointsAlgos::Load(PointKernel &points, const char *FileName)
 
 void PointsAlgos::LoadAscii(PointKernel &points, const char *FileName)
 {
-    boost::regex rx("^\\s*([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                     "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                     "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    //boost::regex rx("(\\b[0-9]+\\.([0-9]+\\b)?|\\.[0-9]+\\b)");
-    //boost::regex rx("^\\s*(-?[0-9]*)\\.([0-9]+)\\s+(-?[0-9]*)\\.([0-9]+)\\s+(-?[0-9]*)\\.([0-9]+)\\s*$");
-    boost::cmatch what;
+    // the first three numbers of each line are the coordinates
+    std::vector<PointKernel::value_type> pts;
+    auto sink = [&pts](const double* values, std::size_t rows) {
+        for (std::size_t i = 0; i < rows; i++, values += 3) {
+            pts.push_back(PointKernel::value_type(static_cast<float>(values[0]),
+                                                  static_cast<float>(values[1]),
+                                                  static_cast<float>(values[2])));
+        }
+        return true;
+    };
 
-    Base::Vector3d pt;
-    int LineCnt=0;
-    std::string line;
+    try {
+        AsciiTableParser parser(3, 3);
+        if (!parseMappedFile(FileName, parser, sink)) {
+            Base::FileInfo fi(FileName);
+            Base::ifstream file(fi, std::ios::in | std::ios::binary);
+            parseStream(file, parser, sink);
+        }
+    }
+    catch (const Base::Exception&) {
+        points.clear();
+        throw;
+    }
+    catch (...) {
+        points.clear();
+        throw Base::BadFormatError("Reading in points failed.");
+    }
+
+    points.swap(pts);
+}
+
+void PointsAlgos::BuildOctree(const char *FileName, const char *OctreeName, unsigned long nodeSize)
+{
     Base::FileInfo fi(FileName);
+    if (!fi.isReadable())
+        throw Base::FileException("File to load not existing or not readable", FileName);
 
-    Base::ifstream tmp_str(fi, std::ios::in);
+    // the first three numbers of each line are the coordinates
+    AsciiTableParser parser(3, 3);
+    auto parseFile = [&parser, &fi](std::function<bool(const double*, std::size_t)> sink) {
+        if (!parseMappedFile(fi.filePath(), parser, sink)) {
+            Base::ifstream file(fi, std::ios::in | std::ios::binary);
+            parseStream(file, parser, sink);
+        }
+    };
+
+    // the first pass determines the bounding box
+    Base::BoundBox3f box;
+    parseFile([&box](const double* values, std::size_t rows) {
+        for (std::size_t i = 0; i < rows; i++, values += 3) {
+            box.Add(Base::Vector3f(static_cast<float>(values[0]),
+                                   static_cast<float>(values[1]),
+                                   static_cast<float>(values[2])));
+        }
+        return true;
+    });
+
+    PointsOctreeBuilder builder(OctreeName, box, nodeSize);
+    std::vector<Base::Vector3f> pts;
+    parseFile([&builder, &pts](const double* values, std::size_t rows) {
+        pts.resize(rows);
+        for (std::size_t i = 0; i < rows; i++, values += 3) {
+            pts[i].Set(static_cast<float>(values[0]),
+                       static_cast<float>(values[1]),
+                       static_cast<float>(values[2]));
+        }
+        builder.addPoints(pts.empty() ? nullptr : &pts[0], rows);
+        return true;
+    });
+    builder.finish();
+}
 
-    // estimating size
-    while (std::getline(tmp_str,line))
-        LineCnt++;
+namespace {
 
-    // resize the PointKernel
-    points.resize(LineCnt);
+typedef std::pair<unsigned long, unsigned long> PointRange;
 
-    Base::SequencerLauncher seq( "Loading points...", LineCnt );
+// Splits the points into ranges of fixed size, so that the result doesn't depend on the number of threads
+std::vector<PointRange> pointRanges(unsigned long numPoints)
+{
+    const unsigned long rangeSize = 4096;
+    std::vector<PointRange> ranges;
+    for (unsigned long i = 0; i < numPoints; i += rangeSize)
+        ranges.push_back(std::make_pair(i, std::min(i + rangeSize, numPoints)));
+    return ranges;
+}
 
-    // again to the beginning
-    Base::ifstream file(fi, std::ios::in);
-    LineCnt = 0;
+// An edge of the neighbourhood graph weighted by the angle between the normals of its points
+struct NormalEdge
+{
+    float weight;
+    unsigned long from;
+    unsigned long to;
 
-    try {
-        // read file
-        while (std::getline(file, line)) {
-            if (boost::regex_match(line.c_str(), what, rx)) {
-                pt.x = std::atof(what[1].first);
-                pt.y = std::atof(what[4].first);
-                pt.z = std::atof(what[7].first);
-
-                points.setPoint(LineCnt,pt);
-                seq.next();
-                LineCnt++;
+    bool operator > (const NormalEdge& e) const
+    {
+        if (weight != e.weight)
+            return weight > e.weight;
+        if (to != e.to)
+            return to > e.to;
+        return from > e.from;
+    }
+};
+
+}
+
+void PointsAlgos::EstimateNormals(const std::vector<Base::Vector3f>& points, unsigned long k,
+                                  bool orient, std::vector<Base::Vector3f>& normals)
+{
+    unsigned long numPoints = points.size();
+    normals.assign(numPoints, Base::Vector3f(0.0f, 0.0f, 1.0f));
+    if (numPoints == 0)
+        return;
+    if (k < 3)
+        throw Base::ValueError("At least three neighbours are needed to estimate a normal");
+
+    // only the closest neighbours are used to propagate the orientation to limit the memory
+    const unsigned long numGraph = orient ? std::min<unsigned long>(k, 6) : 0;
+    if (orient && numPoints > std::numeric_limits<uint32_t>::max())
+        throw Base::ValueError("Too many points to orient the normals");
+    std::vector<uint32_t> graph(numPoints * numGraph);
+
+    PointsKDTree tree(points);
+    std::vector<PointRange> ranges = pointRanges(numPoints);
+    QtConcurrent::blockingMap(ranges, [&](const PointRange& range) {
+        std::vector<unsigned long> indices;
+        std::vector<float> distances;
+        for (unsigned long i = range.first; i < range.second; i++) {
+            tree.FindNearest(points[i], k, indices, distances);
+
+            Eigen::Vector3d mean(0.0, 0.0, 0.0);
+            for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it)
+                mean += Eigen::Vector3d(points[*it].x, points[*it].y, points[*it].z);
+            mean /= static_cast<double>(indices.size());
+
+            Eigen::Matrix3d cov = Eigen::Matrix3d::Zero();
+            for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
+                Eigen::Vector3d d = Eigen::Vector3d(points[*it].x, points[*it].y, points[*it].z) - mean;
+                cov += d * d.transpose();
+            }
+
+            // the eigenvalues are sorted in increasing order
+            if (indices.size() >= 3) {
+                Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(cov);
+                Eigen::Vector3d n = solver.eigenvectors().col(0);
+                normals[i].Set(static_cast<float>(n.x()), static_cast<float>(n.y()), static_cast<float>(n.z()));
+            }
+
+            // skip the point itself
+            uint32_t* edges = numGraph > 0 ? &graph[i * numGraph] : nullptr;
+            unsigned long numEdges = 0;
+            for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end() && numEdges < numGraph; ++it) {
+                if (*it != i)
+                    edges[numEdges++] = static_cast<uint32_t>(*it);
+            }
+            for (; numEdges < numGraph; numEdges++)
+                edges[numEdges] = static_cast<uint32_t>(i);
+        }
+    });
+
+    if (!orient)
+        return;
+
+    // Starting at the highest point not yet reached, whose normal is made to point
+    // upwards, the orientation is passed on along the edges between the most
+    // parallel normals first (Hoppe et al.).
+    std::vector<unsigned long> order(numPoints);
+    for (unsigned long i = 0; i < numPoints; i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&points](unsigned long a, unsigned long b) {
+        return points[a].z > points[b].z;
+    });
+
+    std::vector<char> visited(numPoints, 0);
+    std::priority_queue<NormalEdge, std::vector<NormalEdge>, std::greater<NormalEdge> > edges;
+    auto addEdges = [&](unsigned long from) {
+        for (unsigned long j = 0; j < numGraph; j++) {
+            unsigned long to = graph[from * numGraph + j];
+            if (!visited[to]) {
+                NormalEdge edge;
+                edge.weight = 1.0f - std::fabs(normals[from] * normals[to]);
+                edge.from = from;
+                edge.to = to;
+                edges.push(edge);
+            }
+        }
+    };
+
+    Base::SequencerLauncher seq("Orient normals...", numPoints);
+    for (std::vector<unsigned long>::iterator it = order.begin(); it != order.end(); ++it) {
+        if (visited[*it])
+            continue;
+
+        // The kNN graph isn't symmetric, so a point may not be reachable although its own
+        // neighbours are. Then its closest oriented neighbour is used as reference.
+        Base::Vector3f ref(0.0f, 0.0f, 1.0f);
+        for (unsigned long j = 0; j < numGraph; j++) {
+            unsigned long neighbour = graph[*it * numGraph + j];
+            if (visited[neighbour]) {
+                ref = normals[neighbour];
+                break;
             }
         }
+
+        visited[*it] = 1;
+        if (normals[*it] * ref < 0.0f)
+            normals[*it] = -normals[*it];
+        addEdges(*it);
+        seq.next();
+
+        while (!edges.empty()) {
+            NormalEdge edge = edges.top();
+            edges.pop();
+            if (visited[edge.to])
+                continue;
+
+            visited[edge.to] = 1;
+            if (normals[edge.from] * normals[edge.to] < 0.0f)
+                normals[edge.to] = -normals[edge.to];
+            addEdges(edge.to);
+            seq.next();
+        }
     }
-    catch (...) {
-        points.clear();
-        throw Base::BadFormatError("Reading in points failed.");
+}
+
+void PointsAlgos::FindOutliers(const std::vector<Base::Vector3f>& points, unsigned long k,
+                               double stddev, std::vector<unsigned long>& outliers)
+{
+    unsigned long numPoints = points.size();
+    if (numPoints == 0 || k == 0)
+        return;
+
+    // mean distance of each point to its neighbours without the point itself
+    std::vector<double> meanDist(numPoints, 0.0);
+    PointsKDTree tree(points);
+    std::vector<PointRange> ranges = pointRanges(numPoints);
+    QtConcurrent::blockingMap(ranges, [&](const PointRange& range) {
+        std::vector<unsigned long> indices;
+        std::vector<float> distances;
+        for (unsigned long i = range.first; i < range.second; i++) {
+            tree.FindNearest(points[i], k + 1, indices, distances);
+            double sum = 0.0;
+            unsigned long count = 0;
+            for (std::size_t j = 0; j < indices.size() && count < k; j++) {
+                if (indices[j] != i) {
+                    sum += std::sqrt(static_cast<double>(distances[j]));
+                    count++;
+                }
+            }
+            meanDist[i] = count > 0 ? sum / count : 0.0;
+        }
+    });
+
+    double mean = 0.0;
+    for (std::vector<double>::iterator it = meanDist.begin(); it != meanDist.end(); ++it)
+        mean += *it;
+    mean /= numPoints;
+
+    double variance = 0.0;
+    for (std::vector<double>::iterator it = meanDist.begin(); it != meanDist.end(); ++it)
+        variance += (*it - mean) * (*it - mean);
+    variance /= numPoints;
+
+    double limit = mean + stddev * std::sqrt(variance);
+    for (unsigned long i = 0; i < numPoints; i++) {
+        if (meanDist[i] > limit)
+            outliers.push_back(i);
     }
+}
 
-    // now remove the last points from the kernel
-    // Note: first we allocate memory corresponding to the number of lines (points and comments)
-    //       and read in the file twice. But then the size of the kernel is too high
-    if (LineCnt < (int)points.size())
-        points.erase(LineCnt, points.size());
+void PointsAlgos::Downsample(const std::vector<Base::Vector3f>& points, float size,
+                             std::vector<Base::Vector3f>& result)
+{
+    if (!(size > 0.0f))
+        throw Base::ValueError("Voxel size must be positive");
+    unsigned long numPoints = points.size();
+    if (numPoints == 0)
+        return;
+
+    Base::BoundBox3f box;
+    for (std::vector<Base::Vector3f>::const_iterator it = points.begin(); it != points.end(); ++it)
+        box.Add(*it);
+
+    // the cell index of each axis is stored in 21 bits of the key
+    const double maxCells = static_cast<double>(1 << 21);
+    if (box.LengthX() / size >= maxCells || box.LengthY() / size >= maxCells || box.LengthZ() / size >= maxCells)
+        throw Base::ValueError("Voxel size is too small for the extent of the points");
+
+    std::vector<std::pair<uint64_t, unsigned long> > keys(numPoints);
+    std::vector<PointRange> ranges = pointRanges(numPoints);
+    QtConcurrent::blockingMap(ranges, [&](const PointRange& range) {
+        for (unsigned long i = range.first; i < range.second; i++) {
+            uint64_t ix = static_cast<uint64_t>((points[i].x - box.MinX) / size);
+            uint64_t iy = static_cast<uint64_t>((points[i].y - box.MinY) / size);
+            uint64_t iz = static_cast<uint64_t>((points[i].z - box.MinZ) / size);
+            keys[i] = std::make_pair(ix | (iy << 21) | (iz << 42), i);
+        }
+    });
+    std::sort(keys.begin(), keys.end());
+
+    for (std::size_t i = 0; i < keys.size(); ) {
+        std::size_t j = i;
+        Base::Vector3d sum;
+        for (; j < keys.size() && keys[j].first == keys[i].first; j++) {
+            const Base::Vector3f& p = points[keys[j].second];
+            sum += Base::Vector3d(p.x, p.y, p.z);
+        }
+        sum /= static_cast<double>(j - i);
+        result.push_back(Base::Vector3f(static_cast<float>(sum.x), static_cast<float>(sum.y), static_cast<float>(sum.z)));
+        i = j;
+    }
 }
 
 // ----------------------------------------------------------------------------
@@ -172,7 +797,11 @@ int Reader::getHeight() const
 
 // ----------------------------------------------------------------------------
 
-AscReader::AscReader()
+AscReader::AscReader() : layout(Automatic)
+{
+}
+
+AscReader::AscReader(Layout layout) : layout(layout)
 {
 }
 
@@ -180,9 +809,135 @@ AscReader::~AscReader()
 {
 }
 
+void AscReader::setLayout(Layout l)
+{
+    layout = l;
+}
+
+AscReader::Layout AscReader::getLayout() const
+{
+    return layout;
+}
+
+AscReader::Layout AscReader::detectLayout(const std::string& filename) const
+{
+    // check the first lines with numbers
+    Base::FileInfo fi(filename);
+    Base::ifstream file(fi, std::ios::in | std::ios::binary);
+    std::vector<char> buffer(64 * 1024);
+    file.read(&buffer[0], buffer.size());
+    const char* begin = &buffer[0];
+    const char* end = begin + file.gcount();
+
+    std::vector<std::vector<double> > rows = AsciiTableParser::firstRows(begin, end, 100);
+    std::size_t numValues = rows.empty() ? 0 : rows.front().size();
+    switch (numValues) {
+    case 4:
+        return XYZI;
+    case 6:
+        {
+            // Colors are in the range [0,1] or [0,255], so the values are taken as normals
+            // only if all vectors have unit length and some of them can't be colors. Colors
+            // like (1,0,0) are unit vectors, too.
+            bool unitLength = true, negative = false, tooLarge = false;
+            for (std::vector<std::vector<double> >::iterator it = rows.begin(); it != rows.end(); ++it) {
+                if (it->size() != numValues)
+                    continue;
+                const std::vector<double>& values = *it;
+                double len = values[3] * values[3] + values[4] * values[4] + values[5] * values[5];
+                if (std::fabs(len - 1.0) >= 1.0e-3)
+                    unitLength = false;
+                for (int i = 3; i < 6; i++) {
+                    if (values[i] < 0.0)
+                        negative = true;
+                    else if (values[i] > 255.0)
+                        tooLarge = true;
+                }
+            }
+            return (unitLength && (negative || tooLarge)) ? XYZNormal : XYZRGB;
+        }
+    case 7:
+        return XYZIRGB;
+    default:
+        return XYZ;
+    }
+}
+
 void AscReader::read(const std::string& filename)
 {
-    points.load(filename.c_str());
+    clear();
+    this->width = 0;
+    this->height = 0;
+
+    Layout columns = layout;
+    if (columns == Automatic)
+        columns = detectLayout(filename);
+
+    // column indices of the values, -1 if not available
+    int intensityCol = -1, colorCol = -1, normalCol = -1;
+    std::size_t numFields = 3;
+    switch (columns) {
+    case XYZI:
+        intensityCol = 3;
+        numFields = 4;
+        break;
+    case XYZRGB:
+        colorCol = 3;
+        numFields = 6;
+        break;
+    case XYZIRGB:
+        intensityCol = 3;
+        colorCol = 4;
+        numFields = 7;
+        break;
+    case XYZNormal:
+        normalCol = 3;
+        numFields = 6;
+        break;
+    default:
+        break;
+    }
+
+    std::vector<PointKernel::value_type> pts;
+    auto sink = [&](const double* values, std::size_t rows) {
+        for (std::size_t i = 0; i < rows; i++, values += numFields) {
+            pts.push_back(PointKernel::value_type(static_cast<float>(values[0]),
+                                                  static_cast<float>(values[1]),
+                                                  static_cast<float>(values[2])));
+            if (intensityCol >= 0) {
+                intensity.push_back(static_cast<float>(values[intensityCol]));
+            }
+            if (colorCol >= 0) {
+                colors.push_back(App::Color(static_cast<float>(values[colorCol]),
+                                            static_cast<float>(values[colorCol + 1]),
+                                            static_cast<float>(values[colorCol + 2])));
+            }
+            if (normalCol >= 0) {
+                normals.push_back(Base::Vector3f(static_cast<float>(values[normalCol]),
+                                                 static_cast<float>(values[normalCol + 1]),
+                                                 static_cast<float>(values[normalCol + 2])));
+            }
+        }
+        return true;
+    };
+
+    AsciiTableParser parser(numFields, numFields);
+    if (!parseMappedFile(filename, parser, sink)) {
+        Base::FileInfo fi(filename);
+        Base::ifstream file(fi, std::ios::in | std::ios::binary);
+        parseStream(file, parser, sink);
+    }
+
+    // colors can be given in the range [0,1] or [0,255]
+    float maxColor = 0.0f;
+    for (std::vector<App::Color>::iterator it = colors.begin(); it != colors.end(); ++it)
+        maxColor = std::max(maxColor, std::max(it->r, std::max(it->g, it->b)));
+    if (maxColor > 1.0f) {
+        for (std::vector<App::Color>::iterator it = colors.begin(); it != colors.end(); ++it)
+            it->set(it->r / 255.0f, it->g / 255.0f, it->b / 255.0f);
+    }
+
+    points.swap(pts);
 }
 
 // ----------------------------------------------------------------------------
@@ -802,33 +1557,17 @@ std::size_t PlyReader::readHeader(std::istream& in,
 
 void PlyReader::readAscii(std::istream& inp, std::size_t offset, Eigen::MatrixXd& data)
 {
+    // skip the lines of the elements before the vertices
     std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
-
-        if (offset > 0) {
-            offset--;
-            continue;
-        }
-
-        // since the file is loaded in binary mode we may get the CR at the end
+    while (offset > 0 && std::getline(inp, line)) {
         boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
+        if (!line.empty())
+            offset--;
     }
+
+    AsciiTableParser parser(data.cols(), 1);
+    AsciiMatrixSink sink(data);
+    parseStream(inp, parser, sink);
 }
 
 void PlyReader::readBinary(bool swapByteOrder,
@@ -1164,28 +1903,9 @@ std::size_t PcdReader::readHeader(std::istream& in,
 
 void PcdReader::readAscii(std::istream& inp, Eigen::MatrixXd& data)
 {
-    std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
-
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
+    AsciiTableParser parser(data.cols(), 1);
+    AsciiMatrixSink sink(data);
+    parseStream(inp, parser, sink);
 }
 
 void PcdReader::readBinary(bool transpose,
@@ -25,6 +25,34 @@ public:
     /** Load a point cloud
      */
     static void LoadAscii(PointKernel&, const char *FileName);
+    /** Converts the points of an ASCII file into an octree file, see PointsOctree.
+     * The file is read twice and never loaded into memory as a whole.
+     */
+    static void BuildOctree(const char *FileName, const char *OctreeName, unsigned long nodeSize);
+
+    /** @name Point cloud operators
+     * The operators search the neighbours of all points in parallel with a PointsKDTree.
+     */
+    //@{
+    /** Estimates the normal of each point as the direction of least variance of its
+     * \a k nearest neighbours. If \a orient is true the normals are made consistent by
+     * propagating the orientation along a minimum spanning tree of the neighbourhood
+     * graph, starting with an upward normal at the highest point of each connected part.
+     */
+    static void EstimateNormals(const std::vector<Base::Vector3f>& points, unsigned long k,
+                                bool orient, std::vector<Base::Vector3f>& normals);
+    /** Returns the indices of the points whose mean distance to their \a k nearest
+     * neighbours exceeds the average over all points by more than \a stddev standard
+     * deviations.
+     */
+    static void FindOutliers(const std::vector<Base::Vector3f>& points, unsigned long k,
+                             double stddev, std::vector<unsigned long>& outliers);
+    /** Replaces the points of each cube of a regular grid with edge length \a size
+     * by their centroid.
+     */
+    static void Downsample(const std::vector<Base::Vector3f>& points, float size,
+                           std::vector<Base::Vector3f>& result);
+    //@}
 };
 
 class Reader
@@ -55,12 +83,38 @@ protected:
     int width, height;
 };
 
+/**
+ * The AscReader class reads points from a text file. Each line holds the values
+ * of a point, lines that don't start with a number are skipped. The file is
+ * mapped into memory and parsed in parallel.
+ */
 class AscReader : public Reader
 {
 public:
+    /// The values of each line
+    enum Layout {
+        Automatic,  /**< Determined by the number of values in the first lines. Six values
+                         are read as normal only if some of them can't be a color, otherwise
+                         the layout must be set explicitly */
+        XYZ,        /**< Coordinates */
+        XYZI,       /**< Coordinates and intensity */
+        XYZRGB,     /**< Coordinates and color */
+        XYZIRGB,    /**< Coordinates, intensity and color */
+        XYZNormal   /**< Coordinates and normal */
+    };
+
     AscReader();
+    AscReader(Layout);
     ~AscReader();
+    void setLayout(Layout);
+    Layout getLayout() const;
     void read(const std::string& filename);
+
+private:
+    Layout detectLayout(const std::string& filename) const;
+
+private:
+    Layout layout;
 };
 
 class PlyReader : public Reader
@@ -0,0 +1,222 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *   FreeCAD LICENSE IS LGPL3 WITHOUT ANY WARRANTY                         *
+ ***************************************************************************/
+
+
+
+# include <algorithm>
+# include <utility>
+
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include "Base/BoundBox.h"
+
+#include "PointsKDTree.h"
+
+using namespace Points;
+
+namespace {
+
+// Ranges with at most this number of points are not split any further
+const unsigned long LeafSize = 8;
+
+typedef std::pair<float, unsigned long> Neighbour;
+
+class KDTreeSearch
+{
+public:
+    KDTreeSearch(const std::vector<Base::Vector3f>& points,
+                 const std::vector<unsigned long>& indices,
+                 const std::vector<unsigned char>& axes)
+      : points(points), indices(indices), axes(axes)
+    {
+    }
+
+    // The heap holds the best candidates so far with the farthest one on top
+    void nearest(const Base::Vector3f& p, unsigned long k, unsigned long begin, unsigned long end,
+                 std::vector<Neighbour>& heap) const
+    {
+        if (end - begin <= LeafSize) {
+            for (unsigned long i = begin; i < end; i++)
+                add(p, k, indices[i], heap);
+            return;
+        }
+
+        unsigned long mid = (begin + end) / 2;
+        unsigned char axis = axes[mid];
+        add(p, k, indices[mid], heap);
+
+        float diff = p[axis] - points[indices[mid]][axis];
+        if (diff < 0.0f) {
+            nearest(p, k, begin, mid, heap);
+            if (heap.size() < k || diff * diff < heap.front().first)
+                nearest(p, k, mid + 1, end, heap);
+        }
+        else {
+            nearest(p, k, mid + 1, end, heap);
+            if (heap.size() < k || diff * diff < heap.front().first)
+                nearest(p, k, begin, mid, heap);
+        }
+    }
+
+    void inRange(const Base::Vector3f& p, float radius2, unsigned long begin, unsigned long end,
+                 std::vector<unsigned long>& result) const
+    {
+        if (end - begin <= LeafSize) {
+            for (unsigned long i = begin; i < end; i++) {
+                if (Base::DistanceP2(p, points[indices[i]]) <= radius2)
+                    result.push_back(indices[i]);
+            }
+            return;
+        }
+
+        unsigned long mid = (begin + end) / 2;
+        unsigned char axis = axes[mid];
+        if (Base::DistanceP2(p, points[indices[mid]]) <= radius2)
+            result.push_back(indices[mid]);
+
+        float diff = p[axis] - points[indices[mid]][axis];
+        if (diff < 0.0f || diff * diff <= radius2)
+            inRange(p, radius2, begin, mid, result);
+        if (diff >= 0.0f || diff * diff <= radius2)
+            inRange(p, radius2, mid + 1, end, result);
+    }
+
+private:
+    void add(const Base::Vector3f& p, unsigned long k, unsigned long index,
+             std::vector<Neighbour>& heap) const
+    {
+        Neighbour entry(Base::DistanceP2(p, points[index]), index);
+        if (heap.size() < k) {
+            heap.push_back(entry);
+            std::push_heap(heap.begin(), heap.end());
+        }
+        else if (entry < heap.front()) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = entry;
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    const std::vector<Base::Vector3f>& points;
+    const std::vector<unsigned long>& indices;
+    const std::vector<unsigned char>& axes;
+};
+
+}
+
+PointsKDTree::PointsKDTree(const std::vector<Base::Vector3f>& points)
+  : _points(points), _indices(points.size()), _axes(points.size(), 0)
+{
+    for (unsigned long i = 0; i < _indices.size(); i++)
+        _indices[i] = i;
+
+    // Split the upper levels until there are enough independent subtrees to
+    // keep all threads busy, the subtrees are then built in parallel.
+    const std::size_t numTasks = 8 * std::max(QThread::idealThreadCount(), 1);
+    std::vector<std::pair<unsigned long, unsigned long> > tasks, next;
+    tasks.push_back(std::make_pair(0ul, static_cast<unsigned long>(_indices.size())));
+    bool expanded = true;
+    while (expanded && tasks.size() < numTasks) {
+        expanded = false;
+        next.clear();
+        for (std::vector<std::pair<unsigned long, unsigned long> >::iterator it = tasks.begin(); it != tasks.end(); ++it) {
+            if (it->second - it->first <= LeafSize) {
+                next.push_back(*it);
+                continue;
+            }
+            SplitRange(it->first, it->second);
+            unsigned long mid = (it->first + it->second) / 2;
+            next.push_back(std::make_pair(it->first, mid));
+            next.push_back(std::make_pair(mid + 1, it->second));
+            expanded = true;
+        }
+        tasks.swap(next);
+    }
+
+    QtConcurrent::blockingMap(tasks, [this](const std::pair<unsigned long, unsigned long>& range) {
+        Build(range.first, range.second);
+    });
+}
+
+PointsKDTree::~PointsKDTree()
+{
+}
+
+void PointsKDTree::SplitRange(unsigned long begin, unsigned long end)
+{
+    // split at the median along the longest side of the bounding box
+    Base::BoundBox3f box;
+    for (unsigned long i = begin; i < end; i++)
+        box.Add(_points[_indices[i]]);
+
+    unsigned char axis = 0;
+    float len = box.LengthX();
+    if (box.LengthY() > len) {
+        axis = 1;
+        len = box.LengthY();
+    }
+    if (box.LengthZ() > len) {
+        axis = 2;
+    }
+
+    unsigned long mid = (begin + end) / 2;
+    const std::vector<Base::Vector3f>& points = _points;
+    std::nth_element(_indices.begin() + begin, _indices.begin() + mid, _indices.begin() + end,
+                     [&points, axis](unsigned long a, unsigned long b) {
+        return points[a][axis] < points[b][axis];
+    });
+    _axes[mid] = axis;
+}
+
+void PointsKDTree::Build(unsigned long begin, unsigned long end)
+{
+    std::vector<std::pair<unsigned long, unsigned long> > todo;
+    todo.push_back(std::make_pair(begin, end));
+    while (!todo.empty()) {
+        std::pair<unsigned long, unsigned long> range = todo.back();
+        todo.pop_back();
+        if (range.second - range.first <= LeafSize)
+            continue;
+
+        SplitRange(range.first, range.second);
+        unsigned long mid = (range.first + range.second) / 2;
+        todo.push_back(std::make_pair(range.first, mid));
+        todo.push_back(std::make_pair(mid + 1, range.second));
+    }
+}
+
+void PointsKDTree::FindNearest(const Base::Vector3f& p, unsigned long k,
+                               std::vector<unsigned long>& indices,
+                               std::vector<float>& distances) const
+{
+    indices.clear();
+    distances.clear();
+    if (k == 0 || _indices.empty())
+        return;
+
+    std::vector<Neighbour> heap;
+    heap.reserve(k);
+    KDTreeSearch search(_points, _indices, _axes);
+    search.nearest(p, k, 0, _indices.size(), heap);
+
+    std::sort_heap(heap.begin(), heap.end());
+    indices.reserve(heap.size());
+    distances.reserve(heap.size());
+    for (std::vector<Neighbour>::iterator it = heap.begin(); it != heap.end(); ++it) {
+        distances.push_back(it->first);
+        indices.push_back(it->second);
+    }
+}
+
+void PointsKDTree::FindInRange(const Base::Vector3f& p, float radius,
+                               std::vector<unsigned long>& indices) const
+{
+    if (_indices.empty())
+        return;
+
+    KDTreeSearch search(_points, _indices, _axes);
+    search.inRange(p, radius * radius, 0, _indices.size(), indices);
+}
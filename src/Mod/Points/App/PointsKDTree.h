@@ -0,0 +1,57 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *   FreeCAD LICENSE IS LGPL3 WITHOUT ANY WARRANTY                         *
+ ***************************************************************************/
+
+
+#ifndef POINTS_KDTREE_H
+#define POINTS_KDTREE_H
+
+#include "stdexport.h"
+#include <vector>
+
+#include "Base/Vector3D.h"
+
+namespace Points {
+
+/**
+ * The PointsKDTree class is a balanced kd-tree over a point array. The tree
+ * doesn't have explicit nodes: the points of a subtree occupy a contiguous
+ * range of the index array and the median of the range is the splitting point.
+ * The tree is built in parallel and, since it is never modified afterwards,
+ * can be searched from several threads at the same time.
+ * @author agent
+ */
+class Standard_EXPORT PointsKDTree
+{
+public:
+    /** The tree only references the points, they must not be changed
+     * while the tree is in use.
+     */
+    PointsKDTree(const std::vector<Base::Vector3f>& points);
+    ~PointsKDTree();
+
+    /** Returns the indices of the \a k nearest points of \a p and their squared
+     * distances sorted by distance. If there are less than \a k points all
+     * points are returned.
+     */
+    void FindNearest(const Base::Vector3f& p, unsigned long k,
+                     std::vector<unsigned long>& indices,
+                     std::vector<float>& distances) const;
+    /** Returns the indices of all points with a distance to \a p of at most \a radius. */
+    void FindInRange(const Base::Vector3f& p, float radius,
+                     std::vector<unsigned long>& indices) const;
+
+private:
+    void Build(unsigned long begin, unsigned long end);
+    void SplitRange(unsigned long begin, unsigned long end);
+
+private:
+    const std::vector<Base::Vector3f>& _points;
+    std::vector<unsigned long> _indices;
+    std::vector<unsigned char> _axes;
+};
+
+} // namespace Points
+
+#endif // POINTS_KDTREE_H
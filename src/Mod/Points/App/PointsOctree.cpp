@@ -0,0 +1,718 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *   FreeCAD LICENSE IS LGPL3 WITHOUT ANY WARRANTY                         *
+ ***************************************************************************/
+
+
+
+# include <algorithm>
+# include <cmath>
+# include <cstdio>
+# include <limits>
+# include <queue>
+# include <random>
+
+#include <QMutexLocker>
+
+#include "Base/Exception.h"
+#include "Base/FileInfo.h"
+
+#include "PointsOctree.h"
+
+using namespace Points;
+
+namespace {
+
+const uint32_t OctreeMagic = 0x4f435452;
+const uint32_t OctreeVersion = 1;
+
+// Number of points of a bucket that are collected before they are written to disk
+const std::size_t BucketBufferSize = 65536;
+
+// Maximum depth of the tree, this limits the recursion for many equal points
+const uint32_t MaxLevel = 20;
+
+// Index of the octant of cube that contains the point
+inline int octant(const Base::Vector3f& p, const Base::BoundBox3f& cube)
+{
+    Base::Vector3f c = cube.GetCenter();
+    return (p.x >= c.x ? 1 : 0) | (p.y >= c.y ? 2 : 0) | (p.z >= c.z ? 4 : 0);
+}
+
+inline Base::BoundBox3f childCube(const Base::BoundBox3f& cube, int index)
+{
+    Base::Vector3f c = cube.GetCenter();
+    return Base::BoundBox3f((index & 1) ? c.x : cube.MinX,
+                            (index & 2) ? c.y : cube.MinY,
+                            (index & 4) ? c.z : cube.MinZ,
+                            (index & 1) ? cube.MaxX : c.x,
+                            (index & 2) ? cube.MaxY : c.y,
+                            (index & 4) ? cube.MaxZ : c.z);
+}
+
+// Squared distance of the point to the box, 0 if the point is inside
+inline float distanceSquared(const Base::Vector3f& p, const Base::BoundBox3f& box)
+{
+    float dx = std::max(std::max(box.MinX - p.x, p.x - box.MaxX), 0.0f);
+    float dy = std::max(std::max(box.MinY - p.y, p.y - box.MaxY), 0.0f);
+    float dz = std::max(std::max(box.MinZ - p.z, p.z - box.MaxZ), 0.0f);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+struct OctreeHeader
+{
+    Base::BoundBox3f box;
+    uint32_t nodeSize;
+    uint64_t numPoints;
+    uint32_t numNodes;
+    uint64_t tableOffset;
+};
+
+void writeHeader(std::ostream& out, const OctreeHeader& header)
+{
+    Base::OutputStream str(out);
+    str << OctreeMagic << OctreeVersion
+        << header.box.MinX << header.box.MinY << header.box.MinZ
+        << header.box.MaxX << header.box.MaxY << header.box.MaxZ
+        << header.nodeSize << header.numPoints << header.numNodes << header.tableOffset;
+}
+
+void readHeader(std::istream& in, OctreeHeader& header)
+{
+    Base::InputStream str(in);
+    uint32_t magic = 0, version = 0;
+    str >> magic >> version;
+    if (!in || magic != OctreeMagic)
+        throw Base::BadFormatError("Not an octree file");
+    if (version != OctreeVersion)
+        throw Base::BadFormatError("Unsupported version of octree file");
+    str >> header.box.MinX >> header.box.MinY >> header.box.MinZ
+        >> header.box.MaxX >> header.box.MaxY >> header.box.MaxZ
+        >> header.nodeSize >> header.numPoints >> header.numNodes >> header.tableOffset;
+    if (!in)
+        throw Base::BadFormatError("Reading octree header failed");
+}
+
+void writeNode(Base::OutputStream& str, const PointsOctree::Node& node)
+{
+    str << node.box.MinX << node.box.MinY << node.box.MinZ
+        << node.box.MaxX << node.box.MaxY << node.box.MaxZ
+        << node.level;
+    for (int i = 0; i < 8; i++)
+        str << node.children[i];
+    str << node.offset << node.count << node.total;
+}
+
+void readNode(Base::InputStream& str, PointsOctree::Node& node)
+{
+    str >> node.box.MinX >> node.box.MinY >> node.box.MinZ
+        >> node.box.MaxX >> node.box.MaxY >> node.box.MaxZ
+        >> node.level;
+    for (int i = 0; i < 8; i++)
+        str >> node.children[i];
+    str >> node.offset >> node.count >> node.total;
+}
+
+std::string bucketName(const std::string& fileName, std::size_t bucket)
+{
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), ".bucket%02d", static_cast<int>(bucket));
+    return fileName + suffix;
+}
+
+}
+
+// ----------------------------------------------------------------------
+
+bool PointsOctree::Node::IsLeaf() const
+{
+    for (int i = 0; i < 8; i++) {
+        if (children[i] != NoChild)
+            return false;
+    }
+    return true;
+}
+
+PointsOctree::PointsOctree()
+  : numPoints(0), cachedPoints(0), cacheSize(10000000)
+{
+}
+
+PointsOctree::~PointsOctree()
+{
+}
+
+void PointsOctree::open(const std::string& filename)
+{
+    close();
+
+    Base::FileInfo fi(filename);
+    std::unique_ptr<Base::ifstream> str(new Base::ifstream(fi, std::ios::in | std::ios::binary));
+    if (!str->is_open())
+        throw Base::FileException("Cannot open file", fi);
+
+    OctreeHeader header;
+    readHeader(*str, header);
+    str->seekg(static_cast<std::streamoff>(header.tableOffset), std::ios::beg);
+    if (!*str)
+        throw Base::BadFormatError("Invalid offset of node table");
+
+    std::vector<Node> table(header.numNodes);
+    Base::InputStream in(*str);
+    uint64_t sum = 0;
+    for (std::vector<Node>::iterator it = table.begin(); it != table.end(); ++it) {
+        readNode(in, *it);
+        if (!*str)
+            throw Base::BadFormatError("Reading node table failed");
+        for (int i = 0; i < 8; i++) {
+            if (it->children[i] != NoChild && it->children[i] >= header.numNodes)
+                throw Base::BadFormatError("Invalid child index in node table");
+        }
+        if (it->offset + 3 * sizeof(float) * static_cast<uint64_t>(it->count) > header.tableOffset)
+            throw Base::BadFormatError("Invalid point offset in node table");
+        sum += it->count;
+    }
+    if (sum != header.numPoints)
+        throw Base::BadFormatError("Unexpected number of points in octree");
+
+    // the file is shared with the readers of the node cache
+    QMutexLocker lock(&mutex);
+    fileName = filename;
+    nodes.swap(table);
+    numPoints = header.numPoints;
+    file.reset(str.release());
+}
+
+void PointsOctree::close()
+{
+    QMutexLocker lock(&mutex);
+    file.reset();
+    fileName.clear();
+    nodes.clear();
+    numPoints = 0;
+    recentNodes.clear();
+    cache.clear();
+    cachedPoints = 0;
+}
+
+bool PointsOctree::isOpen() const
+{
+    return file.get() != nullptr;
+}
+
+const std::string& PointsOctree::getFileName() const
+{
+    return fileName;
+}
+
+Base::BoundBox3f PointsOctree::getBoundBox() const
+{
+    if (nodes.empty())
+        return Base::BoundBox3f();
+    return nodes.front().box;
+}
+
+uint64_t PointsOctree::countPoints() const
+{
+    return numPoints;
+}
+
+unsigned long PointsOctree::countNodes() const
+{
+    return static_cast<unsigned long>(nodes.size());
+}
+
+const PointsOctree::Node& PointsOctree::getNode(unsigned long index) const
+{
+    return nodes[index];
+}
+
+void PointsOctree::setCacheSize(std::size_t numPoints)
+{
+    QMutexLocker lock(&mutex);
+    cacheSize = numPoints;
+}
+
+PointsOctree::PointsPtr PointsOctree::getPoints(unsigned long index) const
+{
+    QMutexLocker lock(&mutex);
+    auto it = cache.find(index);
+    if (it != cache.end()) {
+        recentNodes.splice(recentNodes.begin(), recentNodes, it->second.second);
+        return it->second.first;
+    }
+
+    PointsPtr points = readPoints(index);
+    recentNodes.push_front(index);
+    cache[index] = std::make_pair(points, recentNodes.begin());
+    cachedPoints += points->size();
+
+    // drop the least recently used nodes but always keep the one just read
+    while (cachedPoints > cacheSize && recentNodes.size() > 1) {
+        auto jt = cache.find(recentNodes.back());
+        cachedPoints -= jt->second.first->size();
+        cache.erase(jt);
+        recentNodes.pop_back();
+    }
+
+    return points;
+}
+
+PointsOctree::PointsPtr PointsOctree::readPoints(unsigned long index) const
+{
+    if (!file)
+        throw Base::RuntimeError("Octree file is not open");
+
+    const Node& node = nodes[index];
+    std::shared_ptr<std::vector<Base::Vector3f> > points(new std::vector<Base::Vector3f>(node.count));
+    if (node.count > 0) {
+        file->clear();
+        file->seekg(static_cast<std::streamoff>(node.offset), std::ios::beg);
+        Base::InputStream str(*file);
+        str.read(&(*points)[0].x, 3 * static_cast<std::size_t>(node.count));
+        if (!*file)
+            throw Base::FileException("Reading points of octree node failed", fileName.c_str());
+    }
+    return points;
+}
+
+void PointsOctree::searchBox(const Base::BoundBox3f& rclBB, std::vector<Base::Vector3f>& points) const
+{
+    if (nodes.empty())
+        return;
+
+    std::vector<unsigned long> todo;
+    todo.push_back(0);
+    while (!todo.empty()) {
+        unsigned long index = todo.back();
+        todo.pop_back();
+
+        const Node& node = nodes[index];
+        PointsPtr data = getPoints(index);
+        if (rclBB.IsInBox(node.box)) {
+            points.insert(points.end(), data->begin(), data->end());
+        }
+        else {
+            for (std::vector<Base::Vector3f>::const_iterator it = data->begin(); it != data->end(); ++it) {
+                if (rclBB.IsInBox(*it))
+                    points.push_back(*it);
+            }
+        }
+
+        for (int i = 0; i < 8; i++) {
+            if (node.children[i] != NoChild && (nodes[node.children[i]].box && rclBB))
+                todo.push_back(node.children[i]);
+        }
+    }
+}
+
+void PointsOctree::searchRadius(const Base::Vector3f& center, float radius, std::vector<Base::Vector3f>& points) const
+{
+    if (nodes.empty())
+        return;
+
+    float radius2 = radius * radius;
+    std::vector<unsigned long> todo;
+    if (distanceSquared(center, nodes.front().box) <= radius2)
+        todo.push_back(0);
+    while (!todo.empty()) {
+        unsigned long index = todo.back();
+        todo.pop_back();
+
+        const Node& node = nodes[index];
+        PointsPtr data = getPoints(index);
+        for (std::vector<Base::Vector3f>::const_iterator it = data->begin(); it != data->end(); ++it) {
+            if (Base::DistanceP2(center, *it) <= radius2)
+                points.push_back(*it);
+        }
+
+        for (int i = 0; i < 8; i++) {
+            if (node.children[i] != NoChild && distanceSquared(center, nodes[node.children[i]].box) <= radius2)
+                todo.push_back(node.children[i]);
+        }
+    }
+}
+
+void PointsOctree::searchNearest(const Base::Vector3f& point, unsigned long k, std::vector<Base::Vector3f>& points) const
+{
+    if (nodes.empty() || k == 0)
+        return;
+
+    // Best-first traversal: the nodes are visited in the order of their distance
+    // to the point until the k-th nearest point so far is closer than the next node.
+    typedef std::pair<float, unsigned long> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > todo;
+    std::priority_queue<std::pair<float, Base::Vector3f>,
+        std::vector<std::pair<float, Base::Vector3f> >,
+        bool(*)(const std::pair<float, Base::Vector3f>&, const std::pair<float, Base::Vector3f>&)>
+        best([](const std::pair<float, Base::Vector3f>& a, const std::pair<float, Base::Vector3f>& b) {
+            return a.first < b.first;
+        });
+
+    todo.push(Entry(distanceSquared(point, nodes.front().box), 0));
+    while (!todo.empty()) {
+        Entry entry = todo.top();
+        todo.pop();
+        if (best.size() == k && entry.first > best.top().first)
+            break;
+
+        const Node& node = nodes[entry.second];
+        PointsPtr data = getPoints(entry.second);
+        for (std::vector<Base::Vector3f>::const_iterator it = data->begin(); it != data->end(); ++it) {
+            float dist = Base::DistanceP2(point, *it);
+            if (best.size() < k) {
+                best.push(std::make_pair(dist, *it));
+            }
+            else if (dist < best.top().first) {
+                best.pop();
+                best.push(std::make_pair(dist, *it));
+            }
+        }
+
+        for (int i = 0; i < 8; i++) {
+            if (node.children[i] != NoChild) {
+                float dist = distanceSquared(point, nodes[node.children[i]].box);
+                if (best.size() < k || dist <= best.top().first)
+                    todo.push(Entry(dist, node.children[i]));
+            }
+        }
+    }
+
+    std::size_t offset = points.size();
+    points.resize(offset + best.size());
+    for (std::size_t i = points.size(); i > offset; i--) {
+        points[i - 1] = best.top().second;
+        best.pop();
+    }
+}
+
+void PointsOctree::selectNodes(const Base::Vector3f& eye, std::size_t pointBudget, std::vector<unsigned long>& selection,
+                               const std::function<bool(const Base::BoundBox3f&)>& visible) const
+{
+    if (nodes.empty())
+        return;
+
+    // The priority is the size of the node relative to its distance to the eye,
+    // so that nodes appearing larger on screen are refined first. Since a child is
+    // never larger than its parent a node always comes after its parent.
+    auto priority = [&eye](const Node& node) {
+        float dist = std::sqrt(distanceSquared(eye, node.box));
+        if (dist <= 0.0f)
+            return std::numeric_limits<float>::max();
+        return node.box.CalcDiagonalLength() / dist;
+    };
+
+    typedef std::pair<float, unsigned long> Entry;
+    std::priority_queue<Entry> todo;
+    if (!visible || visible(nodes.front().box))
+        todo.push(Entry(priority(nodes.front()), 0));
+
+    std::size_t total = 0;
+    while (!todo.empty()) {
+        unsigned long index = todo.top().second;
+        todo.pop();
+
+        const Node& node = nodes[index];
+        if (total + node.count > pointBudget)
+            break;
+        total += node.count;
+        selection.push_back(index);
+
+        for (int i = 0; i < 8; i++) {
+            if (node.children[i] == NoChild)
+                continue;
+            const Node& child = nodes[node.children[i]];
+            if (!visible || visible(child.box))
+                todo.push(Entry(priority(child), node.children[i]));
+        }
+    }
+}
+
+void PointsOctree::selectNodes(std::size_t pointBudget, std::vector<unsigned long>& selection) const
+{
+    // the nodes are stored in level order
+    std::size_t total = 0;
+    for (unsigned long index = 0; index < nodes.size(); index++) {
+        if (total + nodes[index].count > pointBudget)
+            break;
+        total += nodes[index].count;
+        selection.push_back(index);
+    }
+}
+
+// ----------------------------------------------------------------------
+
+PointsOctreeBuilder::PointsOctreeBuilder(const std::string& filename, const Base::BoundBox3f& box,
+                                         unsigned long nodeSize)
+  : fileName(filename), nodeSize(std::max<unsigned long>(nodeSize, 1)), numPoints(0)
+  , buffers(64), bucketSizes(64, 0)
+{
+    // use a cube that is slightly larger than the box
+    Base::Vector3f center = box.IsValid() ? box.GetCenter() : Base::Vector3f();
+    float length = box.IsValid() ? std::max(std::max(box.LengthX(), box.LengthY()), box.LengthZ()) : 0.0f;
+    float half = 0.5f * length * 1.001f + 1.0e-4f;
+    cube = Base::BoundBox3f(center.x - half, center.y - half, center.z - half,
+                            center.x + half, center.y + half, center.z + half);
+}
+
+PointsOctreeBuilder::~PointsOctreeBuilder()
+{
+    removeBuckets();
+}
+
+void PointsOctreeBuilder::addPoints(const Base::Vector3f* points, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        Base::Vector3f p(std::min(std::max(points[i].x, cube.MinX), cube.MaxX),
+                         std::min(std::max(points[i].y, cube.MinY), cube.MaxY),
+                         std::min(std::max(points[i].z, cube.MinZ), cube.MaxZ));
+        int first = octant(p, cube);
+        std::size_t bucket = 8 * first + octant(p, childCube(cube, first));
+        buffers[bucket].push_back(p);
+        if (buffers[bucket].size() >= BucketBufferSize)
+            flushBucket(bucket);
+    }
+
+    numPoints += count;
+}
+
+void PointsOctreeBuilder::flushBucket(std::size_t bucket)
+{
+    std::vector<Base::Vector3f>& buffer = buffers[bucket];
+    if (buffer.empty())
+        return;
+
+    Base::FileInfo fi(bucketName(fileName, bucket));
+    std::ios::openmode mode = std::ios::out | std::ios::binary;
+    mode |= bucketSizes[bucket] == 0 ? std::ios::trunc : std::ios::app;
+    Base::ofstream str(fi, mode);
+    if (!str.is_open())
+        throw Base::FileException("Cannot write temporary file", fi);
+    Base::OutputStream out(str);
+    out.write(&buffer[0].x, 3 * buffer.size());
+    if (!str)
+        throw Base::FileException("Cannot write temporary file", fi);
+
+    bucketSizes[bucket] += buffer.size();
+    buffer.clear();
+}
+
+void PointsOctreeBuilder::removeBuckets()
+{
+    for (std::size_t i = 0; i < bucketSizes.size(); i++) {
+        if (bucketSizes[i] > 0) {
+            Base::FileInfo fi(bucketName(fileName, i));
+            fi.deleteFile();
+            bucketSizes[i] = 0;
+        }
+    }
+}
+
+uint32_t PointsOctreeBuilder::buildNode(std::vector<Base::Vector3f>& points, const Base::BoundBox3f& box,
+                                        uint32_t level, std::ostream& out)
+{
+    // Shuffle the points so that the first ones are a random sample, the seed
+    // only depends on the position in the tree to get reproducible files.
+    std::mt19937 rng(static_cast<uint32_t>(nodes.size()) * 2654435761u + level);
+    std::shuffle(points.begin(), points.end(), rng);
+
+    PointsOctree::Node node;
+    node.box = box;
+    node.level = level;
+    std::fill(node.children, node.children + 8, PointsOctree::NoChild);
+    node.offset = 0;
+    node.total = 0;
+
+    std::vector<Base::Vector3f> sample;
+    if (points.size() <= nodeSize || level >= MaxLevel) {
+        sample.swap(points);
+    }
+    else {
+        std::vector<Base::Vector3f> octants[8];
+        for (std::size_t i = nodeSize; i < points.size(); i++)
+            octants[octant(points[i], box)].push_back(points[i]);
+        points.resize(nodeSize);
+        sample.swap(points);
+
+        for (int i = 0; i < 8; i++) {
+            if (!octants[i].empty())
+                node.children[i] = buildNode(octants[i], childCube(box, i), level + 1, out);
+        }
+    }
+
+    node.count = static_cast<uint32_t>(sample.size());
+    uint32_t index = static_cast<uint32_t>(nodes.size());
+    if (level <= 2) {
+        // the samples of the upper levels are completed in finish()
+        pending[index].swap(sample);
+    }
+    else if (!sample.empty()) {
+        node.offset = static_cast<uint64_t>(out.tellp());
+        Base::OutputStream str(out);
+        str.write(&sample[0].x, 3 * sample.size());
+    }
+
+    nodes.push_back(node);
+    return index;
+}
+
+void PointsOctreeBuilder::finish()
+{
+    for (std::size_t i = 0; i < buffers.size(); i++) {
+        flushBucket(i);
+        std::vector<Base::Vector3f>().swap(buffers[i]);
+    }
+
+    Base::FileInfo fi(fileName);
+    Base::ofstream out(fi, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        throw Base::FileException("Cannot open file", fi);
+
+    OctreeHeader header;
+    header.box = cube;
+    header.nodeSize = static_cast<uint32_t>(nodeSize);
+    header.numPoints = numPoints;
+    header.numNodes = 0;
+    header.tableOffset = 0;
+    writeHeader(out, header);
+
+    nodes.clear();
+    pending.clear();
+
+    // The points of one bucket are a subtree of the third level. They are read
+    // one after the other so that only a single bucket must fit into memory.
+    uint32_t levelTwo[64];
+    for (std::size_t bucket = 0; bucket < 64; bucket++) {
+        levelTwo[bucket] = PointsOctree::NoChild;
+        if (bucketSizes[bucket] == 0)
+            continue;
+
+        Base::FileInfo bi(bucketName(fileName, bucket));
+        std::vector<Base::Vector3f> points(bucketSizes[bucket]);
+        {
+            Base::ifstream str(bi, std::ios::in | std::ios::binary);
+            Base::InputStream in(str);
+            in.read(&points[0].x, 3 * points.size());
+            if (!str)
+                throw Base::FileException("Cannot read temporary file", bi);
+        }
+        bi.deleteFile();
+        bucketSizes[bucket] = 0;
+
+        int first = static_cast<int>(bucket / 8);
+        Base::BoundBox3f box = childCube(childCube(cube, first), static_cast<int>(bucket % 8));
+        levelTwo[bucket] = buildNode(points, box, 2, out);
+    }
+
+    // The samples of the first two levels are taken from the samples of their
+    // children proportionally to their sizes, so that the density stays uniform.
+    auto gatherSample = [this](PointsOctree::Node& node) {
+        std::size_t sum = 0;
+        for (int i = 0; i < 8; i++) {
+            if (node.children[i] != PointsOctree::NoChild)
+                sum += pending[node.children[i]].size();
+        }
+
+        std::vector<Base::Vector3f> sample;
+        for (int i = 0; i < 8 && sum > 0; i++) {
+            if (node.children[i] == PointsOctree::NoChild)
+                continue;
+            std::vector<Base::Vector3f>& child = pending[node.children[i]];
+            std::size_t take = child.size();
+            if (sum > nodeSize)
+                take = std::min(take, (nodeSize * child.size() + sum - 1) / sum);
+            sample.insert(sample.end(), child.end() - take, child.end());
+            child.resize(child.size() - take);
+        }
+        return sample;
+    };
+
+    auto makeNode = [this](const Base::BoundBox3f& box, uint32_t level) {
+        PointsOctree::Node node;
+        node.box = box;
+        node.level = level;
+        std::fill(node.children, node.children + 8, PointsOctree::NoChild);
+        node.offset = 0;
+        node.count = 0;
+        node.total = 0;
+        return node;
+    };
+
+    PointsOctree::Node root = makeNode(cube, 0);
+    for (int i = 0; i < 8; i++) {
+        PointsOctree::Node node = makeNode(childCube(cube, i), 1);
+        bool empty = true;
+        for (int j = 0; j < 8; j++) {
+            node.children[j] = levelTwo[8 * i + j];
+            if (node.children[j] != PointsOctree::NoChild)
+                empty = false;
+        }
+        if (empty)
+            continue;
+
+        std::vector<Base::Vector3f> sample = gatherSample(node);
+        uint32_t index = static_cast<uint32_t>(nodes.size());
+        node.count = static_cast<uint32_t>(sample.size());
+        pending[index].swap(sample);
+        nodes.push_back(node);
+        root.children[i] = index;
+    }
+
+    std::vector<Base::Vector3f> rootSample = gatherSample(root);
+    uint32_t rootIndex = static_cast<uint32_t>(nodes.size());
+    root.count = static_cast<uint32_t>(rootSample.size());
+    pending[rootIndex].swap(rootSample);
+    nodes.push_back(root);
+
+    Base::OutputStream str(out);
+    for (std::map<uint32_t, std::vector<Base::Vector3f> >::iterator it = pending.begin(); it != pending.end(); ++it) {
+        PointsOctree::Node& node = nodes[it->first];
+        node.count = static_cast<uint32_t>(it->second.size());
+        node.offset = static_cast<uint64_t>(out.tellp());
+        if (!it->second.empty())
+            str.write(&it->second[0].x, 3 * it->second.size());
+    }
+    pending.clear();
+
+    // children are always created before their parents
+    for (std::vector<PointsOctree::Node>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        it->total = it->count;
+        for (int i = 0; i < 8; i++) {
+            if (it->children[i] != PointsOctree::NoChild)
+                it->total += nodes[it->children[i]].total;
+        }
+    }
+
+    // store the nodes in level order with the root first
+    std::vector<uint32_t> order, newIndex(nodes.size(), PointsOctree::NoChild);
+    order.reserve(nodes.size());
+    order.push_back(rootIndex);
+    newIndex[rootIndex] = 0;
+    for (std::size_t i = 0; i < order.size(); i++) {
+        const PointsOctree::Node& node = nodes[order[i]];
+        for (int j = 0; j < 8; j++) {
+            if (node.children[j] != PointsOctree::NoChild) {
+                newIndex[node.children[j]] = static_cast<uint32_t>(order.size());
+                order.push_back(node.children[j]);
+            }
+        }
+    }
+
+    header.tableOffset = static_cast<uint64_t>(out.tellp());
+    header.numNodes = static_cast<uint32_t>(order.size());
+    for (std::vector<uint32_t>::iterator it = order.begin(); it != order.end(); ++it) {
+        PointsOctree::Node node = nodes[*it];
+        for (int j = 0; j < 8; j++) {
+            if (node.children[j] != PointsOctree::NoChild)
+                node.children[j] = newIndex[node.children[j]];
+        }
+        writeNode(str, node);
+    }
+
+    out.seekp(0, std::ios::beg);
+    writeHeader(out, header);
+    if (!out)
+        throw Base::FileException("Writing octree file failed", fi);
+
+    nodes.clear();
+}
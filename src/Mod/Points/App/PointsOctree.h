@@ -0,0 +1,165 @@
+/***************************************************************************
+ *   Copyright (c) 2026 agent <agent@local>                                *
+ *   FreeCAD LICENSE IS LGPL3 WITHOUT ANY WARRANTY                         *
+ ***************************************************************************/
+
+
+#ifndef POINTS_OCTREE_H
+#define POINTS_OCTREE_H
+
+#include "stdexport.h"
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <QMutex>
+
+#include "Base/BoundBox.h"
+#include "Base/Stream.h"
+#include "Base/Vector3D.h"
+
+namespace Points {
+
+/**
+ * The PointsOctree class gives access to a point cloud that is stored in an
+ * octree file written by PointsOctreeBuilder. Only the node hierarchy is kept
+ * in memory, the points of a node are read from disk on demand and kept in a
+ * cache of limited size. So, the cloud can be much larger than the memory.
+ *
+ * Each node holds a random subset of those points of its cube that are not
+ * stored in one of its ancestors. Reading the nodes from the root down to a
+ * certain level gives a uniformly thinned out version of the cloud, and all
+ * nodes together hold every point exactly once.
+ * @author agent
+ */
+class Standard_EXPORT PointsOctree
+{
+public:
+    static const uint32_t NoChild = 0xffffffff;
+
+    struct Node
+    {
+        Base::BoundBox3f box;   /**< cube of the node */
+        uint32_t level;         /**< depth in the tree, the root has level 0 */
+        uint32_t children[8];   /**< indices of the children or NoChild */
+        uint64_t offset;        /**< position of the points in the file */
+        uint32_t count;         /**< number of points stored in the node */
+        uint64_t total;         /**< number of points in the subtree */
+
+        bool IsLeaf() const;
+    };
+
+    typedef std::shared_ptr<const std::vector<Base::Vector3f> > PointsPtr;
+
+    PointsOctree();
+    ~PointsOctree();
+
+    /** Opens the octree file and reads the node hierarchy. A FileException
+     * or BadFormatError is thrown if the file cannot be read.
+     */
+    void open(const std::string& filename);
+    void close();
+    bool isOpen() const;
+    const std::string& getFileName() const;
+
+    /** Returns the cube of the root node. */
+    Base::BoundBox3f getBoundBox() const;
+    uint64_t countPoints() const;
+    unsigned long countNodes() const;
+    /** Returns the node \a index. The nodes are stored in level order, so the
+     * root has index 0.
+     */
+    const Node& getNode(unsigned long index) const;
+
+    /** Sets the maximum number of points that are kept in memory. */
+    void setCacheSize(std::size_t numPoints);
+    /** Returns the points of the node \a index, reading them from disk if needed. */
+    PointsPtr getPoints(unsigned long index) const;
+
+    /** @name Search */
+    //@{
+    /** Returns all points inside the box \a rclBB. */
+    void searchBox(const Base::BoundBox3f& rclBB, std::vector<Base::Vector3f>& points) const;
+    /** Returns all points with a distance to \a center of at most \a radius. */
+    void searchRadius(const Base::Vector3f& center, float radius, std::vector<Base::Vector3f>& points) const;
+    /** Returns the \a k nearest points of \a point sorted by distance. */
+    void searchNearest(const Base::Vector3f& point, unsigned long k, std::vector<Base::Vector3f>& points) const;
+    //@}
+
+    /** @name Level of detail */
+    //@{
+    /** Selects the nodes that are shown to a viewer at \a eye. Nodes that appear
+     * larger, i.e. with a higher ratio of size and distance to the eye, come first
+     * and a node always comes after its parent. The selection stops before the total
+     * number of points exceeds \a pointBudget. Nodes for which \a visible returns false
+     * are skipped together with their subtrees.
+     */
+    void selectNodes(const Base::Vector3f& eye, std::size_t pointBudget, std::vector<unsigned long>& nodes,
+                     const std::function<bool(const Base::BoundBox3f&)>& visible = nullptr) const;
+    /** Selects the nodes level by level until the total number of points would
+     * exceed \a pointBudget.
+     */
+    void selectNodes(std::size_t pointBudget, std::vector<unsigned long>& nodes) const;
+    //@}
+
+private:
+    PointsPtr readPoints(unsigned long index) const;
+
+private:
+    std::string fileName;
+    std::vector<Node> nodes;
+    uint64_t numPoints;
+
+    // cache of the points of recently used nodes
+    mutable QMutex mutex;
+    mutable std::unique_ptr<Base::ifstream> file;
+    mutable std::list<unsigned long> recentNodes;
+    mutable std::map<unsigned long, std::pair<PointsPtr, std::list<unsigned long>::iterator> > cache;
+    mutable std::size_t cachedPoints;
+    std::size_t cacheSize;
+};
+
+/**
+ * The PointsOctreeBuilder class writes an octree file from points that are
+ * added in portions. The points are first distributed into 64 buckets that are
+ * spilled to temporary files next to the octree file. When finishing, the
+ * buckets are turned into subtrees one after the other, so that only the points
+ * of one bucket must fit into memory.
+ * @author agent
+ */
+class Standard_EXPORT PointsOctreeBuilder
+{
+public:
+    /** All points must be inside \a box. A node stores at most \a nodeSize points. */
+    PointsOctreeBuilder(const std::string& filename, const Base::BoundBox3f& box,
+                        unsigned long nodeSize = 50000);
+    ~PointsOctreeBuilder();
+
+    /** Adds \a count points. Points outside of the box are moved onto its border. */
+    void addPoints(const Base::Vector3f* points, std::size_t count);
+    /** Writes the octree file and removes the temporary files. */
+    void finish();
+
+private:
+    void flushBucket(std::size_t bucket);
+    void removeBuckets();
+    uint32_t buildNode(std::vector<Base::Vector3f>& points, const Base::BoundBox3f& cube,
+                       uint32_t level, std::ostream& out);
+
+private:
+    std::string fileName;
+    Base::BoundBox3f cube;
+    unsigned long nodeSize;
+    uint64_t numPoints;
+    std::vector<PointsOctree::Node> nodes;
+    std::vector<std::vector<Base::Vector3f> > buffers;
+    std::vector<uint64_t> bucketSizes;
+    std::map<uint32_t, std::vector<Base::Vector3f> > pending;
+};
+
+} // namespace Points
+
+#endif // POINTS_OCTREE_H
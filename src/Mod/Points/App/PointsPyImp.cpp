@@ -6,6 +6,7 @@
 
 
 #include "Mod/Points/App/Points.h"
+#include "Mod/Points/App/PointsAlgos.h"
 #include "Base/Builder3D.h"
 #include "Base/VectorPy.h"
 #include "Base/GeometryPyCXX.h"
@@ -200,6 +201,75 @@ PyObject* PointsPy::fromValid(PyObject * args)
     }
 }
 
+PyObject* PointsPy::estimateNormals(PyObject * args)
+{
+    int k = 10;
+    PyObject* orient = Py_True;
+    if (!PyArg_ParseTuple(args, "|iO!", &k, &PyBool_Type, &orient))
+        return 0;
+
+    PY_TRY {
+        const PointKernel* points = getPointKernelPtr();
+        std::vector<Base::Vector3f> normals;
+        PointsAlgos::EstimateNormals(points->getBasicPoints(), static_cast<unsigned long>(std::max(k, 0)),
+                                     PyObject_IsTrue(orient) ? true : false, normals);
+
+        Py::List list(normals.size());
+        for (std::size_t i = 0; i < normals.size(); i++)
+            list.setItem(i, Py::Vector(normals[i]));
+        return Py::new_reference_to(list);
+    } PY_CATCH;
+}
+
+PyObject* PointsPy::removeOutliers(PyObject * args)
+{
+    int k = 10;
+    double stddev = 1.0;
+    if (!PyArg_ParseTuple(args, "|id", &k, &stddev))
+        return 0;
+
+    PY_TRY {
+        const PointKernel* points = getPointKernelPtr();
+        std::vector<unsigned long> outliers;
+        PointsAlgos::FindOutliers(points->getBasicPoints(), static_cast<unsigned long>(std::max(k, 0)),
+                                  stddev, outliers);
+
+        const std::vector<PointKernel::value_type>& basic = points->getBasicPoints();
+        std::vector<PointKernel::value_type> inliers;
+        inliers.reserve(basic.size() - outliers.size());
+        std::vector<unsigned long>::iterator pos = outliers.begin();
+        for (std::size_t i = 0; i < basic.size(); i++) {
+            if (pos != outliers.end() && *pos == i)
+                ++pos;
+            else
+                inliers.push_back(basic[i]);
+        }
+
+        std::unique_ptr<PointKernel> pts(new PointKernel());
+        pts->swap(inliers);
+        pts->setTransform(points->getTransform());
+        return new PointsPy(pts.release());
+    } PY_CATCH;
+}
+
+PyObject* PointsPy::downsample(PyObject * args)
+{
+    double size;
+    if (!PyArg_ParseTuple(args, "d", &size))
+        return 0;
+
+    PY_TRY {
+        const PointKernel* points = getPointKernelPtr();
+        std::vector<PointKernel::value_type> result;
+        PointsAlgos::Downsample(points->getBasicPoints(), static_cast<float>(size), result);
+
+        std::unique_ptr<PointKernel> pts(new PointKernel());
+        pts->swap(result);
+        pts->setTransform(points->getTransform());
+        return new PointsPy(pts.release());
+    } PY_CATCH;
+}
+
 Py::Long PointsPy::getCountPoints(void) const
 {
     return Py::Long((long)getPointKernelPtr()->size());
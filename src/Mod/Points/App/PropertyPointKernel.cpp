@@ -34,7 +34,10 @@ PropertyPointKernel::~PropertyPointKernel()
 void PropertyPointKernel::setValue(const PointKernel& m)
 {
     aboutToSetValue();
-    *_cPoints = m;
+    if (_cPoints.getRefCount() > 1)
+        _cPoints = new PointKernel(m);
+    else
+        *_cPoints = m;
     hasSetValue();
 }
 
@@ -94,6 +97,7 @@ void PropertyPointKernel::Restore(Base::XMLReader &reader)
         mtrx.fromString(Matrix);
 
         aboutToSetValue();
+        detach();
         _cPoints->setTransform(mtrx);
         hasSetValue();
     }
@@ -108,6 +112,7 @@ void PropertyPointKernel::SaveDocFile (Base::Writer &writer) const
 void PropertyPointKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    detach();
     _cPoints->RestoreDocFile(reader);
     hasSetValue();
 }
@@ -115,7 +120,7 @@ void PropertyPointKernel::RestoreDocFile(Base::Reader &reader)
 App::Property *PropertyPointKernel::Copy(void) const 
 {
     PropertyPointKernel* prop = new PropertyPointKernel();
-    (*prop->_cPoints) = (*this->_cPoints);
+    prop->_cPoints = this->_cPoints;
     return prop;
 }
 
@@ -123,10 +128,18 @@ void PropertyPointKernel::Paste(const App::Property &from)
 {
     aboutToSetValue();
     const PropertyPointKernel& prop = dynamic_cast<const PropertyPointKernel&>(from);
-    *(this->_cPoints) = *(prop._cPoints);
+    this->_cPoints = prop._cPoints;
     hasSetValue();
 }
 
+void PropertyPointKernel::detach()
+{
+    // Note: The Python bindings of the property hold a reference, too. They are
+    // immutable and thus may keep the old points.
+    if (_cPoints.getRefCount() > 1)
+        _cPoints = new PointKernel(*_cPoints);
+}
+
 unsigned int PropertyPointKernel::getMemSize (void) const
 {
     return sizeof(Base::Vector3f) * this->_cPoints->size();
@@ -135,6 +148,7 @@ unsigned int PropertyPointKernel::getMemSize (void) const
 PointKernel* PropertyPointKernel::startEditing()
 {
     aboutToSetValue();
+    detach();
     return static_cast<PointKernel*>(_cPoints);
 }
 
@@ -174,6 +188,7 @@ void PropertyPointKernel::removeIndices( const std::vector<unsigned long>& uIndi
 void PropertyPointKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
     aboutToSetValue();
+    detach();
     _cPoints->transformGeometry(rclMat);
     hasSetValue();
 }
@@ -70,6 +70,12 @@ public:
     //@}
 
 private:
+    /// Gives the property its own point kernel if it is shared with a copy of the property
+    void detach();
+
+private:
+    // The point kernel is shared with the copies made for undo/redo and only copied
+    // when it gets modified while still being shared
     Base::Reference<PointKernel> _cPoints;
 };
 
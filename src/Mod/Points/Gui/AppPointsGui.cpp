@@ -71,6 +71,7 @@ PyMOD_INIT_FUNC(PointsGui)
     PointsGui::ViewProviderPoints       ::init();
     PointsGui::ViewProviderScattered    ::init();
     PointsGui::ViewProviderStructured   ::init();
+    PointsGui::ViewProviderOctree       ::init();
     PointsGui::ViewProviderPython       ::init();
     PointsGui::Workbench                ::init();
     Gui::ViewProviderBuilder::add(
@@ -7,6 +7,10 @@
 
 #include "stdexport.h"
 # include "FCConfig.h"
+# include <Inventor/actions/SoGLRenderAction.h>
+# include <Inventor/elements/SoModelMatrixElement.h>
+# include <Inventor/elements/SoViewVolumeElement.h>
+# include <Inventor/nodes/SoCallback.h>
 # include <Inventor/nodes/SoCamera.h>
 # include <Inventor/nodes/SoCoordinate3.h>
 # include <Inventor/nodes/SoDrawStyle.h>
@@ -17,8 +21,11 @@
 # include <Inventor/nodes/SoNormal.h>
 # include <Inventor/errors/SoDebugError.h>
 # include <Inventor/events/SoMouseButtonEvent.h>
+# include <Inventor/sensors/SoOneShotSensor.h>
 
 #include <boost/math/special_functions/fpclassify.hpp>
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 /// Here the FreeCAD includes sorted by Base,App,Gui,...
@@ -37,6 +44,7 @@
 
 #include "Gui/View3DInventorViewer.h"
 #include "Mod/Points/App/PointsFeature.h"
+#include "Mod/Points/App/OctreeFeature.h"
 
 #include "ViewProvider.h"
 #include "../App/Properties.h"
@@ -607,6 +615,117 @@ void ViewProviderStructured::cut(const std::vector<SbVec2f>& picked, Gui::View3D
 
 // -------------------------------------------------
 
+PROPERTY_SOURCE(PointsGui::ViewProviderOctree, PointsGui::ViewProviderScattered)
+
+ViewProviderOctree::ViewProviderOctree()
+  : hasView(false)
+{
+    pcRenderCallback = new SoCallback();
+    pcRenderCallback->ref();
+    pcRenderCallback->setCallback(renderCallback, this);
+    pcSensor = new SoOneShotSensor(sensorCallback, this);
+}
+
+ViewProviderOctree::~ViewProviderOctree()
+{
+    delete pcSensor;
+    pcRenderCallback->unref();
+}
+
+void ViewProviderOctree::attach(App::DocumentObject* pcObj)
+{
+    ViewProviderScattered::attach(pcObj);
+
+    // the callback must come before the points to get the current view volume
+    pcHighlight->insertChild(pcRenderCallback, 0);
+}
+
+void ViewProviderOctree::updateData(const App::Property* prop)
+{
+    ViewProviderScattered::updateData(prop);
+    if (prop->getTypeId() == Points::PropertyPointKernel::getClassTypeId()) {
+        // the feature has loaded an overview, refine it at the next rendering
+        hasView = false;
+    }
+}
+
+void ViewProviderOctree::cut(const std::vector<SbVec2f>&, Gui::View3DInventorViewer&)
+{
+    Base::Console().Warning("The points of an octree cannot be cut\n");
+}
+
+void ViewProviderOctree::renderCallback(void * ud, SoAction * action)
+{
+    if (!action->isOfType(SoGLRenderAction::getClassTypeId()))
+        return;
+
+    ViewProviderOctree* that = static_cast<ViewProviderOctree*>(ud);
+    SoState* state = action->getState();
+    SbViewVolume vol = SoViewVolumeElement::get(state);
+    vol.transform(SoModelMatrixElement::get(state).inverse());
+
+    // only update the nodes if the camera has noticeably moved
+    SbVec3f eye = vol.getProjectionPoint();
+    if (that->hasView) {
+        float size = std::max(vol.getWidth(), vol.getHeight());
+        if ((eye - that->lastEye).length() <= 0.01f * size &&
+            std::fabs(vol.getWidth() - that->viewVolume.getWidth()) <= 0.01f * size)
+            return;
+    }
+
+    that->viewVolume = vol;
+    that->lastEye = eye;
+    that->hasView = true;
+    if (!that->pcSensor->isScheduled())
+        that->pcSensor->schedule();
+}
+
+void ViewProviderOctree::sensorCallback(void * ud, SoSensor *)
+{
+    static_cast<ViewProviderOctree*>(ud)->updateLevelOfDetail();
+}
+
+void ViewProviderOctree::updateLevelOfDetail()
+{
+    Points::OctreeFeature* fea = static_cast<Points::OctreeFeature*>(pcObject);
+    if (!fea || fea->PointBudget.getValue() <= 0)
+        return;
+
+    try {
+        const Points::PointsOctree& tree = fea->getOctree();
+        if (!tree.isOpen())
+            return;
+
+        SbVec3f eye = lastEye;
+        const SbViewVolume& vol = viewVolume;
+        std::vector<unsigned long> nodes;
+        tree.selectNodes(Base::Vector3f(eye[0], eye[1], eye[2]),
+                         static_cast<std::size_t>(fea->PointBudget.getValue()), nodes,
+                         [&vol](const Base::BoundBox3f& box) {
+            return vol.intersect(SbBox3f(box.MinX, box.MinY, box.MinZ, box.MaxX, box.MaxY, box.MaxZ)) != FALSE;
+        });
+
+        std::size_t total = 0;
+        for (std::vector<unsigned long>::iterator it = nodes.begin(); it != nodes.end(); ++it)
+            total += tree.getNode(*it).count;
+
+        pcPointsCoord->point.setNum(static_cast<int>(total));
+        SbVec3f* pts = pcPointsCoord->point.startEditing();
+        for (std::vector<unsigned long>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+            Points::PointsOctree::PointsPtr data = tree.getPoints(*it);
+            for (std::vector<Base::Vector3f>::const_iterator jt = data->begin(); jt != data->end(); ++jt)
+                (pts++)->setValue(jt->x, jt->y, jt->z);
+        }
+        pcPointsCoord->point.finishEditing();
+        pcPoints->numPoints = static_cast<int>(total);
+    }
+    catch (const Base::Exception& e) {
+        Base::Console().Error("Failed to update points of octree: %s\n", e.what());
+    }
+}
+
+// -------------------------------------------------
+
 namespace Gui {
 /// @cond DOXERR
 PROPERTY_SOURCE_TEMPLATE(PointsGui::ViewProviderPython, PointsGui::ViewProviderScattered)
@@ -12,6 +12,7 @@
 #include "Gui/ViewProviderPythonFeature.h"
 #include "Gui/ViewProviderBuilder.h"
 #include <Inventor/SbVec2f.h>
+#include <Inventor/SbViewVolume.h>
 
 
 class SoSwitch;
@@ -21,6 +22,10 @@ class SoLocateHighlight;
 class SoCoordinate3;
 class SoNormal;
 class SoEventCallback;
+class SoCallback;
+class SoAction;
+class SoSensor;
+class SoOneShotSensor;
 
 namespace App {
     class PropertyColorList;
@@ -152,6 +157,40 @@ protected:
     SoIndexedPointSet   * pcPoints;
 };
 
+/**
+ * The ViewProviderOctree class shows the points of an out-of-core octree. While
+ * rendering it checks the camera and, if it has moved, selects the nodes of the
+ * octree to show. Nodes outside of the view volume are skipped and those closer
+ * to the camera are refined first until the point budget of the feature is used up.
+ */
+class PointsGuiExport ViewProviderOctree : public ViewProviderScattered
+{
+    PROPERTY_HEADER(PointsGui::ViewProviderOctree);
+
+public:
+    ViewProviderOctree();
+    virtual ~ViewProviderOctree();
+
+    virtual void attach(App::DocumentObject *);
+    /// Update the point representation
+    virtual void updateData(const App::Property*);
+
+protected:
+    virtual void cut(const std::vector<SbVec2f>& picked, Gui::View3DInventorViewer &Viewer);
+
+private:
+    static void renderCallback(void * ud, SoAction * action);
+    static void sensorCallback(void * ud, SoSensor * sensor);
+    void updateLevelOfDetail();
+
+private:
+    SoCallback          * pcRenderCallback;
+    SoOneShotSensor     * pcSensor;
+    SbViewVolume          viewVolume;
+    SbVec3f               lastEye;
+    bool                  hasView;
+};
+
 typedef Gui::ViewProviderPythonFeatureT<ViewProviderScattered> ViewProviderPython;
 
 } // namespace PointsGui
@@ -51,6 +51,7 @@ Sketch::Sketch()
   , RecalculateInitialSolutionWhileMovingPoint(false)
   , GCSsys(), ConstraintsCounter(0)
   , isInitMove(false), isFine(true), moveStep(0)
+  , dragTimeBudget(0), moveTimeBudget(0)
   , defaultSolver(GCS::DogLeg)
   , defaultSolverRedundant(GCS::DogLeg)
   , debugMode(GCS::Minimal)
@@ -3076,8 +3077,9 @@ int Sketch::solve(void)
     int defaultsoltype = -1;
 
     if(isInitMove){
+        // only the dragged geometry is solved again, starting from the solution of the last step
         solvername = "DogLeg"; // DogLeg is used for dragging (same as before)
-        ret = GCSsys.solve(isFine, GCS::DogLeg);
+        ret = GCSsys.solveDrag(isFine, moveTimeBudget);
     }
     else{
         switch (defaultSolver) {
@@ -3482,7 +3484,7 @@ void Sketch::resetInitMove()
     isInitMove = false;
 }
 
-int Sketch::movePoint(int geoId, PointPos pos, Base::Vector3d toPoint, bool relative)
+int Sketch::movePoint(int geoId, PointPos pos, Base::Vector3d toPoint, bool relative, bool timeLimited)
 {
     geoId = checkGeoId(geoId);
 
@@ -3490,6 +3492,10 @@ int Sketch::movePoint(int geoId, PointPos pos, Base::Vector3d toPoint, bool rela
     if (hasConflicts())
         return -1;
 
+    // only the intermediate steps of an interactive drag are limited in time, a single
+    // call and the final step when the drag ends must reach the new location
+    moveTimeBudget = (isInitMove && timeLimited) ? dragTimeBudget : 0;
+
     if (!isInitMove) {
         initMove(geoId, pos);
         initToPoint = toPoint;
@@ -107,8 +107,10 @@ public:
       * This will introduce some additional weak constraints expressing
       * a condition for satisfying the new point location!
       * The relative flag permits moving relatively to the current position
+      * If timeLimited is set a step of a drag started with initMove() may stop
+      * after the drag time budget, short of the new location
       */
-    int movePoint(int geoId, PointPos pos, Base::Vector3d toPoint, bool relative=false);
+    int movePoint(int geoId, PointPos pos, Base::Vector3d toPoint, bool relative=false, bool timeLimited=false);
 
     /// add dedicated geometry
     //@{
@@ -412,6 +414,8 @@ protected:
     bool isFine;
     Base::Vector3d initToPoint;
     double moveStep;
+    double dragTimeBudget; // time in seconds a step of a drag may take, 0 means no limit
+    double moveTimeBudget; // time budget of the current movePoint(), 0 means no limit
 
 public:
     GCS::Algorithm defaultSolver;
@@ -423,6 +427,9 @@ public:
     inline void setMaxIterRedundant(int maxiter){GCSsys.maxIterRedundant=maxiter;}
     inline void setSketchSizeMultiplier(bool mult){GCSsys.sketchSizeMultiplier=mult;}
     inline void setSketchSizeMultiplierRedundant(bool mult){GCSsys.sketchSizeMultiplierRedundant=mult;}
+    inline void setConcurrentSubsystems(bool concurrent){GCSsys.concurrentSubsystems=concurrent;}
+    inline void setSparseThreshold(int threshold){GCSsys.sparseThreshold=threshold;}
+    inline void setDragTimeBudget(double seconds){dragTimeBudget=seconds;}
     inline void setConvergence(double conv){GCSsys.convergence=conv;}
     inline void setConvergenceRedundant(double conv){GCSsys.convergenceRedundant=conv;}
     inline void setQRAlgorithm(GCS::QRAlgorithm alg){GCSsys.qrAlgorithm=alg;}
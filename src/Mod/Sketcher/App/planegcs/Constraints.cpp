@@ -24,7 +24,7 @@ Constraint::Constraint()
 {
 }
 
-void Constraint::redirectParams(MAP_pD_pD redirectionmap)
+void Constraint::redirectParams(const MAP_pD_pD &redirectionmap)
 {
     int i=0;
     for (VEC_pD::iterator param=origpvec.begin();
@@ -62,6 +62,13 @@ double Constraint::grad(double * /*param*/)
     return 0.;
 }
 
+void Constraint::gradVector(const VEC_pD &params, VEC_D &derivs)
+{
+    derivs.resize(params.size());
+    for (std::size_t i=0; i < params.size(); i++)
+        derivs[i] = grad(params[i]);
+}
+
 double Constraint::maxStep(MAP_pD_D & /*dir*/, double lim)
 {
     return lim;
@@ -195,6 +202,25 @@ double ConstraintP2PDistance::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintP2PDistance::gradVector(const VEC_pD &params, VEC_D &derivs)
+{
+    double dx = (*p1x() - *p2x());
+    double dy = (*p1y() - *p2y());
+    double d = sqrt(dx*dx + dy*dy);
+
+    derivs.resize(params.size());
+    for (std::size_t i=0; i < params.size(); i++) {
+        double *param = params[i];
+        double deriv=0.;
+        if (param == p1x()) deriv += dx/d;
+        if (param == p1y()) deriv += dy/d;
+        if (param == p2x()) deriv += -dx/d;
+        if (param == p2y()) deriv += -dy/d;
+        if (param == distance()) deriv += -1.;
+        derivs[i] = scale * deriv;
+    }
+}
+
 double ConstraintP2PDistance::maxStep(MAP_pD_D &dir, double lim)
 {
     MAP_pD_D::iterator it;
@@ -476,6 +502,30 @@ double ConstraintPointOnLine::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintPointOnLine::gradVector(const VEC_pD &params, VEC_D &derivs)
+{
+    double x0=*p0x(), x1=*p1x(), x2=*p2x();
+    double y0=*p0y(), y1=*p1y(), y2=*p2y();
+    double dx = x2-x1;
+    double dy = y2-y1;
+    double d2 = dx*dx+dy*dy;
+    double d = sqrt(d2);
+    double area = -x0*dy+y0*dx+x1*y2-x2*y1;
+
+    derivs.resize(params.size());
+    for (std::size_t i=0; i < params.size(); i++) {
+        double *param = params[i];
+        double deriv=0.;
+        if (param == p0x()) deriv += (y1-y2) / d;
+        if (param == p0y()) deriv += (x2-x1) / d ;
+        if (param == p1x()) deriv += ((y2-y0)*d + (dx/d)*area) / d2;
+        if (param == p1y()) deriv += ((x0-x2)*d + (dy/d)*area) / d2;
+        if (param == p2x()) deriv += ((y0-y1)*d - (dx/d)*area) / d2;
+        if (param == p2y()) deriv += ((x1-x0)*d - (dy/d)*area) / d2;
+        derivs[i] = scale * deriv;
+    }
+}
+
 // PointOnPerpBisector
 ConstraintPointOnPerpBisector::ConstraintPointOnPerpBisector(Point &p, Line &l)
 {
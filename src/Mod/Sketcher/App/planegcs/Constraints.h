@@ -89,7 +89,7 @@ namespace GCS
 
         inline VEC_pD params() { return pvec; }
 
-        void redirectParams(MAP_pD_pD redirectionmap);
+        void redirectParams(const MAP_pD_pD &redirectionmap);
         void revertParams();
         void setTag(int tagId) { tag = tagId; }
         int getTag() { return tag; }
@@ -101,7 +101,9 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
-        // virtual void grad(MAP_pD_D &deriv);  --> TODO: vectorized grad version
+        // Vectorized grad version, derivs[i] becomes the derivative with respect to params[i].
+        // Constraints whose partial derivatives share intermediate results should override it.
+        virtual void gradVector(const VEC_pD &params, VEC_D &derivs);
         virtual double maxStep(MAP_pD_D &dir, double lim=1.);
         // Finds first occurrence of param in pvec. This is useful to test if a constraint depends 
         // on the parameter (it may not actually depend on it, e.g. angle-via-point doesn't depend 
@@ -158,6 +160,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void gradVector(const VEC_pD &params, VEC_D &derivs);
         virtual double maxStep(MAP_pD_D &dir, double lim=1.);
     };
 
@@ -227,6 +230,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual void gradVector(const VEC_pD &params, VEC_D &derivs);
     };
 
     // PointOnPerpBisector
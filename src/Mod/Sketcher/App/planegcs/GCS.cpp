@@ -81,6 +81,10 @@
 #include <FCConfig.h>
 #include "Base/Console.h"
 
+#include <QtConcurrentMap>
+
+#include <boost/functional/hash.hpp>
+
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/connected_components.hpp>
 
@@ -295,6 +299,8 @@ System::System()
   , dogLegGaussStep(FullPivLU)
   , qrpivotThreshold(1E-13)
   , debugMode(Minimal)
+  , concurrentSubsystems(false)
+  , sparseThreshold(500)
   , LM_eps(1E-10)
   , LM_eps1(1E-80)
   , LM_tau(1E-3)
@@ -1384,22 +1390,46 @@ int System::solve(bool isFine, Algorithm alg, bool isRedundantsolving)
     if (!isInit)
         return Failed;
 
-    bool isReset = false;
-    // return success by default in order to permit coincidence constraints to be applied
-    // even if no other system has to be solved
-    int res = Success;
+    // the subsystems of different clusters have no parameters and constraints in common
+    struct ClusterSolution {
+        int cid;
+        int res;
+    };
+    std::vector<ClusterSolution> clusters;
     for (int cid=0; cid < int(subSystems.size()); cid++) {
-        if ((subSystems[cid] || subSystemsAux[cid]) && !isReset) {
-             resetToReference();
-             isReset = true;
+        if (subSystems[cid] || subSystemsAux[cid]) {
+            ClusterSolution cluster = {cid, Success};
+            clusters.push_back(cluster);
         }
+    }
+    if (!clusters.empty())
+        resetToReference();
+
+    auto solveCluster = [&](ClusterSolution& cluster) {
+        int cid = cluster.cid;
         if (subSystems[cid] && subSystemsAux[cid])
-            res = std::max(res, solve(subSystems[cid], subSystemsAux[cid], isFine, isRedundantsolving));
+            cluster.res = solve(subSystems[cid], subSystemsAux[cid], isFine, isRedundantsolving);
         else if (subSystems[cid])
-            res = std::max(res, solve(subSystems[cid], isFine, alg, isRedundantsolving));
-        else if (subSystemsAux[cid])
-            res = std::max(res, solve(subSystemsAux[cid], isFine, alg, isRedundantsolving));
-    }
+            cluster.res = solve(subSystems[cid], isFine, alg, isRedundantsolving);
+        else
+            cluster.res = solve(subSystemsAux[cid], isFine, alg, isRedundantsolving);
+    };
+
+    // keep the iteration output of the clusters apart
+    bool concurrent = concurrentSubsystems && clusters.size() > 1 && debugMode != IterationLevel;
+#ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
+    concurrent = false;
+#endif
+    if (concurrent)
+        QtConcurrent::blockingMap(clusters, solveCluster);
+    else
+        std::for_each(clusters.begin(), clusters.end(), solveCluster);
+
+    // return success by default in order to permit coincidence constraints to be applied
+    // even if no other system has to be solved
+    int res = Success;
+    for (std::vector<ClusterSolution>::const_iterator it = clusters.begin(); it != clusters.end(); ++it)
+        res = std::max(res, it->res);
     if (res == Success) {
         for (std::set<Constraint *>::const_iterator constr=redundant.begin();
              constr != redundant.end(); ++constr){
@@ -1416,6 +1446,50 @@ int System::solve(bool isFine, Algorithm alg, bool isRedundantsolving)
     return res;
 }
 
+int System::solveDrag(bool isFine, double timeBudget)
+{
+    if (!isInit)
+        return Failed;
+
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeBudget));
+
+    dragHessians.resize(subSystems.size());
+
+    // Only the clusters of the dragged geometry have an auxiliary subsystem. As the parameters
+    // are not reset to the reference the solver continues from the solution of the previous
+    // drag step, which is usually close to the new one.
+    int res = Success;
+    for (int cid=0; cid < int(subSystems.size()); cid++) {
+        if (!subSystemsAux[cid]) {
+            // The other clusters keep their values unless these don't satisfy the constraints,
+            // e.g. if the drag started on a sketch that was not solved. They are solved fully then.
+            if (subSystems[cid] && subSystems[cid]->error() > convergence)
+                res = std::max(res, solve(subSystems[cid], isFine, DogLeg));
+            continue;
+        }
+        if (subSystems[cid]) {
+            // if the time is up the parameters found so far are used as long as they satisfy
+            // the constraints, the next drag step then continues from there
+            res = std::max(res, solve_SQP(subSystems[cid], subSystemsAux[cid], dragHessians[cid], false,
+                                          timeBudget > 0. ? &deadline : nullptr));
+        }
+        else {
+            res = std::max(res, solve(subSystemsAux[cid], isFine, DogLeg));
+        }
+    }
+
+    if (res == Success) {
+        for (std::set<Constraint *>::const_iterator constr=redundant.begin();
+             constr != redundant.end(); ++constr){
+            double err = (*constr)->error();
+            if (err*err > convergence)
+                return Converged;
+        }
+    }
+    return res;
+}
+
 int System::solve(SubSystem *subsys, bool isFine, Algorithm alg, bool isRedundantsolving)
 {
     if (alg == BFGS)
@@ -1563,9 +1637,18 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
     if (xsize == 0)
         return Success;
 
+    // large subsystems are solved with sparse matrices, the factorization of the
+    // normal equations then reuses the symbolic analysis of the previous solves
+    bool sparse = sparseThreshold > 0 && xsize >= sparseThreshold;
+
     Eigen::VectorXd e(csize), e_new(csize); // vector of all function errors (every constraint is one function)
-    Eigen::MatrixXd J(csize, xsize);        // Jacobi of the subsystem
-    Eigen::MatrixXd A(xsize, xsize);
+    Eigen::MatrixXd J, A;                   // Jacobi of the subsystem and J^T J
+    SparseJacobi sparseJ;
+    SparseMatrix sparseA;
+    if (!sparse) {
+        J.resize(csize, xsize);
+        A.resize(xsize, xsize);
+    }
     Eigen::VectorXd x(xsize), h(xsize), x_new(xsize), g(xsize), diag_A(xsize);
 
     subsys->redirectParams();
@@ -1613,14 +1696,23 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         }
 
         // J^T J, J^T e
-        subsys->calcJacobi(J);;
+        if (sparse) {
+            subsys->calcJacobi(sparseJ);
+
+            sparseA = sparseJ.transpose()*sparseJ;
+            g = sparseJ.transpose()*e;
+            diag_A = sparseA.diagonal();
+        }
+        else {
+            subsys->calcJacobi(J);
 
-        A = J.transpose()*J;
-        g = J.transpose()*e;
+            A = J.transpose()*J;
+            g = J.transpose()*e;
+            diag_A = A.diagonal(); // save diagonal entries so that augmentation can be later canceled
+        }
 
         // Compute ||J^T e||_inf
         double g_inf = g.lpNorm<Eigen::Infinity>();
-        diag_A = A.diagonal(); // save diagonal entries so that augmentation can be later canceled
 
         // check for convergence
         if (g_inf <= eps1) {
@@ -1636,16 +1728,29 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         // determine increment using adaptive damping
         int k=0;
         while (k < 50) {
-            // augment normal equations A = A+uI
-            for (int i=0; i < xsize; ++i)
-                A(i,i) += mu;
+            // augment normal equations A = A+uI and solve augmented functions A*h=-g
+            bool solved = true;
+            double rel_error = 1.;
+            if (sparse) {
+                for (int i=0; i < xsize; ++i)
+                    sparseA.coeffRef(i,i) = diag_A(i) + mu;
+
+                solved = subsys->normalLDLT().factorize(sparseA);
+                if (solved) {
+                    h = subsys->normalLDLT().solve(g);
+                    rel_error = (sparseA*h - g).norm() / g.norm();
+                }
+            }
+            else {
+                for (int i=0; i < xsize; ++i)
+                    A(i,i) += mu;
 
-            //solve augmented functions A*h=-g
-            h = A.fullPivLu().solve(g);
-            double rel_error = (A*h - g).norm() / g.norm();
+                h = A.fullPivLu().solve(g);
+                rel_error = (A*h - g).norm() / g.norm();
+            }
 
             // check if solving works
-            if (rel_error < 1e-5) {
+            if (solved && rel_error < 1e-5) {
 
                 // restrict h according to maxStep
                 double scale = subsys->maxStep(h);
@@ -1689,8 +1794,10 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
 
             mu*=nu;
             nu*=2.0;
-            for (int i=0; i < xsize; ++i) // restore diagonal J^T J entries
-                A(i,i) = diag_A(i);
+            if (!sparse) {
+                for (int i=0; i < xsize; ++i) // restore diagonal J^T J entries
+                    A(i,i) = diag_A(i);
+            }
 
             k++;
         }
@@ -1756,19 +1863,42 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
         Base::Console().Log(tmp.c_str());
     }
 
+    // large subsystems are solved with sparse matrices, the gauss-newton step is then
+    // always the least norm solution and reuses the symbolic analysis of J*J^T
+    bool sparse = sparseThreshold > 0 && xsize >= sparseThreshold;
+
     Eigen::VectorXd x(xsize), x_new(xsize);
     Eigen::VectorXd fx(csize), fx_new(csize);
-    Eigen::MatrixXd Jx(csize, xsize), Jx_new(csize, xsize);
+    Eigen::MatrixXd Jx, Jx_new;
+    SparseJacobi sparseJx, sparseJx_new;
+    if (!sparse) {
+        Jx.resize(csize, xsize);
+        Jx_new.resize(csize, xsize);
+    }
     Eigen::VectorXd g(xsize), h_sd(xsize), h_gn(xsize), h_dl(xsize);
 
+    auto multiplyJx = [&](const Eigen::VectorXd &v) -> Eigen::VectorXd {
+        if (sparse)
+            return sparseJx*v;
+        return Jx*v;
+    };
+    auto multiplyJxTransposed = [&](const Eigen::VectorXd &v) -> Eigen::VectorXd {
+        if (sparse)
+            return sparseJx.transpose()*v;
+        return Jx.transpose()*v;
+    };
+
     subsys->redirectParams();
 
     double err;
     subsys->getParams(x);
     subsys->calcResidual(fx, err);
-    subsys->calcJacobi(Jx);
+    if (sparse)
+        subsys->calcJacobi(sparseJx);
+    else
+        subsys->calcJacobi(Jx);
 
-    g = Jx.transpose()*(-fx);
+    g = multiplyJxTransposed(-fx);
 
     // get the infinity norm fx_inf and g_inf
     double g_inf = g.lpNorm<Eigen::Infinity>();
@@ -1796,25 +1926,39 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
         }
         else {
             // get the steepest descent direction
-            alpha = g.squaredNorm()/(Jx*g).squaredNorm();
+            alpha = g.squaredNorm()/multiplyJx(g).squaredNorm();
             h_sd  = alpha*g;
 
             // get the gauss-newton step
             // http://forum.freecadweb.org/viewtopic.php?f=10&t=12769&start=50#p106220
             // https://forum.kde.org/viewtopic.php?f=74&t=129439#p346104
-            switch (dogLegGaussStep){
-                case FullPivLU:
-                    h_gn = Jx.fullPivLu().solve(-fx);
-                    break;
-                case LeastNormFullPivLU:
-                    h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).fullPivLu().solve(-fx);
-                    break;
-                case LeastNormLdlt:
-                    h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).ldlt().solve(-fx);
-                    break;
+            if (sparse) {
+                SparseMatrix JJt = sparseJx*sparseJx.transpose();
+                if (!subsys->leastNormLDLT().factorize(JJt)) {
+                    // J has not full row rank, regularize J*J^T slightly
+                    double shift = 1e-12 * std::max(JJt.diagonal().lpNorm<Eigen::Infinity>(), 1.);
+                    for (int i=0; i < csize; ++i)
+                        JJt.coeffRef(i,i) += shift;
+                    if (!subsys->leastNormLDLT().factorize(JJt))
+                        break;
+                }
+                h_gn = sparseJx.transpose()*subsys->leastNormLDLT().solve(-fx);
+            }
+            else {
+                switch (dogLegGaussStep){
+                    case FullPivLU:
+                        h_gn = Jx.fullPivLu().solve(-fx);
+                        break;
+                    case LeastNormFullPivLU:
+                        h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).fullPivLu().solve(-fx);
+                        break;
+                    case LeastNormLdlt:
+                        h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).ldlt().solve(-fx);
+                        break;
+                }
             }
 
-            double rel_error = (Jx*h_gn + fx).norm() / fx.norm();
+            double rel_error = (multiplyJx(h_gn) + fx).norm() / fx.norm();
             if (rel_error > 1e15)
                 break;
 
@@ -1862,20 +2006,26 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
         x_new = x + h_dl;
         subsys->setParams(x_new);
         subsys->calcResidual(fx_new, err_new);
-        subsys->calcJacobi(Jx_new);
+        if (sparse)
+            subsys->calcJacobi(sparseJx_new);
+        else
+            subsys->calcJacobi(Jx_new);
 
         // calculate the linear model and the update ratio
-        double dL = err - 0.5*(fx + Jx*h_dl).squaredNorm();
+        double dL = err - 0.5*(fx + multiplyJx(h_dl)).squaredNorm();
         double dF = err - err_new;
         double rho = dL/dF;
 
         if (dF > 0 && dL > 0) {
             x  = x_new;
-            Jx = Jx_new;
+            if (sparse)
+                sparseJx.swap(sparseJx_new);
+            else
+                Jx = Jx_new;
             fx = fx_new;
             err = err_new;
 
-            g = Jx.transpose()*(-fx);
+            g = multiplyJxTransposed(-fx);
 
             // get infinity norms
             g_inf = g.lpNorm<Eigen::Infinity>();
@@ -3461,6 +3611,13 @@ void System::extractSubsystem(SubSystem *subsys, bool isRedundantsolving)
 // The following solver variant solves a system compound of two subsystems
 // treating the first of them as of higher priority than the second
 int System::solve(SubSystem *subsysA, SubSystem *subsysB, bool /*isFine*/, bool isRedundantsolving)
+{
+    Eigen::MatrixXd B;
+    return solve_SQP(subsysA, subsysB, B, isRedundantsolving, nullptr);
+}
+
+int System::solve_SQP(SubSystem *subsysA, SubSystem *subsysB, Eigen::MatrixXd &B, bool isRedundantsolving,
+                      const std::chrono::steady_clock::time_point *deadline)
 {
     int xsizeA = subsysA->pSize();
     int xsizeB = subsysB->pSize();
@@ -3482,7 +3639,9 @@ int System::solve(SubSystem *subsysA, SubSystem *subsysB, bool /*isFine*/, bool
     }
     int xsize = plistAB.size();
 
-    Eigen::MatrixXd B = Eigen::MatrixXd::Identity(xsize, xsize);
+    // a given approximation of the Hessian is only used if it is still of the right size
+    if (B.rows() != xsize || B.cols() != xsize)
+        B = Eigen::MatrixXd::Identity(xsize, xsize);
     Eigen::MatrixXd JA(csizeA, xsize);
     Eigen::MatrixXd Y,Z;
 
@@ -3513,6 +3672,12 @@ int System::solve(SubSystem *subsysA, SubSystem *subsysB, bool /*isFine*/, bool
 
     double divergingLim = 1e6*subsysA->error() + 1e12;
 
+    // the last iterate that satisfies the constraints, used if the time runs out
+    Eigen::VectorXd xFeasible;
+    if (subsysA->error() <= smallF)
+        xFeasible = x;
+    bool timeIsUp = false;
+
     double mu = 0;
     lambda.setZero();
     for (int iter=1; iter < maxIterNumber; iter++) {
@@ -3608,6 +3773,32 @@ int System::solve(SubSystem *subsysA, SubSystem *subsysB, bool /*isFine*/, bool
             break;
         if (err > divergingLim || err != err) // check for diverging and NaN
             break;
+        if (err <= smallF)
+            xFeasible = x;
+        if (deadline && std::chrono::steady_clock::now() > *deadline) {
+            timeIsUp = true;
+            break;
+        }
+    }
+
+    if (timeIsUp && subsysA->error() > smallF) {
+        // Try to pull the parameters back onto the constraints with a few Gauss-Newton steps,
+        // if this doesn't work use the last iterate that satisfied them. So the caller gets
+        // the progress made so far and can continue from there.
+        for (int iter=0; iter < 10 && subsysA->error() > smallF; iter++) {
+            if (qp_eq(B, grad, JA, resA, xdir, Y, Z))
+                break;
+            x -= Y*resA;
+            subsysA->setParams(plistAB,x);
+            subsysB->setParams(plistAB,x);
+            subsysA->calcJacobi(plistAB,JA);
+            subsysA->calcResidual(resA);
+        }
+        if (subsysA->error() > smallF && xFeasible.size() == xsize) {
+            x = xFeasible;
+            subsysA->setParams(plistAB,x);
+            subsysB->setParams(plistAB,x);
+        }
     }
 
     int ret;
@@ -3642,6 +3833,206 @@ void System::undoSolution()
     resetToReference();
 }
 
+// A decoupled block of the Jacobian together with its QR decomposition. The blocks
+// of the last diagnosis are kept, so that a block that hasn't changed since, e.g.
+// because only another part of the sketch has been edited, is not decomposed again.
+class JacobianBlockQR
+{
+public:
+    JacobianBlockQR(const Eigen::SparseMatrix<double> &jacobi, QRAlgorithm alg, std::size_t key)
+        : J(jacobi), qrAlgorithm(alg), hash(key), isComputed(false), analysedRank(-1)
+    {
+    }
+
+    bool isEqual(const Eigen::SparseMatrix<double> &jacobi, QRAlgorithm alg) const
+    {
+        if (alg != qrAlgorithm || jacobi.rows() != J.rows() || jacobi.cols() != J.cols() ||
+            jacobi.nonZeros() != J.nonZeros())
+            return false;
+        return std::equal(J.outerIndexPtr(), J.outerIndexPtr() + J.outerSize() + 1, jacobi.outerIndexPtr()) &&
+               std::equal(J.innerIndexPtr(), J.innerIndexPtr() + J.nonZeros(), jacobi.innerIndexPtr()) &&
+               std::equal(J.valuePtr(), J.valuePtr() + J.nonZeros(), jacobi.valuePtr());
+    }
+
+    static std::size_t hashValue(const Eigen::SparseMatrix<double> &jacobi, QRAlgorithm alg)
+    {
+        std::size_t seed = 0;
+        boost::hash_combine(seed, static_cast<int>(alg));
+        boost::hash_combine(seed, jacobi.rows());
+        boost::hash_combine(seed, jacobi.cols());
+        boost::hash_range(seed, jacobi.innerIndexPtr(), jacobi.innerIndexPtr() + jacobi.nonZeros());
+        boost::hash_range(seed, jacobi.valuePtr(), jacobi.valuePtr() + jacobi.nonZeros());
+        return seed;
+    }
+
+    static std::shared_ptr<JacobianBlockQR> find(const std::multimap<std::size_t, std::shared_ptr<JacobianBlockQR> > &blocks,
+                                                 const Eigen::SparseMatrix<double> &jacobi, QRAlgorithm alg, std::size_t key)
+    {
+        auto range = blocks.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second->isEqual(jacobi, alg))
+                return it->second;
+        }
+        return std::shared_ptr<JacobianBlockQR>();
+    }
+
+    void compute()
+    {
+        if (qrAlgorithm==EigenDenseQR) {
+            qrJT.compute(Eigen::MatrixXd(J.transpose()));
+        }
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+        else if (qrAlgorithm==EigenSparseQR) {
+            Eigen::SparseMatrix<double> SJT = J.transpose();
+            SJT.makeCompressed();
+            SqrJT.compute(SJT);
+        }
+#endif
+        isComputed = true;
+    }
+
+    double maxPivot() const
+    {
+        if (qrAlgorithm==EigenDenseQR)
+            return std::abs(qrJT.maxPivot());
+        return 0.;
+    }
+
+    // The threshold of the dense QR is relative to the largest pivot of all blocks
+    int rank(double threshold, double maxpivot)
+    {
+        int result = 0;
+        if (qrAlgorithm==EigenDenseQR) {
+            double premultipliedThreshold = maxpivot * threshold;
+            for (int i=0; i < qrJT.nonzeroPivots(); i++) {
+                if (std::abs(qrJT.matrixQR().coeff(i,i)) > premultipliedThreshold)
+                    result++;
+            }
+        }
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+        else if (qrAlgorithm==EigenSparseQR) {
+            SqrJT.setPivotThreshold(threshold);
+            result = static_cast<int>(SqrJT.rank());
+        }
+#endif
+        return result;
+    }
+
+    // Determines the dependent parameters and the groups of conflicting constraints of the block
+    void analyse(int rank)
+    {
+        if (rank == analysedRank)
+            return;
+
+        analysedRank = rank;
+        dependentParams.clear();
+        conflictGroups.clear();
+
+        int paramsNum = static_cast<int>(J.cols());
+        int constrNum = static_cast<int>(J.rows());
+
+        // DETECTING CONSTRAINT SOLVER PARAMETERS
+        //
+        // NOTE: This is only true for dense QR with full pivoting, because solve parameters get reordered.
+        // I am unable to adapt it to Sparse QR. (abdullah). See:
+        //
+        // https://stackoverflow.com/questions/49009771/getting-rows-transpositions-with-sparse-qr
+        // https://forum.kde.org/viewtopic.php?f=74&t=151239
+        //
+        // R has paramsNum rows, the first "rank" rows correspond to parameters that are constraint
+        Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic> rowPermutations;
+        rowPermutations.setIdentity(paramsNum);
+
+        if (qrAlgorithm==EigenDenseQR) { // P.J.P' = Q.R see https://eigen.tuxfamily.org/dox/classEigen_1_1FullPivHouseholderQR.html
+            const MatrixIndexType rowTranspositions = qrJT.rowsTranspositions();
+
+            for (int k = 0; k < rank; ++k)
+                rowPermutations.applyTranspositionOnTheRight(k, rowTranspositions.coeff(k));
+        }
+        // For SparseQR J.P = Q.R, see https://eigen.tuxfamily.org/dox/classEigen_1_1SparseQR.html
+        // There is no rowsTransposition in this QR decomposition.
+        // TODO: This detection method won't work for SparseQR
+
+        // NOTE: Q*R = transpose(J), so the row of R corresponds to the col of J (the rows of transpose(J)).
+        // The cols of J are the parameters, the rows are the constraints.
+        std::vector<bool> indepParamCols(paramsNum, false);
+        for (int j=0; j < rank; j++)
+            indepParamCols[rowPermutations.indices()[j]] = true;
+
+        // If not independent, must be dependent
+        for (int j=0; j < paramsNum; j++) {
+            if (!indepParamCols[j])
+                dependentParams.push_back(j);
+        }
+
+        // Detecting conflicting or redundant constraints
+        if (constrNum > rank) {
+            Eigen::MatrixXd R;
+            VEC_I colsPermutation(constrNum);
+            if (qrAlgorithm==EigenDenseQR) {
+                if (constrNum >= paramsNum)
+                    R = qrJT.matrixQR().triangularView<Eigen::Upper>();
+                else
+                    R = qrJT.matrixQR().topRows(constrNum)
+                                    .triangularView<Eigen::Upper>();
+                for (int j=0; j < constrNum; j++)
+                    colsPermutation[j] = qrJT.colsPermutation().indices()[j];
+            }
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+            else if (qrAlgorithm==EigenSparseQR) {
+                if (constrNum >= paramsNum)
+                    R = SqrJT.matrixR().triangularView<Eigen::Upper>();
+                else
+                    R = SqrJT.matrixR().topRows(constrNum)
+                    .triangularView<Eigen::Upper>();
+                for (int j=0; j < constrNum; j++)
+                    colsPermutation[j] = SqrJT.colsPermutation().indices()[j];
+            }
+#endif
+
+#ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
+            LogMatrix("R", R);
+            if (qrAlgorithm == EigenDenseQR) // There is no rowsTranspositions in SparseQR
+                LogMatrix("RowTransp", qrJT.rowsTranspositions());
+#endif
+
+            for (int i=1; i < rank; i++) {
+                // eliminate non zeros above pivot
+                assert(R(i,i) != 0);
+                for (int row=0; row < i; row++) {
+                    if (R(row,i) != 0) {
+                        double coef=R(row,i)/R(i,i);
+                        R.block(row,i+1,1,constrNum-i-1) -= coef * R.block(i,i+1,1,constrNum-i-1);
+                        R(row,i) = 0;
+                    }
+                }
+            }
+            conflictGroups.resize(constrNum-rank);
+            for (int j=rank; j < constrNum; j++) {
+                for (int row=0; row < rank; row++) {
+                    if (fabs(R(row,j)) > 1e-10)
+                        conflictGroups[j-rank].push_back(colsPermutation[row]);
+                }
+                conflictGroups[j-rank].push_back(colsPermutation[j]);
+            }
+        }
+    }
+
+    Eigen::SparseMatrix<double> J; // rows are the constraints, cols are the parameters
+    QRAlgorithm qrAlgorithm;
+    std::size_t hash;
+    bool isComputed;
+
+    Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qrJT;
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+    Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > SqrJT;
+#endif
+
+    int analysedRank;
+    VEC_I dependentParams;                      // cols of J
+    std::vector<VEC_I> conflictGroups;          // rows of J
+};
+
 int System::diagnose(Algorithm alg)
 {
     // Analyses the constrainess grad of the system and provides feedback
@@ -3684,143 +4075,181 @@ int System::diagnose(Algorithm alg)
 
     // construct specific parameter list for diagonose ignoring driven constraint parameters
     GCS::VEC_pD pdiagnoselist;
+    MAP_pD_I pdiagnoseIndex;
     for (int j=0; j < int(plist.size()); j++) {
         auto result1 = std::find(std::begin(pdrivenlist), std::end(pdrivenlist), plist[j]);
 
-        if (result1 == std::end(pdrivenlist))
+        if (result1 == std::end(pdrivenlist)) {
+            pdiagnoseIndex[plist[j]] = static_cast<int>(pdiagnoselist.size());
             pdiagnoselist.push_back(plist[j]);
+        }
     }
     
     // map tag to a tag multiplicity (the number of solver constraints associated with the same tag)
     std::map< int , int> tagmultiplicity;
     
-    Eigen::MatrixXd J = Eigen::MatrixXd::Zero(clist.size(), pdiagnoselist.size());
-    
-    // The jacobian has been reduced to only contain driving constraints. Identification
+    // The jacobian is reduced to only contain driving constraints. Identification
     // of constraint indices from this reduced jacobian requires a mapping.
-    std::map<int,int> jacobianconstraintmap;
+    std::vector<int> jacobianconstraintmap;
     
-    int jacobianconstraintcount=0;
-    int allcount=0;
-    for (std::vector<Constraint *>::iterator constr=clist.begin(); constr != clist.end(); ++constr) {
-        (*constr)->revertParams();
-        ++allcount;        
-        if ((*constr)->getTag() >= 0 && (*constr)->isDriving()) {
-            jacobianconstraintcount++;
-            for (int j=0; j < int(pdiagnoselist.size()); j++) {
-                    J(jacobianconstraintcount-1,j) = (*constr)->grad(pdiagnoselist[j]);
-            }
-            
+    for (std::size_t i=0; i < clist.size(); i++) {
+        Constraint *constr = clist[i];
+        constr->revertParams();
+        if (constr->getTag() >= 0 && constr->isDriving()) {
             // parallel processing: create tag multiplicity map
-            if(tagmultiplicity.find((*constr)->getTag()) == tagmultiplicity.end())
-                tagmultiplicity[(*constr)->getTag()] = 0;
+            if(tagmultiplicity.find(constr->getTag()) == tagmultiplicity.end())
+                tagmultiplicity[constr->getTag()] = 0;
             else
-                tagmultiplicity[(*constr)->getTag()]++;
+                tagmultiplicity[constr->getTag()]++;
             
-            jacobianconstraintmap[jacobianconstraintcount-1] = allcount-1;
+            jacobianconstraintmap.push_back(static_cast<int>(i));
         }
     }
+    int jacobianconstraintcount = static_cast<int>(jacobianconstraintmap.size());
 
-#ifdef EIGEN_SPARSEQR_COMPATIBLE
-    Eigen::SparseMatrix<double> SJ;
-
-    if(qrAlgorithm==EigenSparseQR){
-        // this creation is not optimized (done using triplets)
-        // however the time this takes is negligible compared to the
-        // time the QR decomposition itself takes
-        SJ = J.sparseView();
-        SJ.makeCompressed();
-    }
-
-    Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > SqrJT;
-#else
+#ifndef EIGEN_SPARSEQR_COMPATIBLE
     if(qrAlgorithm==EigenSparseQR){
         Base::Console().Warning("SparseQR not supported by you current version of Eigen. It requires Eigen 3.2.2 or higher. Falling back to Dense QR\n");
         qrAlgorithm=EigenDenseQR;
     }
 #endif
 
-#ifdef _GCS_DEBUG
-    LogMatrix("J",J);
-#endif
-
-    Eigen::MatrixXd R;
-
-#ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
-    Eigen::MatrixXd Q; // Obtaining the Q matrix with Sparse QR is buggy, see comments below
-    Eigen::MatrixXd R2; // Intended for a trapezoidal matrix, where R is the top triangular matrix of the R2 trapezoidal matrix
-#endif
-
-    int paramsNum = 0;
-    int constrNum = 0;
+    // The Jacobian is block diagonal with a block for every decoupled part of the sketch,
+    // the QR decomposition of J is the combination of the decompositions of the blocks.
+    // Parameters that aren't used by any driving constraint end up in a block without rows.
+    int paramsNum = static_cast<int>(pdiagnoselist.size());
+    int constrNum = jacobianconstraintcount;
     int rank = 0;
-    Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qrJT;
-
-    if(qrAlgorithm==EigenDenseQR){
-        if (J.rows() > 0) {
-            qrJT.compute(J.topRows(jacobianconstraintcount).transpose());
-            //Eigen::MatrixXd Q = qrJT.matrixQ ();
+    std::vector<Constraint *> conflictingConstraints; // constraints of blocks without parameters
+    std::set<int> depParamCols;
+    std::vector< std::vector<Constraint *> > conflictGroups;
+
+    if (!clist.empty()) {
+        Graph g;
+        for (int i=0; i < paramsNum + jacobianconstraintcount; i++)
+            boost::add_vertex(g);
+
+        std::vector<VEC_I> jacobianparams(jacobianconstraintcount);
+        for (int i=0; i < jacobianconstraintcount; i++) {
+            VEC_pD &cparams = c2p[clist[jacobianconstraintmap[i]]];
+            for (VEC_pD::const_iterator param=cparams.begin(); param != cparams.end(); ++param) {
+                MAP_pD_I::const_iterator it = pdiagnoseIndex.find(*param);
+                if (it != pdiagnoseIndex.end()) {
+                    jacobianparams[i].push_back(it->second);
+                    boost::add_edge(paramsNum + i, it->second, g);
+                }
+            }
+        }
 
-            paramsNum = qrJT.rows();
-            constrNum = qrJT.cols();
-            qrJT.setThreshold(qrpivotThreshold);
-            rank = qrJT.rank();
+        VEC_I components(boost::num_vertices(g));
+        int componentsSize = 0;
+        if (!components.empty())
+            componentsSize = boost::connected_components(g, &components[0]);
+
+        // rows and cols of the blocks, in the order of the full Jacobian
+        std::vector<VEC_I> blockParams(componentsSize), blockConstraints(componentsSize);
+        VEC_I localIndex(paramsNum); // col of a parameter in its block
+        for (int i=0; i < paramsNum; i++) {
+            VEC_I &cols = blockParams[components[i]];
+            localIndex[i] = static_cast<int>(cols.size());
+            cols.push_back(i);
+        }
+        for (int i=0; i < jacobianconstraintcount; i++)
+            blockConstraints[components[paramsNum + i]].push_back(i);
+
+        // set up the blocks and look for the same blocks in the last diagnosis
+        std::multimap<std::size_t, std::shared_ptr<JacobianBlockQR> > usedBlocks;
+        std::vector<std::shared_ptr<JacobianBlockQR> > blocks(componentsSize), newBlocks;
+        for (int cid=0; cid < componentsSize; cid++) {
+            const VEC_I &rows = blockConstraints[cid];
+            const VEC_I &cols = blockParams[cid];
+            if (rows.empty()) {
+                // parameters that are not constrained at all
+                depParamCols.insert(cols.begin(), cols.end());
+                continue;
+            }
+            if (cols.empty()) {
+                // a constraint without unknown parameters, its row of J is zero
+                conflictingConstraints.push_back(clist[jacobianconstraintmap[rows.front()]]);
+                continue;
+            }
 
-            if (constrNum >= paramsNum)
-                R = qrJT.matrixQR().triangularView<Eigen::Upper>();
-            else
-                R = qrJT.matrixQR().topRows(constrNum)
-                                .triangularView<Eigen::Upper>();
+            std::vector<Eigen::Triplet<double> > triplets;
+            for (int r=0; r < int(rows.size()); r++) {
+                Constraint *constr = clist[jacobianconstraintmap[rows[r]]];
+                const VEC_I &cparams = jacobianparams[rows[r]];
+                for (VEC_I::const_iterator j=cparams.begin(); j != cparams.end(); ++j) {
+                    double deriv = constr->grad(pdiagnoselist[*j]);
+                    if (deriv != 0.)
+                        triplets.push_back(Eigen::Triplet<double>(r, localIndex[*j], deriv));
+                }
+            }
+            Eigen::SparseMatrix<double> J(rows.size(), cols.size());
+            // the params of a constraint may contain the same parameter twice, its derivative is only set once
+            J.setFromTriplets(triplets.begin(), triplets.end(), [](const double &a, const double &) { return a; });
+            J.makeCompressed();
 
-#ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
-            R2 = qrJT.matrixQR();
-            Q = qrJT.matrixQ();
+#ifdef _GCS_DEBUG
+            LogMatrix("J",Eigen::MatrixXd(J));
 #endif
+
+            std::size_t key = JacobianBlockQR::hashValue(J, qrAlgorithm);
+            std::shared_ptr<JacobianBlockQR> block = JacobianBlockQR::find(usedBlocks, J, qrAlgorithm, key);
+            if (!block) {
+                block = JacobianBlockQR::find(qrCache, J, qrAlgorithm, key);
+                if (!block) {
+                    block = std::make_shared<JacobianBlockQR>(J, qrAlgorithm, key);
+                    newBlocks.push_back(block);
+                }
+                usedBlocks.insert(std::make_pair(key, block));
+            }
+            blocks[cid] = block;
         }
-    }
-#ifdef EIGEN_SPARSEQR_COMPATIBLE
-    else if(qrAlgorithm==EigenSparseQR){
-        if (SJ.rows() > 0) {
-            auto SJT = SJ.topRows(jacobianconstraintcount).transpose();
-            if (SJT.rows() > 0 && SJT.cols() > 0) {
-                SqrJT.compute(SJT);
-                // Do not ask for Q Matrix!!
-                // At Eigen 3.2 still has a bug that this only works for square matrices
-                // if enabled it will crash
-                #ifdef SPARSE_Q_MATRIX
-                Q = SqrJT.matrixQ();
-                //Q = QS;
-                #endif
-
-                paramsNum = SqrJT.rows();
-                constrNum = SqrJT.cols();
-                SqrJT.setPivotThreshold(qrpivotThreshold);
-                rank = SqrJT.rank();
 
-                if (constrNum >= paramsNum)
-                    R = SqrJT.matrixR().triangularView<Eigen::Upper>();
-                else
-                    R = SqrJT.matrixR().topRows(constrNum)
-                    .triangularView<Eigen::Upper>();
+        // the blocks that have changed since the last diagnosis are decomposed in parallel
+        QtConcurrent::blockingMap(newBlocks, [](std::shared_ptr<JacobianBlockQR> &block) {
+            block->compute();
+        });
+        qrCache.swap(usedBlocks);
 
-                #ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
-                R2 = SqrJT.matrixR();
-                #endif
-            }
-            else {
-                paramsNum = SJT.rows();
-                constrNum = SJT.cols();
+        double maxpivot = 0.;
+        for (int cid=0; cid < componentsSize; cid++) {
+            if (blocks[cid])
+                maxpivot = std::max(maxpivot, blocks[cid]->maxPivot());
+        }
+
+        for (int cid=0; cid < componentsSize; cid++) {
+            const std::shared_ptr<JacobianBlockQR> &block = blocks[cid];
+            if (!block)
+                continue;
+
+            int blockRank = block->rank(qrpivotThreshold, maxpivot);
+            block->analyse(blockRank);
+            rank += blockRank;
+
+            const VEC_I &rows = blockConstraints[cid];
+            const VEC_I &cols = blockParams[cid];
+            for (VEC_I::const_iterator j=block->dependentParams.begin(); j != block->dependentParams.end(); ++j)
+                depParamCols.insert(cols[*j]);
+            for (std::vector<VEC_I>::const_iterator group=block->conflictGroups.begin();
+                 group != block->conflictGroups.end(); ++group) {
+                std::vector<Constraint *> constrs;
+                for (VEC_I::const_iterator r=group->begin(); r != group->end(); ++r)
+                    constrs.push_back(clist[jacobianconstraintmap[rows[*r]]]);
+                conflictGroups.push_back(constrs);
             }
         }
+        for (std::vector<Constraint *>::const_iterator constr=conflictingConstraints.begin();
+             constr != conflictingConstraints.end(); ++constr)
+            conflictGroups.push_back(std::vector<Constraint *>(1, *constr));
     }
-#endif
 
     if(debugMode==IterationLevel) {
         std::stringstream stream;
 
         stream  << (qrAlgorithm==EigenSparseQR?"EigenSparseQR":(qrAlgorithm==EigenDenseQR?"DenseQR":""));
 
-        if (J.rows() > 0) {
+        if (!clist.empty()) {
             stream
 #ifdef EIGEN_SPARSEQR_COMPATIBLE
                     << ", Threads: " << Eigen::nbThreads()
@@ -3831,7 +4260,8 @@ int System::diagnose(Algorithm alg)
                     << ", Pivot Threshold: " << qrpivotThreshold
                     << ", Params: " << paramsNum
                     << ", Constr: " << constrNum
-                    << ", Rank: "   << rank;
+                    << ", Rank: "   << rank
+                    << ", Cached QR blocks: " << qrCache.size();
         }
         else {
             stream
@@ -3850,126 +4280,16 @@ int System::diagnose(Algorithm alg)
 
     }
 
-    if (J.rows() > 0) {
-#ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
-        LogMatrix("R", R);
-
-        LogMatrix("R2", R2);
-
-        if(qrAlgorithm == EigenDenseQR){ // There is no rowsTranspositions in SparseQR. obtaining Q is buggy in Eigen for SparseQR
-            LogMatrix("Q", Q);
-            LogMatrix("RowTransp", qrJT.rowsTranspositions());
-        }
-#ifdef SPARSE_Q_MATRIX
-        else if(qrAlgorithm == EigenSparseQR) {
-            LogMatrix("Q", Q);
-        }
-#endif
-#endif
-
-        // DETECTING CONSTRAINT SOLVER PARAMETERS
-        //
-        // NOTE: This is only true for dense QR with full pivoting, because solve parameters get reordered.
-        // I am unable to adapt it to Sparse QR. (abdullah). See:
-        //
-        // https://stackoverflow.com/questions/49009771/getting-rows-transpositions-with-sparse-qr
-        // https://forum.kde.org/viewtopic.php?f=74&t=151239
-        //
-        // R (original version, not R here which is trimmed to not have empty rows)
-        // has paramsNum rows, the first "rank" rows correspond to parameters that are constraint
-
-        // Calculate the Permutation matrix from the Transposition matrix
-        Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic> rowPermutations;
-
-        rowPermutations.setIdentity(paramsNum);
-
-        if(qrAlgorithm==EigenDenseQR){ // P.J.P' = Q.R see https://eigen.tuxfamily.org/dox/classEigen_1_1FullPivHouseholderQR.html
-            const MatrixIndexType rowTranspositions = qrJT.rowsTranspositions();
-
-            for(int k = 0; k < rank; ++k)
-                rowPermutations.applyTranspositionOnTheRight(k, rowTranspositions.coeff(k));
-        }
-#ifdef EIGEN_SPARSEQR_COMPATIBLE
-        else if(qrAlgorithm==EigenSparseQR){ 
-            // J.P = Q.R, see https://eigen.tuxfamily.org/dox/classEigen_1_1SparseQR.html
-            // There is no rowsTransposition in this QR decomposition.
-            // TODO: This detection method won't work for SparseQR
-        }
-
-#endif
-
+    if (!clist.empty()) {
 #ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
         std::stringstream stream;
-#endif
-
-// params (in the order of J) shown as independent from QR
-        std::set<int> indepParamCols;
-        std::set<int> depParamCols;
-
-        for (int j=0; j < rank; j++) {
-
-             int origRow = rowPermutations.indices()[j];
-
-             indepParamCols.insert(origRow);
-
-             // NOTE: Q*R = transpose(J), so the row of R corresponds to the col of J (the rows of transpose(J)).
-             // The cols of J are the parameters, the rows are the constraints.
-#ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
-             stream << "R row " << j << " = J col " << origRow << std::endl;
-#endif
-        }
-
-#ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
-        std::string tmp = stream.str();
-
-        LogString(tmp);
-#endif
-
-        // If not independent, must be dependent
-        for(int j=0; j < paramsNum; j++) {
-            auto result = std::find(indepParamCols.begin(), indepParamCols.end(), j);
-            if(result == indepParamCols.end()) {
-                depParamCols.insert(j);
-            }
-        }
-
-        // Last (NumParams-rank) rows of Q construct the dependent part of J
-        // in conjuntion with the R matrix
-        // Last (NumParams-rank) cols of Q never contribute as R is zero after the rank
-        /*std::set<int> associatedParamCols;
-        for(int i = rank; i < paramsNum; i++) {
-            for(int j = 0; j < rank; j++) {
-                if(fabs(Q(i,j))>1e-10) {
-                    for(int k = j; k < constrNum; k++) {
-                        if(fabs(R(j,k))>1e-10) {
-                            associatedParamCols.insert(k);
-                        }
-                    }
-                }
-            }
-        }
-
-        for( auto param : associatedParamCols) {
-            auto pos = indepParamCols.find(rowPermutations.indices()[param]);
-
-            if(pos!=indepParamCols.end()) {
-                indepParamCols.erase(pos);
-            }
-        }*/
-#ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
-        stream.flush();
-
-        stream << "Indep params: [";
-        for(auto indep :indepParamCols)
-            stream << indep;
-        stream << "]" << std::endl;
 
         stream << "Dep params: [";
         for(auto dep :depParamCols)
             stream << dep;
         stream << "]" << std::endl;
 
-        tmp = stream.str();
+        std::string tmp = stream.str();
         LogString(tmp);
 #endif
         for( auto param : depParamCols) {
@@ -3978,45 +4298,6 @@ int System::diagnose(Algorithm alg)
 
         // Detecting conflicting or redundant constraints
         if (constrNum > rank) { // conflicting or redundant constraints
-            for (int i=1; i < rank; i++) {
-                // eliminate non zeros above pivot
-                assert(R(i,i) != 0);
-                for (int row=0; row < i; row++) {
-                    if (R(row,i) != 0) {
-                        double coef=R(row,i)/R(i,i);
-                        R.block(row,i+1,1,constrNum-i-1) -= coef * R.block(i,i+1,1,constrNum-i-1);
-                        R(row,i) = 0;
-                    }
-                }
-            }
-            std::vector< std::vector<Constraint *> > conflictGroups(constrNum-rank);
-            for (int j=rank; j < constrNum; j++) {
-                for (int row=0; row < rank; row++) {
-                    if (fabs(R(row,j)) > 1e-10) {
-                        int origCol = 0;
-
-                        if(qrAlgorithm==EigenDenseQR)
-                            origCol=qrJT.colsPermutation().indices()[row];
-#ifdef EIGEN_SPARSEQR_COMPATIBLE
-                        else if(qrAlgorithm==EigenSparseQR)
-                            origCol=SqrJT.colsPermutation().indices()[row];
-#endif
-                        //conflictGroups[j-rank].push_back(clist[origCol]);
-                        conflictGroups[j-rank].push_back(clist[jacobianconstraintmap[origCol]]);
-                    }
-                }
-                int origCol = 0;
-
-                if(qrAlgorithm==EigenDenseQR)
-                    origCol=qrJT.colsPermutation().indices()[j];
-
-#ifdef EIGEN_SPARSEQR_COMPATIBLE
-                else if(qrAlgorithm==EigenSparseQR)
-                    origCol=SqrJT.colsPermutation().indices()[j];
-#endif
-                //conflictGroups[j-rank].push_back(clist[origCol]);
-                conflictGroups[j-rank].push_back(clist[jacobianconstraintmap[origCol]]);
-            }
             
 #ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
 
@@ -4192,6 +4473,7 @@ void System::clearSubSystems()
     free(subSystemsAux);
     subSystems.clear();
     subSystemsAux.clear();
+    dragHessians.clear();
 }
 
 double lineSearch(SubSystem *subsys, Eigen::VectorXd &xdir)
@@ -6,6 +6,8 @@
 #ifndef PLANEGCS_GCS_H
 #define PLANEGCS_GCS_H
 
+#include <chrono>
+#include <memory>
 #include "SubSystem.h"
 #include <boost/concept_check.hpp>
 #include <boost/graph/graph_concepts.hpp>
@@ -22,6 +24,8 @@ namespace GCS
     // Solver
     ///////////////////////////////////////
 
+    class JacobianBlockQR;
+
     enum SolveStatus {
         Success = 0,        // Found a solution zeroing the error function
         Converged = 1,      // Found a solution minimizing the error function
@@ -82,6 +86,14 @@ namespace GCS
         std::set<Constraint *> redundant;
         VEC_I conflictingTags, redundantTags;
 
+        // QR decompositions of the decoupled blocks of the Jacobian from the last diagnosis,
+        // blocks that are still the same are not decomposed again
+        std::multimap<std::size_t, std::shared_ptr<JacobianBlockQR> > qrCache;
+
+        // BFGS approximations of the Hessians of the dragged clusters, they are kept from one
+        // drag step to the next one as long as the subsystems stay the same
+        std::vector<Eigen::MatrixXd> dragHessians;
+
         bool hasUnknowns;  // if plist is filled with the unknown parameters
         bool hasDiagnosis; // if dofs, conflictingTags, redundantTags are up to date
         bool isInit;       // if plists, clists, reductionmaps are up to date
@@ -89,6 +101,8 @@ namespace GCS
         int solve_BFGS(SubSystem *subsys, bool isFine=true, bool isRedundantsolving=false);
         int solve_LM(SubSystem *subsys, bool isRedundantsolving=false);
         int solve_DL(SubSystem *subsys, bool isRedundantsolving=false);
+        int solve_SQP(SubSystem *subsysA, SubSystem *subsysB, Eigen::MatrixXd &B, bool isRedundantsolving,
+                      const std::chrono::steady_clock::time_point *deadline);
 
         #ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
         void extractSubsystem(SubSystem *subsys, bool isRedundantsolving);
@@ -104,6 +118,8 @@ namespace GCS
         DogLegGaussStep dogLegGaussStep;
         double qrpivotThreshold;
         DebugMode debugMode;
+        bool concurrentSubsystems; // if true the independent subsystems are solved on the global thread pool
+        int sparseThreshold; // LM and DogLeg use sparse matrices for subsystems with at least this number of parameters, 0 disables it
         double LM_eps;
         double LM_eps1;          
         double LM_tau;
@@ -245,6 +261,12 @@ namespace GCS
         int solve(VEC_pD &params, bool isFine=true, Algorithm alg=DogLeg, bool isRedundantsolving=false);
         int solve(SubSystem *subsys, bool isFine=true, Algorithm alg=DogLeg, bool isRedundantsolving=false);
         int solve(SubSystem *subsysA, SubSystem *subsysB, bool isFine=true, bool isRedundantsolving=false);
+        // Solves only the clusters that contain constraints with negative tags, i.e. the geometry
+        // that is dragged, starting from the current parameter values instead of the reference.
+        // The other clusters keep their values as long as they satisfy their constraints. After
+        // timeBudget seconds (0 means no limit) the best solution so far that satisfies the
+        // constraints is returned.
+        int solveDrag(bool isFine=true, double timeBudget=0.);
 
         void applySolution();
         void undoSolution();
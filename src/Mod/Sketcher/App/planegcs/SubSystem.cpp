@@ -5,6 +5,7 @@
 
 #include <iostream>
 #include <iterator>
+#include <algorithm>
 #include "SubSystem.h"
 
 namespace GCS
@@ -258,6 +259,38 @@ void SubSystem::calcJacobi(Eigen::MatrixXd &jacobi)
     calcJacobi(plist, jacobi);
 }
 
+void SubSystem::calcJacobi(SparseJacobi &jacobi)
+{
+    // the sparsity pattern is given by the parameters of each constraint, it
+    // is set up only once and afterwards just the values are overwritten
+    int nonZeros=0;
+    for (std::map<Constraint *,VEC_pD >::const_iterator it=c2p.begin(); it != c2p.end(); ++it)
+        nonZeros += static_cast<int>(it->second.size());
+
+    if (jacobi.rows() != csize || jacobi.cols() != psize ||
+        jacobi.nonZeros() != nonZeros || !jacobi.isCompressed()) {
+        std::vector<Eigen::Triplet<double> > triplets;
+        triplets.reserve(nonZeros);
+        for (int i=0; i < csize; i++) {
+            const VEC_pD &cparams = c2p[clist[i]];
+            for (VEC_pD::const_iterator p=cparams.begin(); p != cparams.end(); ++p)
+                triplets.push_back(Eigen::Triplet<double>(i, static_cast<int>(*p - &pvals[0]), 0.));
+        }
+        jacobi.resize(csize, psize);
+        jacobi.setFromTriplets(triplets.begin(), triplets.end());
+    }
+
+    // c2p holds the parameters of a constraint in the order of pvals and thus
+    // in the same order as the entries of a row
+    VEC_D derivs;
+    double *values = jacobi.valuePtr();
+    const SparseJacobi::StorageIndex *rowStart = jacobi.outerIndexPtr();
+    for (int i=0; i < csize; i++) {
+        clist[i]->gradVector(c2p[clist[i]], derivs);
+        std::copy(derivs.begin(), derivs.end(), values + rowStart[i]);
+    }
+}
+
 void SubSystem::calcGrad(VEC_pD &params, Eigen::VectorXd &grad)
 {
     assert(grad.size() == int(params.size()));
@@ -281,6 +314,17 @@ void SubSystem::calcGrad(Eigen::VectorXd &grad)
     calcGrad(plist, grad);
 }
 
+bool SparseLDLT::factorize(const SparseMatrix &A)
+{
+    if (A.rows() != rows || A.nonZeros() != nonZeros) {
+        ldlt.analyzePattern(A);
+        rows = A.rows();
+        nonZeros = A.nonZeros();
+    }
+    ldlt.factorize(A);
+    return ldlt.info() == Eigen::Success;
+}
+
 double SubSystem::maxStep(VEC_pD &params, Eigen::VectorXd &xdir)
 {
     assert(xdir.size() == int(params.size()));
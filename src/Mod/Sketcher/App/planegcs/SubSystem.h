@@ -10,11 +10,28 @@
 #undef max
 
 #include <Eigen/Core>
+#include <Eigen/Sparse>
 #include "Constraints.h"
 
 namespace GCS
 {
 
+    typedef Eigen::SparseMatrix<double> SparseMatrix;
+    typedef Eigen::SparseMatrix<double, Eigen::RowMajor> SparseJacobi;
+
+    // LDLT factorization of sparse symmetric matrices that keeps the symbolic
+    // analysis as long as the sparsity pattern doesn't change
+    class SparseLDLT
+    {
+    private:
+        Eigen::SimplicialLDLT<SparseMatrix> ldlt;
+        SparseMatrix::Index rows, nonZeros;
+    public:
+        SparseLDLT() : rows(-1), nonZeros(-1) {}
+        bool factorize(const SparseMatrix &A);
+        Eigen::VectorXd solve(const Eigen::VectorXd &b) const { return ldlt.solve(b); }
+    };
+
     class SubSystem
     {
     private:
@@ -26,6 +43,7 @@ namespace GCS
 //        JacobianMatrix jacobi;  // jacobi matrix of the residuals
         std::map<Constraint *,VEC_pD > c2p; // constraint to parameter adjacency list
         std::map<double *,std::vector<Constraint *> > p2c; // parameter to constraint adjacency list
+        SparseLDLT ldltJtJ, ldltJJt; // cached factorizations of the normal equations
         void initialize(VEC_pD &params, MAP_pD_pD &reductionmap); // called by the constructors
     public:
         SubSystem(std::vector<Constraint *> &clist_, VEC_pD &params);
@@ -54,9 +72,14 @@ namespace GCS
         void calcResidual(Eigen::VectorXd &r, double &err);
         void calcJacobi(VEC_pD &params, Eigen::MatrixXd &jacobi);
         void calcJacobi(Eigen::MatrixXd &jacobi);
+        void calcJacobi(SparseJacobi &jacobi);
         void calcGrad(VEC_pD &params, Eigen::VectorXd &grad);
         void calcGrad(Eigen::VectorXd &grad);
 
+        // factorizations of J^T*J and J*J^T that are reused by the following iterations and solves
+        SparseLDLT &normalLDLT() { return ldltJtJ; }
+        SparseLDLT &leastNormLDLT() { return ldltJJt; }
+
         double maxStep(VEC_pD &params, Eigen::VectorXd &xdir);
         double maxStep(Eigen::VectorXd &xdir);
 
@@ -38,6 +38,8 @@
 #define QR_PIVOT_THRESHOLD 1E-13    // under this value a Jacobian value is regarded as zero
 #define DEFAULT_SOLVER_DEBUG 1      // None=0, Minimal=1, IterationLevel=2
 #define MAX_ITER_MULTIPLIER false
+#define CONCURRENT_SUBSYSTEMS false
+#define SPARSE_THRESHOLD 500
 #define DEFAULT_DOGLEG_GAUSS_STEP 0   // FullPivLU = 0, LeastNormFullPivLU = 1, LeastNormLdlt = 2
 
 using namespace SketcherGui;
@@ -59,6 +61,8 @@ TaskSketcherSolverAdvanced::TaskSketcherSolverAdvanced(ViewProviderSketch *sketc
     ui->comboBoxDogLegGaussStep->onRestore();
     ui->spinBoxMaxIter->onRestore();
     ui->checkBoxSketchSizeMultiplier->onRestore();
+    ui->checkBoxConcurrentSubsystems->onRestore();
+    ui->spinBoxSparseThreshold->onRestore();
     ui->lineEditConvergence->onRestore();
     ui->comboBoxQRMethod->onRestore();
     ui->lineEditQRPivotThreshold->onRestore();
@@ -408,6 +412,18 @@ void TaskSketcherSolverAdvanced::on_checkBoxSketchSizeMultiplier_stateChanged(in
     }
 }
 
+void TaskSketcherSolverAdvanced::on_checkBoxConcurrentSubsystems_stateChanged(int state)
+{
+    ui->checkBoxConcurrentSubsystems->onSave();
+    sketchView->getSketchObject()->getSolvedSketch().setConcurrentSubsystems(state==Qt::Checked);
+}
+
+void TaskSketcherSolverAdvanced::on_spinBoxSparseThreshold_valueChanged(int i)
+{
+    ui->spinBoxSparseThreshold->onSave();
+    sketchView->getSketchObject()->getSolvedSketch().setSparseThreshold(i);
+}
+
 void TaskSketcherSolverAdvanced::on_lineEditQRPivotThreshold_editingFinished()
 {
     QString text = ui->lineEditQRPivotThreshold->text();
@@ -519,6 +535,8 @@ void TaskSketcherSolverAdvanced::on_pushButtonDefaults_clicked(bool checked/* =
     hGrp->SetInt("RedundantSolverMaxIterations",MAX_ITER);
     hGrp->SetBool("SketchSizeMultiplier",MAX_ITER_MULTIPLIER);
     hGrp->SetBool("RedundantSketchSizeMultiplier",MAX_ITER_MULTIPLIER);
+    hGrp->SetBool("ConcurrentSubsystems",CONCURRENT_SUBSYSTEMS);
+    hGrp->SetInt("SparseThreshold",SPARSE_THRESHOLD);
     hGrp->SetASCII("Convergence",QString::number(CONVERGENCE).toUtf8());
     hGrp->SetASCII("RedundantConvergence",QString::number(CONVERGENCE).toUtf8());
     hGrp->SetInt("QRMethod",DEFAULT_QRSOLVER);
@@ -529,6 +547,8 @@ void TaskSketcherSolverAdvanced::on_pushButtonDefaults_clicked(bool checked/* =
     ui->comboBoxDogLegGaussStep->onRestore();
     ui->spinBoxMaxIter->onRestore();
     ui->checkBoxSketchSizeMultiplier->onRestore();
+    ui->checkBoxConcurrentSubsystems->onRestore();
+    ui->spinBoxSparseThreshold->onRestore();
     ui->lineEditConvergence->onRestore();
     ui->comboBoxQRMethod->onRestore();
     ui->lineEditQRPivotThreshold->onRestore();
@@ -552,6 +572,8 @@ void TaskSketcherSolverAdvanced::updateSketchObject(void)
     sketchView->getSketchObject()->getSolvedSketch().setConvergenceRedundant(ui->lineEditRedundantConvergence->text().toDouble());
     sketchView->getSketchObject()->getSolvedSketch().setConvergence(ui->lineEditConvergence->text().toDouble());
     sketchView->getSketchObject()->getSolvedSketch().setSketchSizeMultiplier(ui->checkBoxSketchSizeMultiplier->isChecked());
+    sketchView->getSketchObject()->getSolvedSketch().setConcurrentSubsystems(ui->checkBoxConcurrentSubsystems->isChecked());
+    sketchView->getSketchObject()->getSolvedSketch().setSparseThreshold(ui->spinBoxSparseThreshold->value());
     sketchView->getSketchObject()->getSolvedSketch().setMaxIter(ui->spinBoxMaxIter->value());
     sketchView->getSketchObject()->getSolvedSketch().defaultSolver=(GCS::Algorithm) ui->comboBoxDefaultSolver->currentIndex();
     sketchView->getSketchObject()->getSolvedSketch().setDogLegGaussStep((GCS::DogLegGaussStep) ui->comboBoxDogLegGaussStep->currentIndex());
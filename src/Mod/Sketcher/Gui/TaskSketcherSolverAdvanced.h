@@ -33,6 +33,8 @@ private Q_SLOTS:
     void on_comboBoxDogLegGaussStep_currentIndexChanged(int index);    
     void on_spinBoxMaxIter_valueChanged(int i);
     void on_checkBoxSketchSizeMultiplier_stateChanged(int state);    
+    void on_checkBoxConcurrentSubsystems_stateChanged(int state);
+    void on_spinBoxSparseThreshold_valueChanged(int i);
     void on_lineEditConvergence_editingFinished();
     void on_comboBoxQRMethod_currentIndexChanged(int index);
     void on_lineEditQRPivotThreshold_editingFinished();
@@ -1129,7 +1129,7 @@ bool ViewProviderSketch::mouseMove(const SbVec2s &cursorPos, Gui::View3DInventor
                 getSketchObject()->getGeoVertexIndex(edit->DragPoint, GeoId, PosId);
                 Base::Vector3d vec(x,y,0);
                 if (GeoId != Sketcher::Constraint::GeoUndef && PosId != Sketcher::none) {
-                    if (getSketchObject()->getSolvedSketch().movePoint(GeoId, PosId, vec, false) == 0) {
+                    if (getSketchObject()->getSolvedSketch().movePoint(GeoId, PosId, vec, false, true) == 0) {
                         setPositionText(Base::Vector2d(x,y));
                         draw(true,false);
                         signalSolved(QString("Solved in %1 sec").arg(getSketchObject()->getSolvedSketch().SolveTime));
@@ -1143,7 +1143,7 @@ bool ViewProviderSketch::mouseMove(const SbVec2s &cursorPos, Gui::View3DInventor
         case STATUS_SKETCH_DragCurve:
             if (edit->DragCurve != -1) {
                 Base::Vector3d vec(x-xInit,y-yInit,0);
-                if (getSketchObject()->getSolvedSketch().movePoint(edit->DragCurve, Sketcher::none, vec, relative) == 0) {
+                if (getSketchObject()->getSolvedSketch().movePoint(edit->DragCurve, Sketcher::none, vec, relative, true) == 0) {
                     setPositionText(Base::Vector2d(x,y));
                     draw(true,false);
                     signalSolved(QString("Solved in %1 sec").arg(getSketchObject()->getSolvedSketch().SolveTime));
@@ -5689,6 +5689,8 @@ bool ViewProviderSketch::setEdit(int ModNum)
     ParameterGrp::handle hGrp2 = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Sketcher");
 
     getSketchObject()->getSolvedSketch().RecalculateInitialSolutionWhileMovingPoint = hGrp2->GetBool("RecalculateInitialSolutionWhileDragging",true);
+    // Time in milliseconds the solver may spend on one drag step, enough to keep up with 60 frames per second
+    getSketchObject()->getSolvedSketch().setDragTimeBudget(hGrp2->GetInt("DragTimeBudget",12) / 1000.0);
 
 
     // intercept del key press from main app
@@ -0,0 +1,12 @@
+/*
+for:
+src/Mod/Import/App/dxf.cpp
+src/App/Application.cpp
+*/
+#ifndef FCVERSIONS_H
+#define FCVERSION_H
+
+#define FCVersionName  "freecad-path.0.2021"
+
+#endif //FCVERSION_H
+